@@ -34,8 +34,6 @@ void APP_LOG_HEX(const char *msg, const uint8_t *buf, size_t buf_len) {
 
 // defines for ndn standalone library
 ndn_direct_face_t *m_face;
-uint16_t m_face_id_direct = 2;
-uint16_t m_face_id_ble = 3;
 
 // Callback for when sign on has completed.
 void m_on_sign_on_completed_callback(int result_code) {
@@ -85,11 +83,11 @@ void ndn_lite_init() {
   ndn_forwarder_init();
 
   // Create a direct face, which we will use to send the interest for our certificate after sign on.
-  m_face = ndn_direct_face_construct(m_face_id_direct);
+  m_face = ndn_direct_face_construct();
 }
 
 #define NDN_CONSTRUCT_NRF_BLE_FACE(_face) {			\
-	_face = ndn_nrf_ble_face_construct(m_face_id_ble);	\
+	_face = ndn_nrf_ble_face_construct();	\
 	_face->intf.state = NDN_FACE_STATE_UP;			\
     }
 
@@ -113,7 +111,7 @@ void ndn_lite_init() {
 	ndn_interest_tlv_encode(&encoder, &interest);			\
 	ndn_direct_face_express_interest(&interest.name,		\
 					 interest_block, encoder.offset, \
-					 _dcb, _tcb);			\
+					 _dcb, _tcb, NULL);		\
 	ndn_face_send(&_face->intf, &interest.name,			\
 		      interest_block, encoder.offset);			\
 	nrf_delay_ms(100);						\
@@ -22,6 +22,8 @@
 
 #include "nrf_pwr_mgmt.h"
 
+#include "../ndn-lite/adaptation/ndn-nrf-clock.h"
+
 #include "nrf_log.h"
 #include "nrf_log_ctrl.h"
 #include "nrf_log_default_backends.h"
@@ -160,8 +162,9 @@ static void nrf_board_init(void) {
   // Initialize the log.
   log_init();
 
-  // Initialize timers.
+  // Initialize timers, and read the time of the forwarder from them.
   timers_init();
+  ndn_nrf_clock_load_backend();
 
   // Initialize power management.
   power_management_init();
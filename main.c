@@ -95,6 +95,9 @@ int main(void) {
 
     // the main loop: wait for device operations
     for (;;) {
+	// process the packets received by the faces, and the timers
+	ndn_forwarder_process(ndn_clock_now());
+
 	// if button 3 is pressed send a command to light the LED on another board
 	if (nrf_gpio_pin_read(BUTTON_3) == 0)
 	    NDN_MAKE_AND_SEND_COMMAND(CMD_LED_BLINK, m_ndn_nrf_ble_face,
@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) Zhiyi Zhang
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ *
+ * See AUTHORS.md for complete list of NDN IOT PKG authors and contributors.
+ */
+
+#include "ndn-nrf-clock.h"
+#include <app_timer.h>
+
+#if !APP_TIMER_KEEPS_RTC_ACTIVE
+#error "The RTC stops with the app timers unless APP_TIMER_KEEPS_RTC_ACTIVE is 1 in sdk_config.h"
+#endif
+
+static uint32_t m_last_ticks = 0;
+static uint64_t m_total_ticks = 0;
+
+static timetick_t
+ndn_nrf_clock_now(void)
+{
+  uint32_t ticks = app_timer_cnt_get();
+  m_total_ticks += app_timer_cnt_diff_compute(ticks, m_last_ticks);
+  m_last_ticks = ticks;
+  return m_total_ticks * 1000 / APP_TIMER_CLOCK_FREQ;
+}
+
+void
+ndn_nrf_clock_load_backend(void)
+{
+  m_last_ticks = app_timer_cnt_get();
+  m_total_ticks = 0;
+  ndn_clock_get_backend()->now = ndn_nrf_clock_now;
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) Zhiyi Zhang
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ *
+ * See AUTHORS.md for complete list of NDN IOT PKG authors and contributors.
+ */
+
+/************************************************************
+ **  This adaptation functions with
+ **  the app_timer library of the nRF5 SDK, driven by the RTC
+ **
+ **  If you are not using the nRF5 SDK, please
+ **  do not include this header with its source file into your
+ **  project.
+ *************************************************************/
+
+#ifndef NDN_ADAPTATION_NDN_NRF_CLOCK_H
+#define NDN_ADAPTATION_NDN_NRF_CLOCK_H
+
+#include "../util/clock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Load the clock backend reading the RTC through app_timer, so that ndn_clock_now()
+ * returns the milliseconds since this call.
+ * Call it after app_timer_init().
+ * The RTC must keep counting while no app timer runs, so APP_TIMER_KEEPS_RTC_ACTIVE must
+ * be set to 1 in sdk_config.h. Otherwise the clock stops whenever the app timers do.
+ * The 24-bit RTC counter wraps around every 2^24 ticks, i.e., every 512 seconds at
+ * 32768 Hz. The wraps are only accounted for when the clock is read, so ndn_clock_now()
+ * must be called at least once per wrap period, e.g., by a main loop calling
+ * ndn_forwarder_process(). A loop sleeping until the next deadline must wake up within
+ * 512 seconds even if the deadline is later, or the time of the missed wraps is lost.
+ */
+void
+ndn_nrf_clock_load_backend(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NDN_ADAPTATION_NDN_NRF_CLOCK_H
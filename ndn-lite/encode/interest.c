@@ -7,11 +7,29 @@
  */
 
 #include "interest.h"
+#include "../security/ndn-lite-rng.h"
 
 /************************************************************/
 /*  Definition of helper functions                          */
 /************************************************************/
 
+// get a random nonce for an interest without one
+static uint32_t
+ndn_interest_random_nonce(void)
+{
+  uint32_t nonce = 0;
+  ndn_rng_backend_t* backend = ndn_rng_get_backend();
+  if (backend->rng == NULL || backend->rng((uint8_t*)&nonce, sizeof(nonce)) == 0) {
+    // no RNG available: xorshift is enough to tell interests apart
+    static uint32_t state = 2463534242u;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    nonce = state;
+  }
+  return nonce;
+}
+
 // get the length of tlv's v of the interest
 static uint32_t
 ndn_interest_probe_block_value_size(const ndn_interest_t* interest)
@@ -89,6 +107,11 @@ ndn_interest_from_block(ndn_interest_t* interest, const uint8_t* block_value, ui
       decoder_get_length(&decoder, &length);
       decoder_get_byte_value(&decoder, &interest->hop_limit);
     }
+    else if (type == TLV_ForwardingHint) {
+      // only used by the forwarder
+      decoder_get_length(&decoder, &length);
+      decoder_move_forward(&decoder, length);
+    }
     else if (type == TLV_Parameters) {
       interest->enable_Parameters = 1;
       decoder_get_length(&decoder, &interest->parameters.size);
@@ -142,7 +165,8 @@ ndn_interest_tlv_encode(ndn_encoder_t* encoder, const ndn_interest_t* interest)
   // nonce
   encoder_append_type(encoder, TLV_Nonce);
   encoder_append_length(encoder, 4);
-  encoder_append_uint32_value(encoder, interest->nonce);
+  encoder_append_uint32_value(encoder, interest->nonce != 0 ? interest->nonce
+                                                           : ndn_interest_random_nonce());
   // lifetime
   encoder_append_type(encoder, TLV_InterestLifetime);
   encoder_append_length(encoder, encoder_probe_uint_length(interest->lifetime));
@@ -35,6 +35,7 @@ typedef struct ndn_interest {
   ndn_name_t name;
   /**
    * The nonce of the Interest.
+   * 0 lets ndn_interest_tlv_encode() pick a random nonce for each encoding.
    */
   uint32_t nonce;
   /**
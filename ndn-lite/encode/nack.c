@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include "nack.h"
+
+int
+ndn_nack_tlv_encode(ndn_encoder_t* encoder, uint8_t reason,
+                    const uint8_t* interest, uint32_t interest_size)
+{
+  uint32_t required_size = ndn_nack_probe_block_size(reason, interest_size);
+  if (required_size > encoder->output_max_size - encoder->offset)
+    return NDN_OVERSIZE;
+
+  uint32_t reason_size = encoder_probe_uint_length(reason);
+  uint32_t nack_value_size = encoder_probe_block_size(TLV_LpNackReason, reason_size);
+  uint32_t value_size = encoder_probe_block_size(TLV_LpNack, nack_value_size)
+                        + encoder_probe_block_size(TLV_LpFragment, interest_size);
+  encoder_append_type(encoder, TLV_LpPacket);
+  encoder_append_length(encoder, value_size);
+  // nack
+  encoder_append_type(encoder, TLV_LpNack);
+  encoder_append_length(encoder, nack_value_size);
+  encoder_append_type(encoder, TLV_LpNackReason);
+  encoder_append_length(encoder, reason_size);
+  encoder_append_uint_value(encoder, reason);
+  // fragment
+  encoder_append_type(encoder, TLV_LpFragment);
+  encoder_append_length(encoder, interest_size);
+  return encoder_append_raw_buffer_value(encoder, interest, interest_size);
+}
+
+int
+ndn_nack_tlv_decode(const uint8_t* packet, uint32_t size, uint8_t* reason,
+                    const uint8_t** interest, uint32_t* interest_size)
+{
+  ndn_decoder_t decoder;
+  uint32_t type = 0;
+  uint32_t length = 0;
+  bool is_nack = false;
+  int ret = 0;
+
+  decoder_init(&decoder, packet, size);
+  decoder_get_type(&decoder, &type);
+  if (type != TLV_LpPacket) {
+    return NDN_WRONG_TLV_TYPE;
+  }
+  ret = decoder_get_length(&decoder, &length);
+  if (ret != 0) return ret;
+
+  *reason = NDN_NACK_REASON_NONE;
+  *interest = NULL;
+  *interest_size = 0;
+  while (decoder.offset < size) {
+    ret = decoder_get_type(&decoder, &type);
+    if (ret != 0) return ret;
+    ret = decoder_get_length(&decoder, &length);
+    if (ret != 0) return ret;
+    if (type == TLV_LpNack) {
+      is_nack = true;
+      uint32_t nack_end = decoder.offset + length;
+      while (decoder.offset < nack_end) {
+        ret = decoder_get_type(&decoder, &type);
+        if (ret != 0) return ret;
+        ret = decoder_get_length(&decoder, &length);
+        if (ret != 0) return ret;
+        if (type == TLV_LpNackReason) {
+          uint64_t value = 0;
+          ret = decoder_get_uint_value(&decoder, length, &value);
+          if (ret != 0) return ret;
+          if (value == NDN_NACK_REASON_CONGESTION || value == NDN_NACK_REASON_DUPLICATE
+              || value == NDN_NACK_REASON_NO_ROUTE) {
+            *reason = (uint8_t)value;
+          }
+        }
+        else {
+          ret = decoder_move_forward(&decoder, length);
+          if (ret != 0) return ret;
+        }
+      }
+    }
+    else if (type == TLV_LpFragment) {
+      if (decoder.offset + length > size) {
+        return NDN_WRONG_TLV_LENGTH;
+      }
+      *interest = packet + decoder.offset;
+      *interest_size = length;
+      ret = decoder_move_forward(&decoder, length);
+      if (ret != 0) return ret;
+    }
+    else {
+      // other link protocol fields are not used
+      ret = decoder_move_forward(&decoder, length);
+      if (ret != 0) return ret;
+    }
+  }
+  if (!is_nack || *interest == NULL) {
+    return NDN_WRONG_TLV_TYPE;
+  }
+  return 0;
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef NDN_ENCODING_NACK_H
+#define NDN_ENCODING_NACK_H
+
+#include "encoder.h"
+#include "decoder.h"
+#include "tlv.h"
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The reasons of a network Nack, defined by NDNLPv2.
+ */
+enum {
+  NDN_NACK_REASON_NONE = 0,
+  NDN_NACK_REASON_CONGESTION = 50,
+  NDN_NACK_REASON_DUPLICATE = 100,
+  NDN_NACK_REASON_NO_ROUTE = 150,
+};
+
+/**
+ * Probe the size of a Nack packet.
+ * @param reason. Input. The Nack reason.
+ * @param interest_size. Input. The size of the wire format Interest carried by the Nack.
+ * @return the length of the Nack packet.
+ */
+static inline uint32_t
+ndn_nack_probe_block_size(uint8_t reason, uint32_t interest_size)
+{
+  uint32_t nack_value_size = encoder_probe_block_size(TLV_LpNackReason,
+                                                      encoder_probe_uint_length(reason));
+  uint32_t value_size = encoder_probe_block_size(TLV_LpNack, nack_value_size);
+  value_size += encoder_probe_block_size(TLV_LpFragment, interest_size);
+  return encoder_probe_block_size(TLV_LpPacket, value_size);
+}
+
+/**
+ * Encode a Nack into an NDNLPv2 LpPacket carrying the Nacked Interest.
+ * @param encoder. Output. The encoder who keeps the encoding result and the state.
+ * @param reason. Input. The Nack reason.
+ * @param interest. Input. The wire format Interest being Nacked.
+ * @param interest_size. Input. The size of the wire format Interest.
+ * @return 0 if there is no error.
+ */
+int
+ndn_nack_tlv_encode(ndn_encoder_t* encoder, uint8_t reason,
+                    const uint8_t* interest, uint32_t interest_size);
+
+/**
+ * Decode a Nack from an NDNLPv2 LpPacket.
+ * This function does not copy the Interest, but points into @p packet.
+ * @param packet. Input. The wire format LpPacket.
+ * @param size. Input. The size of the wire format LpPacket.
+ * @param reason. Output. The Nack reason. NDN_NACK_REASON_NONE if it is absent or unknown.
+ * @param interest. Output. The wire format Interest being Nacked.
+ * @param interest_size. Output. The size of the wire format Interest.
+ * @return 0 if there is no error. NDN_WRONG_TLV_TYPE if the LpPacket is not a Nack.
+ */
+int
+ndn_nack_tlv_decode(const uint8_t* packet, uint32_t size, uint8_t* reason,
+                    const uint8_t** interest, uint32_t* interest_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NDN_ENCODING_NACK_H
@@ -16,7 +16,8 @@ name_component_tlv_decode(ndn_decoder_t* decoder, name_component_t* component)
   if (!(component->type == TLV_GenericNameComponent
         || component->type == TLV_ImplicitSha256DigestComponent
         || component->type == TLV_ParametersSha256DigestComponent
-        || component->type == TLV_SignedInterestSha256DigestComponent)) {
+        || component->type == TLV_SignedInterestSha256DigestComponent
+        || component->type == TLV_SegmentNameComponent)) {
     return NDN_WRONG_TLV_TYPE;
   }
   decoder_get_length(decoder, &probe);
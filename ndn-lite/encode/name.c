@@ -8,6 +8,34 @@
 
 #include "name.h"
 
+#define NAME_HASH_FNV_OFFSET 2166136261u
+#define NAME_HASH_FNV_PRIME 16777619u
+
+static inline uint32_t
+name_hash_byte(uint32_t hash, uint8_t byte)
+{
+  return (hash ^ byte) * NAME_HASH_FNV_PRIME;
+}
+
+// hash a TLV Type or Length as it appears on the wire
+static inline uint32_t
+name_hash_var(uint32_t hash, uint32_t var)
+{
+  if (var < 253) {
+    return name_hash_byte(hash, (uint8_t)var);
+  }
+  else if (var <= 0xFFFF) {
+    hash = name_hash_byte(hash, 253);
+    hash = name_hash_byte(hash, (var >> 8) & 0xFF);
+    return name_hash_byte(hash, var & 0xFF);
+  }
+  hash = name_hash_byte(hash, 254);
+  for (int i = 3; i >= 0; i--) {
+    hash = name_hash_byte(hash, (var >> (8 * i)) & 0xFF);
+  }
+  return hash;
+}
+
 int
 ndn_name_init(ndn_name_t *name, const name_component_t* components, uint32_t size)
 {
@@ -150,3 +178,192 @@ ndn_name_is_prefix_of(const ndn_name_t* lhs, const ndn_name_t* rhs)
     return 0;
   }
 }
+
+static inline uint32_t
+name_hash_component(uint32_t hash, const name_component_t* component)
+{
+  hash = name_hash_var(hash, component->type);
+  hash = name_hash_var(hash, component->size);
+  for (uint32_t i = 0; i < component->size; i++) {
+    hash = name_hash_byte(hash, component->value[i]);
+  }
+  return hash;
+}
+
+uint32_t
+ndn_name_hash(const ndn_name_t* name)
+{
+  uint32_t hash = NAME_HASH_FNV_OFFSET;
+  for (uint32_t i = 0; i < name->components_size; i++) {
+    hash = name_hash_component(hash, &name->components[i]);
+  }
+  return hash;
+}
+
+void
+ndn_name_prefix_hashes(const ndn_name_t* name, uint32_t* hashes)
+{
+  hashes[0] = NAME_HASH_FNV_OFFSET;
+  for (uint32_t i = 0; i < name->components_size; i++) {
+    hashes[i + 1] = name_hash_component(hashes[i], &name->components[i]);
+  }
+}
+
+/************************************************************/
+/*  Definition of Name views                                */
+/************************************************************/
+
+// Get the type, value and size of the i-th component of a view
+static inline void
+name_view_component(const ndn_name_view_t* view, uint8_t i,
+                    uint32_t* type, const uint8_t** value, uint32_t* size)
+{
+  ndn_decoder_t decoder;
+  decoder_init(&decoder, view->value + view->offsets[i], view->offsets[i + 1] - view->offsets[i]);
+  decoder_get_type(&decoder, type);
+  decoder_get_length(&decoder, size);
+  *value = decoder.input_value + decoder.offset;
+}
+
+// Compare the first size components of a view and a name
+static int
+name_view_match(const ndn_name_view_t* view, const ndn_name_t* name, uint8_t size)
+{
+  uint32_t type = 0;
+  uint32_t length = 0;
+  const uint8_t* value = NULL;
+  for (uint8_t i = 0; i < size; i++) {
+    name_view_component(view, i, &type, &value, &length);
+    if (type != name->components[i].type || length != name->components[i].size
+        || memcmp(value, name->components[i].value, length) != 0) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+int
+ndn_name_view_tlv_decode(ndn_decoder_t* decoder, ndn_name_view_t* view)
+{
+  uint32_t type = 0;
+  uint32_t length = 0;
+  int ret = decoder_get_type(decoder, &type);
+  if (ret != 0) return ret;
+  if (type != TLV_Name) {
+    return NDN_WRONG_TLV_TYPE;
+  }
+  ret = decoder_get_length(decoder, &length);
+  if (ret != 0) return ret;
+  if (decoder->offset + length > decoder->input_size || length > UINT16_MAX) {
+    return NDN_WRONG_TLV_LENGTH;
+  }
+
+  uint32_t start_offset = decoder->offset;
+  uint32_t end_offset = start_offset + length;
+  uint8_t counter = 0;
+  view->value = decoder->input_value + start_offset;
+  while (decoder->offset < end_offset) {
+    if (counter >= NDN_NAME_VIEW_COMPONENTS_SIZE)
+      return NDN_OVERSIZE;
+    view->offsets[counter] = decoder->offset - start_offset;
+    ret = decoder_get_type(decoder, &type);
+    if (ret != 0) return ret;
+    ret = decoder_get_length(decoder, &length);
+    if (ret != 0) return ret;
+    ret = decoder_move_forward(decoder, length);
+    if (ret != 0) return ret;
+    ++counter;
+  }
+  if (decoder->offset != end_offset) {
+    return NDN_WRONG_TLV_LENGTH;
+  }
+  view->offsets[counter] = end_offset - start_offset;
+  view->components_size = counter;
+  return 0;
+}
+
+void
+ndn_name_view_get_prefix(const ndn_name_view_t* view, uint8_t size, ndn_name_view_t* prefix)
+{
+  prefix->value = view->value;
+  memcpy(prefix->offsets, view->offsets, (size + 1) * sizeof(uint16_t));
+  prefix->components_size = size;
+}
+
+int
+ndn_name_view_compare_name(const ndn_name_view_t* view, const ndn_name_t* name)
+{
+  if (view->components_size != name->components_size) return -1;
+  return name_view_match(view, name, view->components_size);
+}
+
+int
+ndn_name_view_is_prefix_of_name(const ndn_name_view_t* view, const ndn_name_t* name)
+{
+  if (view->components_size > name->components_size) return 1;
+  return name_view_match(view, name, view->components_size) == 0 ? 0 : 1;
+}
+
+int
+ndn_name_is_prefix_of_view(const ndn_name_t* name, const ndn_name_view_t* view)
+{
+  if (name->components_size > view->components_size) return 1;
+  return name_view_match(view, name, name->components_size) == 0 ? 0 : 1;
+}
+
+int
+ndn_name_from_view(ndn_name_t* name, const ndn_name_view_t* view)
+{
+  uint32_t type = 0;
+  uint32_t length = 0;
+  const uint8_t* value = NULL;
+  if (view->components_size > NDN_NAME_COMPONENTS_SIZE) {
+    return NDN_OVERSIZE;
+  }
+  for (uint8_t i = 0; i < view->components_size; i++) {
+    name_view_component(view, i, &type, &value, &length);
+    if (length > NDN_NAME_COMPONENT_BUFFER_SIZE) {
+      return NDN_OVERSIZE;
+    }
+    name->components[i].type = type;
+    name->components[i].size = length;
+    memcpy(name->components[i].value, value, length);
+  }
+  name->components_size = view->components_size;
+  return 0;
+}
+
+// Hash the i-th component of a view in the same way as name_hash_component
+static inline uint32_t
+name_view_hash_component(uint32_t hash, const ndn_name_view_t* view, uint8_t i)
+{
+  uint32_t type = 0;
+  uint32_t length = 0;
+  const uint8_t* value = NULL;
+  name_view_component(view, i, &type, &value, &length);
+  hash = name_hash_var(hash, type);
+  hash = name_hash_var(hash, length);
+  for (uint32_t j = 0; j < length; j++) {
+    hash = name_hash_byte(hash, value[j]);
+  }
+  return hash;
+}
+
+uint32_t
+ndn_name_view_hash(const ndn_name_view_t* view)
+{
+  uint32_t hash = NAME_HASH_FNV_OFFSET;
+  for (uint8_t i = 0; i < view->components_size; i++) {
+    hash = name_view_hash_component(hash, view, i);
+  }
+  return hash;
+}
+
+void
+ndn_name_view_prefix_hashes(const ndn_name_view_t* view, uint32_t* hashes)
+{
+  hashes[0] = NAME_HASH_FNV_OFFSET;
+  for (uint8_t i = 0; i < view->components_size; i++) {
+    hashes[i + 1] = name_view_hash_component(hashes[i], view, i);
+  }
+}
@@ -124,6 +124,122 @@ ndn_name_compare(const ndn_name_t* lhs, const ndn_name_t* rhs);
 int
 ndn_name_is_prefix_of(const ndn_name_t* lhs, const ndn_name_t* rhs);
 
+/**
+ * Hash a Name over its wire format (the TLV blocks of all components, without
+ * the outer Name T and L), using 32-bit FNV-1a.
+ * Two Names for which ndn_name_compare() returns 0 always have the same hash.
+ * @param name. Input. The Name to be hashed.
+ * @return the hash value.
+ */
+uint32_t
+ndn_name_hash(const ndn_name_t* name);
+
+/**
+ * Hash all prefixes of a Name in one pass.
+ * @p hashes[i] is the hash of the first i components, so that
+ * @p hashes[name->components_size] equals ndn_name_hash(@p name).
+ * @param name. Input. The Name to be hashed.
+ * @param hashes. Output. An array of at least (name->components_size + 1) elements.
+ */
+void
+ndn_name_prefix_hashes(const ndn_name_t* name, uint32_t* hashes);
+
+/**
+ * The structure to represent a Name view.
+ * A Name view refers to the components of a wire format Name without copying them,
+ * so it is cheap to get from a received packet. It is only valid as long as the
+ * wire format buffer is.
+ * Unlike ndn_name_t, the components of a view are not limited by
+ * NDN_NAME_COMPONENT_BUFFER_SIZE, and a view can have up to NDN_NAME_VIEW_COMPONENTS_SIZE
+ * components.
+ */
+typedef struct ndn_name_view {
+  /**
+   * The wire format components, i.e., the value of the Name TLV block.
+   */
+  const uint8_t* value;
+  /**
+   * The offset of each component TLV in @p value.
+   * offsets[components_size] is the size of @p value.
+   */
+  uint16_t offsets[NDN_NAME_VIEW_COMPONENTS_SIZE + 1];
+  /**
+   * The number of name components
+   */
+  uint8_t components_size;
+} ndn_name_view_t;
+
+/**
+ * Get a Name view from wire format (TLV block). This function does not copy the components.
+ * @param decoder. Input. The decoder who keeps the decoding result and the state.
+ * @param view. Output. The Name view referring to the TLV block.
+ * @return 0 if there is no error.
+ */
+int
+ndn_name_view_tlv_decode(ndn_decoder_t* decoder, ndn_name_view_t* view);
+
+/**
+ * Get the view of a prefix of a Name view.
+ * @param view. Input. The Name view.
+ * @param size. Input. The number of components of the prefix, no more than view->components_size.
+ * @param prefix. Output. The view of the prefix.
+ */
+void
+ndn_name_view_get_prefix(const ndn_name_view_t* view, uint8_t size, ndn_name_view_t* prefix);
+
+/**
+ * Compare a Name view with a Name.
+ * @param view. Input. The Name view.
+ * @param name. Input. The Name.
+ * @return 0 if @p view == @p name.
+ */
+int
+ndn_name_view_compare_name(const ndn_name_view_t* view, const ndn_name_t* name);
+
+/**
+ * Check whether a Name view is a prefix of a Name.
+ * @param view. Input. The Name view.
+ * @param name. Input. The Name.
+ * @return 0 if @p view is the prefix of @p name.
+ */
+int
+ndn_name_view_is_prefix_of_name(const ndn_name_view_t* view, const ndn_name_t* name);
+
+/**
+ * Check whether a Name is a prefix of a Name view.
+ * @param name. Input. The Name.
+ * @param view. Input. The Name view.
+ * @return 0 if @p name is the prefix of @p view.
+ */
+int
+ndn_name_is_prefix_of_view(const ndn_name_t* name, const ndn_name_view_t* view);
+
+/**
+ * Copy the components referred by a Name view into a Name.
+ * @param name. Output. The Name.
+ * @param view. Input. The Name view.
+ * @return 0 if there is no error. NDN_OVERSIZE if the components or one of them
+ *         do not fit in a Name.
+ */
+int
+ndn_name_from_view(ndn_name_t* name, const ndn_name_view_t* view);
+
+/**
+ * Hash a Name view. The result equals ndn_name_hash() of the Name it refers to.
+ * @param view. Input. The Name view to be hashed.
+ * @return the hash value.
+ */
+uint32_t
+ndn_name_view_hash(const ndn_name_view_t* view);
+
+/**
+ * Hash all prefixes of a Name view in one pass, in the same way as ndn_name_prefix_hashes().
+ * @param view. Input. The Name view to be hashed.
+ * @param hashes. Output. An array of at least (view->components_size + 1) elements.
+ */
+void
+ndn_name_view_prefix_hashes(const ndn_name_view_t* view, uint32_t* hashes);
+
 #ifdef __cplusplus
 }
 #endif
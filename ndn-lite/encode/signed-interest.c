@@ -10,6 +10,7 @@
 #include "../security/ndn-lite-hmac.h"
 #include "../security/ndn-lite-sha.h"
 #include "../security/ndn-lite-ecc.h"
+#include "../forwarder/memory-pool.h"
 
 /************************************************************/
 /*  Helper functions for Signed Interest APIs               */
@@ -53,9 +54,10 @@ _prepare_signature_info(ndn_interest_t* interest, uint8_t signature_type,
 /*  Definition of signed interest APIs                      */
 /************************************************************/
 
-int
-ndn_signed_interest_ecdsa_sign(ndn_interest_t* interest,
-                               const ndn_name_t* identity, const ndn_ecc_prv_t* prv_key)
+static int
+_signed_interest_ecdsa_sign(ndn_interest_t* interest,
+                            const ndn_name_t* identity, const ndn_ecc_prv_t* prv_key,
+                            uint8_t* be_signed)
 {
   if (interest->name.components_size + 1 > NDN_NAME_COMPONENTS_SIZE)
     return NDN_OVERSIZE;
@@ -66,7 +68,6 @@ ndn_signed_interest_ecdsa_sign(ndn_interest_t* interest,
 
   // update signature value and append the ending name component
   // prepare temp buffer to calculate signature value and the ending name component
-  uint8_t be_signed[NDN_SIGNED_INTEREST_BE_SIGNED_MAX_SIZE] = {0};
   ndn_encoder_t temp_encoder;
   encoder_init(&temp_encoder, be_signed, NDN_SIGNED_INTEREST_BE_SIGNED_MAX_SIZE);
   // the signing input starts at Name's Value (V)
@@ -114,8 +115,21 @@ ndn_signed_interest_ecdsa_sign(ndn_interest_t* interest,
 }
 
 int
-ndn_signed_interest_hmac_sign(ndn_interest_t* interest,
-                              const ndn_name_t* identity, const ndn_hmac_key_t* hmac_key)
+ndn_signed_interest_ecdsa_sign(ndn_interest_t* interest,
+                               const ndn_name_t* identity, const ndn_ecc_prv_t* prv_key)
+{
+  uint8_t* be_signed = ndn_memory_pool_alloc(NDN_SIGNED_INTEREST_BE_SIGNED_MAX_SIZE);
+  if (be_signed == NULL)
+    return NDN_NO_MEM;
+  int result = _signed_interest_ecdsa_sign(interest, identity, prv_key, be_signed);
+  ndn_memory_pool_free(be_signed);
+  return result;
+}
+
+static int
+_signed_interest_hmac_sign(ndn_interest_t* interest,
+                           const ndn_name_t* identity, const ndn_hmac_key_t* hmac_key,
+                           uint8_t* be_signed)
 {
   if (interest->name.components_size + 1 > NDN_NAME_COMPONENTS_SIZE)
     return NDN_OVERSIZE;
@@ -126,7 +140,6 @@ ndn_signed_interest_hmac_sign(ndn_interest_t* interest,
 
   // update signature value and append the ending name component
   // prepare temp buffer to calculate signature value and the ending name component
-  uint8_t be_signed[NDN_SIGNED_INTEREST_BE_SIGNED_MAX_SIZE] = {0};
   ndn_encoder_t temp_encoder;
   encoder_init(&temp_encoder, be_signed, NDN_SIGNED_INTEREST_BE_SIGNED_MAX_SIZE);
   // the signing input starts at Name's Value (V)
@@ -173,7 +186,20 @@ ndn_signed_interest_hmac_sign(ndn_interest_t* interest,
 }
 
 int
-ndn_signed_interest_digest_sign(ndn_interest_t* interest)
+ndn_signed_interest_hmac_sign(ndn_interest_t* interest,
+                              const ndn_name_t* identity, const ndn_hmac_key_t* hmac_key)
+{
+  uint8_t* be_signed = ndn_memory_pool_alloc(NDN_SIGNED_INTEREST_BE_SIGNED_MAX_SIZE);
+  if (be_signed == NULL)
+    return NDN_NO_MEM;
+  int result = _signed_interest_hmac_sign(interest, identity, hmac_key, be_signed);
+  ndn_memory_pool_free(be_signed);
+  return result;
+}
+
+static int
+_signed_interest_digest_sign(ndn_interest_t* interest,
+                             uint8_t* be_signed)
 {
   if (interest->name.components_size + 1 > NDN_NAME_COMPONENTS_SIZE)
     return NDN_OVERSIZE;
@@ -186,7 +212,6 @@ ndn_signed_interest_digest_sign(ndn_interest_t* interest)
   // set timestamp
   ndn_signature_set_timestamp(&interest->signature, 0);
 
-  uint8_t be_signed[NDN_SIGNED_INTEREST_BE_SIGNED_MAX_SIZE] = {0};
   ndn_encoder_t temp_encoder;
   encoder_init(&temp_encoder, be_signed, NDN_SIGNED_INTEREST_BE_SIGNED_MAX_SIZE);
   // the signing input starts at Name's Value (V)
@@ -233,9 +258,20 @@ ndn_signed_interest_digest_sign(ndn_interest_t* interest)
 }
 
 int
-ndn_signed_interest_ecdsa_verify(const ndn_interest_t* interest, const ndn_ecc_pub_t* pub_key)
+ndn_signed_interest_digest_sign(ndn_interest_t* interest)
+{
+  uint8_t* be_signed = ndn_memory_pool_alloc(NDN_SIGNED_INTEREST_BE_SIGNED_MAX_SIZE);
+  if (be_signed == NULL)
+    return NDN_NO_MEM;
+  int result = _signed_interest_digest_sign(interest, be_signed);
+  ndn_memory_pool_free(be_signed);
+  return result;
+}
+
+static int
+_signed_interest_ecdsa_verify(const ndn_interest_t* interest, const ndn_ecc_pub_t* pub_key,
+                              uint8_t* be_signed)
 {
-  uint8_t be_signed[NDN_SIGNED_INTEREST_BE_SIGNED_MAX_SIZE] = {0};
   ndn_encoder_t temp_encoder;
   encoder_init(&temp_encoder, be_signed, NDN_SIGNED_INTEREST_BE_SIGNED_MAX_SIZE);
 
@@ -271,9 +307,20 @@ ndn_signed_interest_ecdsa_verify(const ndn_interest_t* interest, const ndn_ecc_p
 }
 
 int
-ndn_signed_interest_hmac_verify(const ndn_interest_t* interest, const ndn_hmac_key_t* hmac_key)
+ndn_signed_interest_ecdsa_verify(const ndn_interest_t* interest, const ndn_ecc_pub_t* pub_key)
+{
+  uint8_t* be_signed = ndn_memory_pool_alloc(NDN_SIGNED_INTEREST_BE_SIGNED_MAX_SIZE);
+  if (be_signed == NULL)
+    return NDN_NO_MEM;
+  int result = _signed_interest_ecdsa_verify(interest, pub_key, be_signed);
+  ndn_memory_pool_free(be_signed);
+  return result;
+}
+
+static int
+_signed_interest_hmac_verify(const ndn_interest_t* interest, const ndn_hmac_key_t* hmac_key,
+                             uint8_t* be_signed)
 {
-  uint8_t be_signed[NDN_SIGNED_INTEREST_BE_SIGNED_MAX_SIZE] = {0};
   ndn_encoder_t temp_encoder;
   encoder_init(&temp_encoder, be_signed, NDN_SIGNED_INTEREST_BE_SIGNED_MAX_SIZE);
 
@@ -308,9 +355,20 @@ ndn_signed_interest_hmac_verify(const ndn_interest_t* interest, const ndn_hmac_k
 }
 
 int
-ndn_signed_interest_digest_verify(const ndn_interest_t* interest)
+ndn_signed_interest_hmac_verify(const ndn_interest_t* interest, const ndn_hmac_key_t* hmac_key)
+{
+  uint8_t* be_signed = ndn_memory_pool_alloc(NDN_SIGNED_INTEREST_BE_SIGNED_MAX_SIZE);
+  if (be_signed == NULL)
+    return NDN_NO_MEM;
+  int result = _signed_interest_hmac_verify(interest, hmac_key, be_signed);
+  ndn_memory_pool_free(be_signed);
+  return result;
+}
+
+static int
+_signed_interest_digest_verify(const ndn_interest_t* interest,
+                               uint8_t* be_signed)
 {
-  uint8_t be_signed[NDN_SIGNED_INTEREST_BE_SIGNED_MAX_SIZE] = {0};
   ndn_encoder_t temp_encoder;
   encoder_init(&temp_encoder, be_signed, NDN_SIGNED_INTEREST_BE_SIGNED_MAX_SIZE);
 
@@ -344,3 +402,14 @@ ndn_signed_interest_digest_verify(const ndn_interest_t* interest)
     return NDN_SEC_SIGNED_INTEREST_INVALID_DIGEST;
   return NDN_SUCCESS;
 }
+
+int
+ndn_signed_interest_digest_verify(const ndn_interest_t* interest)
+{
+  uint8_t* be_signed = ndn_memory_pool_alloc(NDN_SIGNED_INTEREST_BE_SIGNED_MAX_SIZE);
+  if (be_signed == NULL)
+    return NDN_NO_MEM;
+  int result = _signed_interest_digest_verify(interest, be_signed);
+  ndn_memory_pool_free(be_signed);
+  return result;
+}
@@ -25,6 +25,7 @@ enum {
   TLV_ImplicitSha256DigestComponent = 1,
   TLV_ParametersSha256DigestComponent = 2,
   TLV_SignedInterestSha256DigestComponent = 3,
+  TLV_SegmentNameComponent = 50,
 
   // Interest packet
   TLV_CanBePrefix = 33,
@@ -63,6 +64,52 @@ enum {
   // Command Interest
   TLV_SignedInterestParameters = 60,
   TLV_SignedInterestTimestamp = 61,
+
+  // NDNLPv2
+  TLV_LpPacket = 100,
+  TLV_LpFragment = 80,
+  TLV_LpNack = 800,
+  TLV_LpNackReason = 801,
+};
+
+// Forwarder Management, following the status datasets of NFD
+enum {
+  TLV_MGMT_FaceStatus = 128,
+  TLV_MGMT_FaceId = 105,
+  TLV_MGMT_ControlResponse = 101,
+  TLV_MGMT_StatusCode = 102,
+  TLV_MGMT_StatusText = 103,
+  TLV_MGMT_ControlParameters = 104,
+  TLV_MGMT_Cost = 106,
+  TLV_MGMT_ExpirationPeriod = 109,
+  TLV_MGMT_Origin = 111,
+  TLV_MGMT_CurrentTimestamp = 130,
+  TLV_MGMT_NFibEntries = 132,
+  TLV_MGMT_NPitEntries = 133,
+  TLV_MGMT_NCsEntries = 135,
+  TLV_MGMT_NInInterests = 144,
+  TLV_MGMT_NInData = 145,
+  TLV_MGMT_NOutInterests = 146,
+  TLV_MGMT_NOutData = 147,
+  TLV_MGMT_NInNacks = 151,
+  TLV_MGMT_NOutNacks = 152,
+  TLV_MGMT_NSatisfiedInterests = 153,
+  TLV_MGMT_NUnsatisfiedInterests = 154,
+
+  // NDN-Lite extensions of the forwarder status
+  TLV_MGMT_NPitHits = 160,
+  TLV_MGMT_NPitMisses = 161,
+  TLV_MGMT_NPitFullDrops = 162,
+  TLV_MGMT_NFibMisses = 163,
+  TLV_MGMT_NDuplicateNonces = 164,
+  TLV_MGMT_NUnsolicitedData = 165,
+  TLV_MGMT_NCsHits = 166,
+  TLV_MGMT_NCsMisses = 167,
+  TLV_MGMT_NRxQueueDrops = 168,
+  TLV_MGMT_NPitEvictions = 169,
+  TLV_MGMT_NPitQuotaDrops = 170,
+  TLV_MGMT_NForwardingHintLookups = 171,
+  TLV_MGMT_NHopLimitDrops = 172,
 };
 
 // App Support Specific
@@ -8,13 +8,33 @@
 
 #include "direct-face.h"
 #include "../forwarder/forwarder.h"
-
-static ndn_direct_face_t direct_face;
+#include "../encode/nack.h"
 
 /************************************************************/
 /*  Inherit Face Interfaces                                 */
 /************************************************************/
 
+static void
+ndn_direct_face_release_entry(ndn_direct_face_t* self, ndn_face_cb_entry_t* entry)
+{
+  name_arena_release(&self->names, entry->interest_name);
+  entry->interest_name = NDN_NAME_REF_NULL;
+}
+
+// An expressed Interest matches the exact name, and a registered prefix matches the names under it
+static bool
+ndn_direct_face_entry_match(ndn_direct_face_t* self, const ndn_face_cb_entry_t* entry,
+                            const ndn_name_view_t* name)
+{
+  if (entry->interest_name == NDN_NAME_REF_NULL) {
+    return false;
+  }
+  if (entry->is_prefix) {
+    return name_arena_is_prefix_of_view(&self->names, entry->interest_name, name) == 0;
+  }
+  return name_arena_compare_view(&self->names, entry->interest_name, name) == 0;
+}
+
 int
 ndn_direct_face_up(struct ndn_face_intf* self)
 {
@@ -25,9 +45,11 @@ ndn_direct_face_up(struct ndn_face_intf* self)
 void
 ndn_direct_face_destroy(struct ndn_face_intf* self)
 {
-  for (int i = 0; i < NDN_DIRECT_FACE_CB_ENTRY_SIZE; i++) {
-    direct_face.cb_entries[i].interest_name.components_size = NDN_FWD_INVALID_NAME_SIZE;
+  ndn_direct_face_t* direct_face = (ndn_direct_face_t*)self;
+  for (uint16_t i = 0; i < direct_face->cb_size; i++) {
+    direct_face->cb_entries[i].interest_name = NDN_NAME_REF_NULL;
   }
+  name_arena_init(&direct_face->names, direct_face->names.buffer, direct_face->names.size);
   self->state = NDN_FACE_STATE_DESTROYED;
   return;
 }
@@ -39,15 +61,63 @@ ndn_direct_face_down(struct ndn_face_intf* self)
   return 0;
 }
 
+// Get the view of the Name of a wire format Interest or Data
+static int
+ndn_direct_face_decode_name_view(const uint8_t* packet, uint32_t size, ndn_name_view_t* name)
+{
+  ndn_decoder_t decoder;
+  uint32_t probe = 0;
+  decoder_init(&decoder, packet, size);
+  int ret = decoder_get_type(&decoder, &probe);
+  if (ret != 0) return ret;
+  ret = decoder_get_length(&decoder, &probe);
+  if (ret != 0) return ret;
+  return ndn_name_view_tlv_decode(&decoder, name);
+}
+
+static int
+ndn_direct_face_on_nack(ndn_direct_face_t* self, const uint8_t* packet, uint32_t size)
+{
+  uint8_t reason = NDN_NACK_REASON_NONE;
+  const uint8_t* interest = NULL;
+  uint32_t interest_size = 0;
+  ndn_name_view_t name;
+  int ret = ndn_nack_tlv_decode(packet, size, &reason, &interest, &interest_size);
+  if (ret != 0) {
+    return ret;
+  }
+  ret = ndn_direct_face_decode_name_view(interest, interest_size, &name);
+  if (ret != 0) {
+    return ret;
+  }
+  for (uint16_t i = 0; i < self->cb_size; i++) {
+    if (self->cb_entries[i].is_prefix == 0
+        && ndn_direct_face_entry_match(self, &self->cb_entries[i], &name)) {
+      ndn_on_nack_callback on_nack = self->cb_entries[i].on_nack;
+      ndn_interest_timeout_callback on_timeout = self->cb_entries[i].on_timeout;
+      ndn_direct_face_release_entry(self, &self->cb_entries[i]);
+      if (on_nack != NULL) {
+        on_nack(interest, interest_size, reason);
+      }
+      else if (on_timeout != NULL) {
+        on_timeout(interest, interest_size);
+      }
+      return 0;
+    }
+  }
+  return NDN_FWD_NO_MATCHED_CALLBACK;
+}
+
 int
-ndn_direct_face_send(struct ndn_face_intf* self, const ndn_name_t* name,
+ndn_direct_face_send(struct ndn_face_intf* intf, const ndn_name_t* name,
                      const uint8_t* packet, uint32_t size)
 {
-  (void)self;
+  ndn_direct_face_t* self = (ndn_direct_face_t*)intf;
+  (void)name;
   ndn_decoder_t decoder;
+  ndn_name_view_t view;
   uint32_t probe = 0;
   uint8_t isInterest = 0;
-  uint8_t bypass = (name == NULL)?0:1;
 
   decoder_init(&decoder, packet, size);
   decoder_get_type(&decoder, &probe);
@@ -57,65 +127,106 @@ ndn_direct_face_send(struct ndn_face_intf* self, const ndn_name_t* name,
   else if (probe == TLV_Data) {
     // do nothing
   }
+  else if (probe == TLV_LpPacket) {
+    return ndn_direct_face_on_nack(self, packet, size);
+  }
   else {
     // There should not be fragmentation in direct face
     return 1;
   }
-  if (bypass == 0) {
-    // this function is supposed to be called by the forwarder,
-    // which has already finished name decoding
-    // bypass should be 1
+  // the name is matched in place, so the forwarder does not need to pass a decoded one
+  if (ndn_direct_face_decode_name_view(packet, size, &view) != 0) {
     return 1;
   }
 
-  for (int i = 0; i < NDN_DIRECT_FACE_CB_ENTRY_SIZE; i++) {
-    if (direct_face.cb_entries[i].is_prefix == isInterest && isInterest == 0
-        && ndn_name_compare(&direct_face.cb_entries[i].interest_name, name) == 0) {
-      direct_face.cb_entries[i].on_data(packet, size);
+  for (uint16_t i = 0; i < self->cb_size; i++) {
+    if (self->cb_entries[i].is_prefix == isInterest && isInterest == 0
+        && ndn_direct_face_entry_match(self, &self->cb_entries[i], &view)) {
+      // the Interest is satisfied, release the entry before the callback may reuse it
+      ndn_on_data_callback on_data = self->cb_entries[i].on_data;
+      ndn_direct_face_release_entry(self, &self->cb_entries[i]);
+      on_data(packet, size);
       return 0;
     }
-    if (direct_face.cb_entries[i].is_prefix == isInterest && isInterest == 1
-        && ndn_name_is_prefix_of(&direct_face.cb_entries[i].interest_name, name) == 0) {
-      direct_face.cb_entries[i].on_interest(packet, size);
+    if (self->cb_entries[i].is_prefix == isInterest && isInterest == 1
+        && ndn_direct_face_entry_match(self, &self->cb_entries[i], &view)) {
+      self->cb_entries[i].on_interest(packet, size);
       return 0;
     }
   }
   return NDN_FWD_NO_MATCHED_CALLBACK;
 }
 
-ndn_direct_face_t*
-ndn_direct_face_construct(uint16_t face_id)
+int
+ndn_direct_face_on_interest_timeout(struct ndn_face_intf* intf,
+                                    const uint8_t* interest, uint32_t interest_size)
+{
+  ndn_direct_face_t* self = (ndn_direct_face_t*)intf;
+  ndn_name_view_t name;
+  int ret = ndn_direct_face_decode_name_view(interest, interest_size, &name);
+  if (ret != 0) {
+    return ret;
+  }
+  for (uint16_t i = 0; i < self->cb_size; i++) {
+    if (self->cb_entries[i].is_prefix == 0
+        && ndn_direct_face_entry_match(self, &self->cb_entries[i], &name)) {
+      ndn_interest_timeout_callback on_timeout = self->cb_entries[i].on_timeout;
+      ndn_direct_face_release_entry(self, &self->cb_entries[i]);
+      if (on_timeout != NULL) {
+        on_timeout(interest, interest_size);
+      }
+      return 0;
+    }
+  }
+  return NDN_FWD_NO_MATCHED_CALLBACK;
+}
+
+int
+direct_face_init(ndn_direct_face_t* self, ndn_forwarder_t* forwarder)
 {
-  direct_face.intf.up = ndn_direct_face_up;
-  direct_face.intf.send = ndn_direct_face_send;
-  direct_face.intf.down = ndn_direct_face_down;
-  direct_face.intf.destroy = ndn_direct_face_destroy;
-  direct_face.intf.face_id = face_id;
-  direct_face.intf.state = NDN_FACE_STATE_DESTROYED;
-  direct_face.intf.type = NDN_FACE_TYPE_APP;
+  self->intf.up = ndn_direct_face_up;
+  self->intf.send = ndn_direct_face_send;
+  self->intf.send_pktbuf = NULL;
+  self->intf.down = ndn_direct_face_down;
+  self->intf.destroy = ndn_direct_face_destroy;
+  self->intf.forwarder = NULL;
+  self->intf.face_id = NDN_INVALID_FACE_ID;
+  self->intf.state = NDN_FACE_STATE_DESTROYED;
+  self->intf.type = NDN_FACE_TYPE_APP;
+  memset(&self->intf.counters, 0, sizeof(self->intf.counters));
 
-  // init call back entries
-  for (int i = 0; i < NDN_DIRECT_FACE_CB_ENTRY_SIZE; i++) {
-    direct_face.cb_entries[i].interest_name.components_size = NDN_FWD_INVALID_NAME_SIZE;
+  // init call back entries in the region the forwarder reserved for them
+  uint8_t* region = forwarder->direct_face_region;
+  self->cb_entries = (ndn_face_cb_entry_t*)region;
+  self->cb_size = forwarder->config.direct_face_cb_size;
+  region += NDN_POOL_ALIGN_UP(sizeof(ndn_face_cb_entry_t) * (size_t)self->cb_size);
+  for (uint16_t i = 0; i < self->cb_size; i++) {
+    self->cb_entries[i].interest_name = NDN_NAME_REF_NULL;
   }
+  name_arena_init(&self->names, region, forwarder->config.direct_face_name_arena_size);
 
-  return &direct_face;
+  return forwarder_add_face(forwarder, &self->intf);
 }
 
 int
-ndn_direct_face_express_interest(const ndn_name_t* interest_name,
-                                 uint8_t* interest, uint32_t interest_size,
-                                 ndn_on_data_callback on_data, ndn_interest_timeout_callback on_interest_timeout)
+direct_face_express_interest(ndn_direct_face_t* self, const ndn_name_t* interest_name,
+                             uint8_t* interest, uint32_t interest_size,
+                             ndn_on_data_callback on_data, ndn_interest_timeout_callback on_interest_timeout,
+                             ndn_on_nack_callback on_nack)
 {
-  for (int i = 0; i < NDN_DIRECT_FACE_CB_ENTRY_SIZE; i++) {
-    if (direct_face.cb_entries[i].interest_name.components_size == NDN_FWD_INVALID_NAME_SIZE) {
-      direct_face.cb_entries[i].interest_name = *interest_name;
-      direct_face.cb_entries[i].is_prefix = 0;
-      direct_face.cb_entries[i].on_data = on_data;
-      direct_face.cb_entries[i].on_timeout = on_interest_timeout;
-      direct_face.cb_entries[i].on_interest = NULL;
-
-      ndn_face_receive(&direct_face.intf, interest, interest_size);
+  for (uint16_t i = 0; i < self->cb_size; i++) {
+    if (self->cb_entries[i].interest_name == NDN_NAME_REF_NULL) {
+      self->cb_entries[i].interest_name = name_arena_store_name(&self->names, interest_name);
+      if (self->cb_entries[i].interest_name == NDN_NAME_REF_NULL) {
+        return NDN_FWD_APP_FACE_CB_TABLE_FULL;
+      }
+      self->cb_entries[i].is_prefix = 0;
+      self->cb_entries[i].on_data = on_data;
+      self->cb_entries[i].on_timeout = on_interest_timeout;
+      self->cb_entries[i].on_nack = on_nack;
+      self->cb_entries[i].on_interest = NULL;
+
+      ndn_face_receive(&self->intf, interest, interest_size);
       return 0;
     }
   }
@@ -123,20 +234,59 @@ ndn_direct_face_express_interest(const ndn_name_t* interest_name,
 }
 
 int
- ndn_direct_face_register_prefix(const ndn_name_t* prefix_name,
-                                ndn_on_interest_callback on_interest)
+direct_face_register_prefix(ndn_direct_face_t* self, const ndn_name_t* prefix_name,
+                            ndn_on_interest_callback on_interest)
 {
-  for (int i = 0; i < NDN_DIRECT_FACE_CB_ENTRY_SIZE; i++) {
-    if (direct_face.cb_entries[i].interest_name.components_size == NDN_FWD_INVALID_NAME_SIZE) {
-      direct_face.cb_entries[i].interest_name = *prefix_name;
-      direct_face.cb_entries[i].is_prefix = 1;
-      direct_face.cb_entries[i].on_data = NULL;
-      direct_face.cb_entries[i].on_timeout = NULL;
-      direct_face.cb_entries[i].on_interest = on_interest;
-
-      ndn_forwarder_fib_insert(prefix_name, &direct_face.intf, NDN_FACE_DEFAULT_COST);
+  if (self->intf.forwarder == NULL) {
+    return NDN_FWD_UNKNOWN_FACE;
+  }
+  for (uint16_t i = 0; i < self->cb_size; i++) {
+    if (self->cb_entries[i].interest_name == NDN_NAME_REF_NULL) {
+      self->cb_entries[i].interest_name = name_arena_store_name(&self->names, prefix_name);
+      if (self->cb_entries[i].interest_name == NDN_NAME_REF_NULL) {
+        return NDN_FWD_APP_FACE_CB_TABLE_FULL;
+      }
+      self->cb_entries[i].is_prefix = 1;
+      self->cb_entries[i].on_data = NULL;
+      self->cb_entries[i].on_timeout = NULL;
+      self->cb_entries[i].on_nack = NULL;
+      self->cb_entries[i].on_interest = on_interest;
+
+      forwarder_fib_insert(self->intf.forwarder, prefix_name, &self->intf, NDN_FACE_DEFAULT_COST);
       return 0;
     }
   }
   return NDN_FWD_APP_FACE_CB_TABLE_FULL;
 }
+
+/************************************************************/
+/*  Definition of default direct face                       */
+/************************************************************/
+
+static ndn_direct_face_t direct_face;
+
+ndn_direct_face_t*
+ndn_direct_face_construct(void)
+{
+  if (direct_face_init(&direct_face, ndn_forwarder_get_instance()) != 0) {
+    return NULL;
+  }
+  return &direct_face;
+}
+
+int
+ndn_direct_face_express_interest(const ndn_name_t* interest_name,
+                                 uint8_t* interest, uint32_t interest_size,
+                                 ndn_on_data_callback on_data, ndn_interest_timeout_callback on_interest_timeout,
+                                 ndn_on_nack_callback on_nack)
+{
+  return direct_face_express_interest(&direct_face, interest_name, interest, interest_size,
+                                      on_data, on_interest_timeout, on_nack);
+}
+
+int
+ndn_direct_face_register_prefix(const ndn_name_t* prefix_name,
+                                ndn_on_interest_callback on_interest)
+{
+  return direct_face_register_prefix(&direct_face, prefix_name, on_interest);
+}
@@ -9,9 +9,13 @@
 #ifndef FORWARDER_DIRECT_FACE_H_
 #define FORWARDER_DIRECT_FACE_H_
 
+// the default sizes of the callback table, see ndn_forwarder_config_t
 #define NDN_DIRECT_FACE_CB_ENTRY_SIZE 5
+#define NDN_DIRECT_FACE_NAME_ARENA_SIZE (NDN_DIRECT_FACE_CB_ENTRY_SIZE * 64)
 
 #include "../forwarder/face.h"
+#include "../forwarder/name-arena.h"
+#include "../forwarder/forwarder.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -39,6 +43,11 @@ extern "C" {
  *    APIs for forwarder:
  *      * direct_face_send
  *      * direct_face_receive
+ *      * direct_face_on_interest_timeout
+ *
+ * A program can run several direct faces, one on each forwarder, with the direct_face_*
+ * functions. The ndn_direct_face_* functions drive a default direct face on the default
+ * forwarder, for firmware running a single forwarder.
  */
 
 /**
@@ -59,6 +68,16 @@ typedef int (*ndn_on_data_callback)(const uint8_t* data, uint32_t data_size);
  */
 typedef int (*ndn_interest_timeout_callback)(const uint8_t* interest, uint32_t interest_size);
 
+/**
+ * ndn_on_nack_callback is a function pointer to the on nack function.
+ * After invoking the function, the face will process the network Nack of an expressed interest.
+ * @param interest. Input. The Nacked interest TLV.
+ * @param interest_size. Input. Size of Nacked interest TLV.
+ * @param reason. Input. The Nack reason, e.g., NDN_NACK_REASON_NO_ROUTE.
+ * @return 0 if there is no error.
+ */
+typedef int (*ndn_on_nack_callback)(const uint8_t* interest, uint32_t interest_size, uint8_t reason);
+
 /**
  * ndn_on_interest_callback is a function pointer to the on interest function.
  * After invoking the function, the face will process the incoming interest packet.
@@ -73,9 +92,10 @@ typedef int (*ndn_on_interest_callback)(const uint8_t* interest, uint32_t intere
  */
 typedef struct ndn_face_cb_entry {
   /**
-   * The interest name of callback entry.
+   * The interest name of callback entry, kept in the name arena of the direct face.
+   * NDN_NAME_REF_NULL indicates an empty entry.
    */
-  ndn_name_t interest_name;
+  ndn_name_ref_t interest_name;
   /**
    * Flag to represent current callback entry is a registered prefix.
    */
@@ -88,6 +108,10 @@ typedef struct ndn_face_cb_entry {
    * on_timeout callback.
    */
   ndn_interest_timeout_callback on_timeout;
+  /**
+   * on_nack callback.
+   */
+  ndn_on_nack_callback on_nack;
   /**
    * on_interest callback.
    */
@@ -103,39 +127,99 @@ typedef struct ndn_direct_face {
    */
   ndn_face_intf_t intf;
   /**
-   * List of callback entries.
+   * List of callback entries, @p cb_size of them.
    */
-  ndn_face_cb_entry_t cb_entries[NDN_DIRECT_FACE_CB_ENTRY_SIZE];
+  ndn_face_cb_entry_t* cb_entries;
+  uint16_t cb_size;
+  /**
+   * The name arena keeping the names of callback entries.
+   */
+  ndn_name_arena_t names;
 } ndn_direct_face_t;
 
 /**
- * Construct the direct face and initialize its state.
- * @param face_id. Input. The face id to identity the direct face.
- * @return the pointer to the constructed direct face.
+ * The bytes of memory region taken by the callback table of a direct face and its
+ * name arena, each aligned to NDN_POOL_ALIGN.
  */
-ndn_direct_face_t*
-ndn_direct_face_construct(uint16_t face_id);
+#define NDN_DIRECT_FACE_REGION_SIZE(cb_size, name_arena_size) \
+  (NDN_POOL_ALIGN_UP(sizeof(ndn_face_cb_entry_t) * (size_t)(cb_size)) \
+   + NDN_POOL_ALIGN_UP((size_t)(name_arena_size)))
+
+/**
+ * Init a direct face and add it to a forwarder, which assigns its face ID, so the
+ * forwarder should be inited first.
+ * The callback table is kept in the memory region of the forwarder, sized by its
+ * ndn_forwarder_config_t, so a forwarder has one direct face.
+ * @param self. Output. The direct face to be inited.
+ * @param forwarder. Input/Output. The forwarder.
+ * @return 0 if there is no error. NDN_FWD_FACE_TABLE_FULL if the face table is full.
+ */
+int
+direct_face_init(ndn_direct_face_t* self, ndn_forwarder_t* forwarder);
+
+/**
+ * Notify the direct face that an Interest it expressed has expired in the PIT.
+ * The callback entry of the Interest is released and its on_timeout callback is invoked.
+ * This function is supposed to be invoked by the forwarder only.
+ * @param self. Input. The direct face.
+ * @param interest. Input. The wire format of the expired Interest.
+ * @param interest_size. Input. The size of the wire format Interest.
+ * @return 0 if there is no error.
+ */
+int
+ndn_direct_face_on_interest_timeout(struct ndn_face_intf* self,
+                                    const uint8_t* interest, uint32_t interest_size);
 
 /**
  * Let the direct face express an interest.
+ * @param self. Input/Output. The direct face.
  * @param prefix_name. Input. Prefix name to identify the callback entry.
  * @param interest. Input. The wire format Interest received by the direct face.
  * @param interest_size. Input. The size of the wire format Interest.
  * @param on_data. Input. on_data function pointer of the callback entry.
  * @param on_interest_timeout. Input. on_interest_timeout function pointer of the callback entry.
+ * @param on_nack. [optional] Input. on_nack function pointer of the callback entry.
+ *        If it is NULL, a Nack is reported through @p on_interest_timeout.
  * @return 0 if there is no error.
  */
 int
+direct_face_express_interest(ndn_direct_face_t* self, const ndn_name_t* prefix_name,
+                             uint8_t* interest, uint32_t interest_size,
+                             ndn_on_data_callback on_data,
+                             ndn_interest_timeout_callback on_interest_timeout,
+                             ndn_on_nack_callback on_nack);
+
+/**
+ * Let the direct face register a prefix on the FIB of its forwarder.
+ * @param self. Input/Output. The direct face.
+ * @param interest_name. Input. Prefix name to identify the callback entry.
+ * @param on_interest. Input. on_interest function pointer of the callback entry.
+ * @return 0 if there is no error. NDN_FWD_UNKNOWN_FACE if the face is not in a forwarder.
+ */
+int
+direct_face_register_prefix(ndn_direct_face_t* self, const ndn_name_t* interest_name,
+                            ndn_on_interest_callback on_interest);
+
+/**
+ * Construct the default direct face and initialize its state.
+ * The face is added to the default forwarder, which should be inited first.
+ * @return the pointer to the constructed direct face. NULL if the face table is full.
+ */
+ndn_direct_face_t*
+ndn_direct_face_construct(void);
+
+/**
+ * Let the default direct face express an interest. See direct_face_express_interest().
+ */
+int
 ndn_direct_face_express_interest(const ndn_name_t* prefix_name,
                                  uint8_t* interest, uint32_t interest_size,
                                  ndn_on_data_callback on_data,
-                                 ndn_interest_timeout_callback on_interest_timeout);
+                                 ndn_interest_timeout_callback on_interest_timeout,
+                                 ndn_on_nack_callback on_nack);
 
 /**
- * Let the direct face register a prefix on the FIB.
- * @param interest_name. Input. Prefix name to identify the callback entry.
- * @param on_interest. Input. on_interest function pointer of the callback entry.
- * @return 0 if there is no error.
+ * Let the default direct face register a prefix. See direct_face_register_prefix().
  */
 int
 ndn_direct_face_register_prefix(const ndn_name_t* interest_name,
@@ -10,6 +10,7 @@
 
 #include "dummy-face.h"
 #include "../encode/data.h"
+#include "../forwarder/forwarder.h"
 #include <stdio.h>
 
 /************************************************************/
@@ -54,14 +55,20 @@ ndn_dummy_face_destroy(struct ndn_face_intf* self)
 }
 
 ndn_dummy_face_t*
-ndn_dummy_face_construct(ndn_dummy_face_t* face, uint16_t face_id)
+ndn_dummy_face_construct(ndn_dummy_face_t* face)
 {
   face->intf.up = ndn_dummy_face_up;
   face->intf.send = ndn_dummy_face_send;
+  face->intf.send_pktbuf = NULL;
   face->intf.down = ndn_dummy_face_down;
   face->intf.destroy = ndn_dummy_face_destroy;
-  face->intf.face_id = face_id;
+  face->intf.forwarder = NULL;
+  face->intf.face_id = NDN_INVALID_FACE_ID;
   face->intf.state = NDN_FACE_STATE_DESTROYED;
   face->intf.type = NDN_FACE_TYPE_NET;
+  memset(&face->intf.counters, 0, sizeof(face->intf.counters));
+  if (ndn_forwarder_add_face(&face->intf) != 0) {
+    return NULL;
+  }
   return face;
 }
@@ -33,12 +33,12 @@ typedef struct ndn_dummy_face {
 
 /**
  * Construct the dummy face and initialize its state.
+ * The face is added to the forwarder, which assigns its face ID.
  * @param face. Input. The dummy face to be constructed.
- * @param face_id. Input. The face id to identity the dummy face.
- * @return the pointer to the constructed dummy face.
+ * @return the pointer to the constructed dummy face. NULL if the face table is full.
  */
 ndn_dummy_face_t*
-ndn_dummy_face_construct(ndn_dummy_face_t* face, uint16_t face_id);
+ndn_dummy_face_construct(ndn_dummy_face_t* face);
 
 #ifdef __cplusplus
 }
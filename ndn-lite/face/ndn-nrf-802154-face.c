@@ -11,7 +11,8 @@
 #include "ndn-nrf-802154-face.h"
 #include "../encode/data.h"
 #include "../encode/fragmentation-support.h"
-#include <stdio.h>
+#include "../forwarder/forwarder.h"
+#include "../util/logger.h"
 
 static ndn_nrf_802154_face_t nrf_802154_face;
 static frag_buffer[NDN_FRAG_BUFFER_MAX];
@@ -27,11 +28,12 @@ ndn_nrf_802154_face_get_instance()
 /*  Adaptation Helper Functions                             */
 /************************************************************/
 
+// The size of the frame header written by ndn_nrf_init_802154_header()
+#define NDN_NRF_802154_HEADER_SIZE 9
+
 static void
-ndn_nrf_init_802154_packet(uint8_t* message)
+ndn_nrf_init_802154_header(uint8_t* message)
 {
-  memset(message, 0, NDN_NRF_802154_MAX_MESSAGE_SIZE);
-
   // frame header:
   message[0] = 0x41; // FCF, valued 0x9841
   message[1] = 0x98; // == 1001.1000.0100.0001
@@ -56,12 +58,17 @@ ndn_nrf_init_802154_packet(uint8_t* message)
   // end of header
 }
 
+static void
+ndn_nrf_init_802154_packet(uint8_t* message)
+{
+  memset(message, 0, NDN_NRF_802154_MAX_MESSAGE_SIZE);
+  ndn_nrf_init_802154_header(message);
+}
+
 static void
 ndn_nrf_init_802154_radio(const uint8_t* extended_address, const uint8_t* pan_id,
                           const uint8_t* short_address, bool promisc)
 {
-  printf("\r\ninit 802.15.4 driver\r\n");
-
   nrf_802154_init();
   nrf_802154_short_address_set(short_address);
   nrf_802154_extended_address_set(extended_address);
@@ -72,7 +79,7 @@ ndn_nrf_init_802154_radio(const uint8_t* extended_address, const uint8_t* pan_id
   nrf_802154_channel_set(NDN_NRF_802154_CHANNEL);
   nrf_802154_receive();
 
-  printf("TX power currently set to %ddBm\r\n", (int)nrf_802154_tx_power_get());
+  NDN_LOG_INFO(IEEE802154_INIT, nrf_802154_tx_power_get());
 }
 
 /************************************************************/
@@ -100,19 +107,18 @@ _nrf_802154_transmission(uint8_t* packet_block, uint32_t packet_size, bool flag)
       ++delay_loops;
     }
     if (nrf_802154_face.tx_done) {
-      printf("TX finished.\r\n");
+      NDN_LOG_DEBUG(IEEE802154_TX_FINISHED);
       nrf_802154_face.packet_id++;
       nrf_802154_face.on_error(3);
       return 0;
     }
     else if (nrf_802154_face.tx_failed) {
-      printf("TX failed due to busy: %u\r\n",
-             (unsigned)nrf_802154_face.tx_errorcode);
+      NDN_LOG_WARN(IEEE802154_TX_FAILED, nrf_802154_face.tx_errorcode);
       nrf_802154_face.on_error(4);
       return -1;
     }
     else {
-      printf("TX TIMEOUT!\r\n");
+      NDN_LOG_WARN(IEEE802154_TX_TIMEOUT);
       nrf_802154_face.on_error(1);
       return -2;
     }
@@ -143,16 +149,32 @@ ndn_nrf_802154_face_send(struct ndn_face_intf* self, const ndn_name_t* name,
     uint16_t id = 99; // only for test, should be random
     ndn_fragmenter_init(&fragmenter, packet, size, NDN_NRF_802154_MAX_PAYLOAD_SIZE, 
                         id);
-    printf("%d pieces needed\n", fragmenter.total_frag_num);
+    NDN_LOG_DEBUG(IEEE802154_FRAGMENTS, fragmenter.total_frag_num);
     while (fragmenter.counter < fragmenter.total_frag_num) {
       ndn_fragmenter_fragment(&fragmenter, &packet_block[9]); 
-      printf("fragmentation output ONE piece, No. %d\n", fragmenter.counter);
+      NDN_LOG_DEBUG(IEEE802154_FRAGMENT, fragmenter.counter);
       _nrf_802154_transmission(packet_block, size + 9, true);
     }
   }
   return 0;
 }
 
+int
+ndn_nrf_802154_face_send_pktbuf(struct ndn_face_intf* self, const ndn_name_t* name,
+                                ndn_pktbuf_t* packet)
+{
+  if (packet->headroom < NDN_NRF_802154_HEADER_SIZE
+      || packet->size > NDN_NRF_802154_MAX_PAYLOAD_SIZE) {
+    return ndn_nrf_802154_face_send(self, name, packet->data, packet->size);
+  }
+  // the frame header goes into the headroom, so the payload is not copied
+  uint8_t* frame = packet->data - NDN_NRF_802154_HEADER_SIZE;
+  ndn_nrf_init_802154_header(frame);
+  frame[2] = nrf_802154_face.packet_id & 0xff;
+  _nrf_802154_transmission(frame, packet->size + NDN_NRF_802154_HEADER_SIZE, true);
+  return 0;
+}
+
 int
 ndn_nrf_802154_face_down(struct ndn_face_intf* self)
 {
@@ -168,18 +190,18 @@ ndn_nrf_802154_face_destroy(struct ndn_face_intf* self)
 }
 
 ndn_nrf_802154_face_t*
-ndn_nrf_802154_face_construct(uint16_t face_id,
-                              const uint8_t* extended_address, const uint8_t* pan_id,
+ndn_nrf_802154_face_construct(const uint8_t* extended_address, const uint8_t* pan_id,
                               const uint8_t* short_address, bool promisc,
                               ndn_on_error_callback_t error_callback)
 {
   nrf_802154_face.intf.up = ndn_nrf_802154_face_up;
   nrf_802154_face.intf.send = ndn_nrf_802154_face_send;
+  nrf_802154_face.intf.send_pktbuf = ndn_nrf_802154_face_send_pktbuf;
   nrf_802154_face.intf.down = ndn_nrf_802154_face_down;
   nrf_802154_face.intf.destroy = ndn_nrf_802154_face_destroy;
-  nrf_802154_face.intf.face_id = face_id;
   nrf_802154_face.intf.state = NDN_FACE_STATE_DESTROYED;
   nrf_802154_face.intf.type = NDN_FACE_TYPE_NET;
+  memset(&nrf_802154_face.intf.counters, 0, sizeof(nrf_802154_face.intf.counters));
 
   nrf_802154_face.tx_done = false;
   nrf_802154_face.tx_failed = false;
@@ -197,6 +219,9 @@ ndn_nrf_802154_face_construct(uint16_t face_id,
 
   ndn_frag_assembler_init(&assembler, frag_buffer, sizeof(frag_buffer));
 
+  if (ndn_forwarder_add_face(&nrf_802154_face.intf) != 0) {
+    return NULL;
+  }
   return &nrf_802154_face;
 }
 
@@ -230,13 +255,12 @@ void
 nrf_802154_received(uint8_t* p_data, uint8_t length, int8_t power, uint8_t lqi)
 {
   nrf_802154_face.on_error(2);
-  printf("RX frame, power %d, lqi %u, payload len %u: ",
-         (int) power, (unsigned) lqi, (unsigned) length);
+  NDN_LOG_DEBUG(IEEE802154_RX, (int32_t)power, lqi, length);
 
   if (length - 9 <= NDN_NRF_802154_MAX_PAYLOAD_SIZE) {
     ndn_frag_assembler_assemble_frag(&assembler, &p_data[9], length);
     if (assembler.is_finished) {
-      ndn_face_receive(&nrf_802154_face.intf, frag_buffer, assembler.offset);
+      ndn_face_receive_deferred(&nrf_802154_face.intf, frag_buffer, assembler.offset);
       ndn_frag_assembler_init(&assembler, frag_buffer, sizeof(frag_buffer));
     }  
   }
@@ -72,16 +72,16 @@ ndn_nrf_init_802154_get_face_instance();
 
 /**
  * Construct the nrf_802154 face and initialize its state.
- * @param face_id. Input. The face id to identity the dummy face.
+ * The face is added to the forwarder, which assigns its face ID.
  * @param extended_address. Input.
  * @param pan_id. Input.
  * @param short_address. Input.
  * @param promisc. Input.
  * @param error_callback. Input. Function pointer to on_error callback
- * @return the pointer to the constructed nrf_802154 face.
+ * @return the pointer to the constructed nrf_802154 face. NULL if the face table is full.
  */
 ndn_nrf_802154_face_t*
-ndn_nrf_802154_face_construct(uint16_t face_id, const uint8_t* extended_address,
+ndn_nrf_802154_face_construct(const uint8_t* extended_address,
                               const uint8_t* pan_id, const uint8_t* short_address,
                               bool promisc, ndn_on_error_callback_t error_callback);
 
@@ -10,7 +10,8 @@
 
 #include "ndn-nrf-ble-face.h"
 #include "../encode/data.h"
-#include <stdio.h>
+#include "../forwarder/forwarder.h"
+#include "../util/logger.h"
 
 #include "nrf_delay.h"
 
@@ -30,9 +31,8 @@ static ndn_nrf_ble_face_t nrf_ble_face;
 
 ble_uuid_t ndn_nrf_ble_face_adv_uuid = {NDN_LITE_BLE_EXT_ADV_UUID, BLE_UUID_TYPE_BLE};
 
-uint8_t current_packet_block_to_send[NDN_NRF_BLE_MAX_PAYLOAD_SIZE];
-uint8_t *current_packet_block_to_send_p = NULL;
-uint32_t current_packet_block_to_send_size = 0;
+// the packet being sent, held until it is sent through both unicast and extended advertising
+static ndn_pktbuf_t *current_packet_to_send = NULL;
 
 ndn_nrf_ble_face_t *
 ndn_nrf_ble_face_get_instance() {
@@ -48,61 +48,80 @@ int ndn_nrf_ble_face_up(struct ndn_face_intf *self) {
   return 0;
 }
 
-int ndn_nrf_ble_send_unicast_packet(const char *msg);
-int ndn_nrf_ble_send_extended_adv_packet(const char *msg);
+int ndn_nrf_ble_send_unicast_packet(void);
+int ndn_nrf_ble_send_extended_adv_packet(void);
 
-int ndn_nrf_ble_face_send(struct ndn_face_intf *self, const ndn_name_t *name,
-    const uint8_t *packet, uint32_t size) {
+static void ndn_nrf_ble_release_current_packet(void) {
+  if (current_packet_to_send != NULL) {
+    pktbuf_release(current_packet_to_send);
+    current_packet_to_send = NULL;
+  }
+}
+
+int ndn_nrf_ble_face_send_pktbuf(struct ndn_face_intf *self, const ndn_name_t *name,
+    ndn_pktbuf_t *packet) {
 
-  printf("ndn_nrf_ble_face_send got called. \n");
+  NDN_LOG_DEBUG(BLE_SEND, packet->size);
 
   (void)self;
   (void)name;
-  uint8_t packet_block[NDN_NRF_BLE_MAX_PAYLOAD_SIZE];
 
-  if (current_packet_block_to_send_p != NULL) {
-    printf("in ndn_nrf_ble_face_send, current_packet_block_to_send_p wasn't NULL, "
-           "meaning we are currently sending something else\n");
+  if (current_packet_to_send != NULL) {
+    NDN_LOG_WARN(BLE_SEND_BUSY);
     return -1;
   }
 
   // init payload
-  if (!(size <= NDN_NRF_BLE_MAX_PAYLOAD_SIZE)) {
+  if (!(packet->size <= NDN_NRF_BLE_MAX_PAYLOAD_SIZE)) {
     // TBD
-    printf("ndn_nrf_ble_face_send failed; size of packet was larger than max payload size.\n");
+    NDN_LOG_WARN(BLE_SEND_OVERSIZE, packet->size);
     return -1;
   }
 
-  // remember what packet we are currently trying to send
-  current_packet_block_to_send_p = &current_packet_block_to_send[0];
-  memcpy(current_packet_block_to_send, packet, size);
-  current_packet_block_to_send_size = size;
+  // remember what packet we are currently trying to send, without copying it
+  current_packet_to_send = pktbuf_retain(packet);
 
   // as soon as someone requests to send data, we send to the controller, and then
   // disconnect to do extended advertising with the same data packet, then reconnect to the controller
   // afterwards
 
   if (nrf_sdk_ble_stack_connected()) {
-    printf("in ndn_nrf_ble_face_send, we were connected.\n");
-    if (!ndn_nrf_ble_send_unicast_packet("in ndn_nrf_ble_face_send, "
-                                    "ndn_lite_ble_unicast_transport_send failed.\n")) {
-      if (!ndn_nrf_ble_send_extended_adv_packet("in ndn_nrf_ble_face_send, "
-                                           "calling ndn_nrf_ble_send_extended_adv_packet "
-                                           "failed, so calling "
-                                            "ndn_nrf_ble_send_extended_adv_packet\n")) {
-        printf("in ndn_nrf_ble_face_send, both ndn_nrf_ble_send_unicast_packet and "
-               "ndn_nrf_ble_send_extended_adv_packet failed\n");
+    NDN_LOG_DEBUG(BLE_SEND_CONNECTED);
+    if (!ndn_nrf_ble_send_unicast_packet()) {
+      if (!ndn_nrf_ble_send_extended_adv_packet()) {
+        NDN_LOG_ERROR(BLE_SEND_FAILED);
       }
     }
   } else {
-    printf("in ndn_nrf_ble_face_send, we were not connected.\n");
-    ndn_nrf_ble_send_extended_adv_packet("nrf_sdk_ble_adv_start inside of "
-                                         "ndn_nrf_ble_adv_stopped failed.\n");
+    NDN_LOG_DEBUG(BLE_SEND_NOT_CONNECTED);
+    ndn_nrf_ble_send_extended_adv_packet();
   }
 
   return 0;
 }
 
+int ndn_nrf_ble_face_send(struct ndn_face_intf *self, const ndn_name_t *name,
+    const uint8_t *packet, uint32_t size) {
+
+  if (current_packet_to_send != NULL) {
+    NDN_LOG_WARN(BLE_SEND_BUSY);
+    return -1;
+  }
+  if (!(size <= NDN_NRF_BLE_MAX_PAYLOAD_SIZE)) {
+    NDN_LOG_WARN(BLE_SEND_OVERSIZE, size);
+    return -1;
+  }
+
+  // the packet is only copied when it does not come in a packet buffer
+  ndn_pktbuf_t *pktbuf = pktbuf_from_packet(NULL, packet, size);
+  if (pktbuf == NULL) {
+    return NDN_FWD_NO_MEM;
+  }
+  int ret = ndn_nrf_ble_face_send_pktbuf(self, name, pktbuf);
+  pktbuf_release(pktbuf);
+  return ret;
+}
+
 int ndn_nrf_ble_face_down(struct ndn_face_intf *self) {
   self->state = NDN_FACE_STATE_DOWN;
   return 0;
@@ -118,7 +137,7 @@ void ndn_nrf_ble_recvd_data_unicast(const uint8_t *p_data, uint16_t length);
 void ndn_nrf_ble_legacy_adv_stopped();
 
 ndn_nrf_ble_face_t *
-ndn_nrf_ble_face_construct(uint16_t face_id) {
+ndn_nrf_ble_face_construct(void) {
   // Initialize BLE related things.
   nrf_sdk_ble_stack_init();
 
@@ -137,34 +156,38 @@ ndn_nrf_ble_face_construct(uint16_t face_id) {
 
   nrf_ble_face.intf.up = ndn_nrf_ble_face_up;
   nrf_ble_face.intf.send = ndn_nrf_ble_face_send;
+  nrf_ble_face.intf.send_pktbuf = ndn_nrf_ble_face_send_pktbuf;
   nrf_ble_face.intf.down = ndn_nrf_ble_face_down;
   nrf_ble_face.intf.destroy = ndn_nrf_ble_face_destroy;
-  nrf_ble_face.intf.face_id = face_id;
   nrf_ble_face.intf.state = NDN_FACE_STATE_DESTROYED;
   nrf_ble_face.intf.type = NDN_FACE_TYPE_NET;
+  memset(&nrf_ble_face.intf.counters, 0, sizeof(nrf_ble_face.intf.counters));
 
+  if (ndn_forwarder_add_face(&nrf_ble_face.intf) != 0) {
+    return NULL;
+  }
   return &nrf_ble_face;
 }
 
 //================================================================
 
-int ndn_nrf_ble_send_extended_adv_packet(const char *fail_msg) {
-  if (nrf_sdk_ble_adv_start(current_packet_block_to_send, current_packet_block_to_send_size,
+int ndn_nrf_ble_send_extended_adv_packet(void) {
+  if (nrf_sdk_ble_adv_start(current_packet_to_send->data, current_packet_to_send->size,
           ndn_nrf_ble_face_adv_uuid, true, NDN_NRF_BLE_ADV_NUM,
           ndn_nrf_ble_adv_stopped) != NRF_BLE_OP_SUCCESS) {
-    printf(fail_msg);
-    // always set this pointer to NULL if sending extended advertisement packet fails, so that
+    NDN_LOG_WARN(BLE_EXT_ADV_FAILED);
+    // always release the packet if sending extended advertisement packet fails, so that
     // the face doesn't get stuck into thinking its still sending something
-    current_packet_block_to_send_p == NULL;
+    ndn_nrf_ble_release_current_packet();
     return -1;
   }
   return 1;
 }
 
-int ndn_nrf_ble_send_unicast_packet(const char *fail_msg) {
-  if (nrf_sdk_ble_ndn_lite_ble_unicast_transport_send(current_packet_block_to_send_p,
-       current_packet_block_to_send_size) != NRF_BLE_OP_SUCCESS) {
-    printf(fail_msg);
+int ndn_nrf_ble_send_unicast_packet(void) {
+  if (nrf_sdk_ble_ndn_lite_ble_unicast_transport_send(current_packet_to_send->data,
+       current_packet_to_send->size) != NRF_BLE_OP_SUCCESS) {
+    NDN_LOG_WARN(BLE_UNICAST_FAILED);
     return -1;
   }
   return 1;
@@ -173,54 +196,44 @@ int ndn_nrf_ble_send_unicast_packet(const char *fail_msg) {
 // below are callback functions for BLE related events
 
 void ndn_nrf_ble_legacy_adv_stopped() {
-  printf("ndn_nrf_ble_legacy_adv_stopped got called.\n");
+  NDN_LOG_DEBUG(BLE_LEGACY_ADV_STOPPED);
 }
 
 void ndn_nrf_ble_unicast_on_mtu_rqst(uint16_t conn_handle) {
-  printf("ndn_nrf_ble_unicast_on_mtu_rqst got called.\n");
+  NDN_LOG_DEBUG(BLE_MTU_REQUEST, conn_handle);
 }
 
 void ndn_nrf_ble_unicast_connected(uint16_t conn_handle) {
-  printf("ndn_nrf_ble_unicast_connected got called.\n");
+  NDN_LOG_INFO(BLE_CONNECTED, conn_handle);
 }
 
 void ndn_nrf_ble_unicast_hvn_tx_complete(uint16_t conn_handle) {
-  printf("ndn_nrf_ble_unicast_hvn_tx_complete got called.\n");
+  NDN_LOG_DEBUG(BLE_HVN_TX_COMPLETE, current_packet_to_send != NULL);
 
-  // if current_packet_block_to_send_p isn't NULL, then that means that this notification transmission complete
+  // if current_packet_to_send isn't NULL, then that means that this notification transmission complete
   // event was due to a call to ndn_nrf_ble_face_send, rather than the sign on basic client
-  if (current_packet_block_to_send_p != NULL) {
-    printf("in ndn_nrf_ble_unicast_hvn_tx_complete, current_packet_block_to_send_p wasn't NULL.\n");
+  if (current_packet_to_send != NULL) {
     if (nrf_sdk_ble_ndn_lite_ble_unicast_transport_disconnect(ndn_nrf_ble_unicast_disconnected) == NRF_BLE_OP_FAILURE) {
-      printf("nrf_sdk_ble_adv_start is being called within ndn_nrf_ble_unicast_hvn_tx_complete\n");
-      ndn_nrf_ble_send_extended_adv_packet("nrf_sdk_ble_adv_start inside of ndn_nrf_ble_adv_stopped "
-                                           "failed.\n");
+      ndn_nrf_ble_send_extended_adv_packet();
     } else {
       // if ndn_lite_ble_unicast_transport_disconnect returned NRF_BLE_OP_SUCCESS, it means that we will have
       // to wait for the on disconnect callback
-      printf("in ndn_nrf_ble_unicast_hvn_tx_complete, ndn_lite_ble_unicast_transport_disconnect "
-             "returned NRF_BLE_OP_SUCCESS\n");
+      NDN_LOG_DEBUG(BLE_DISCONNECT_PENDING);
     }
-  } else {
-    printf("in ndn_nrf_ble_unicast_hvn_tx_complete, "
-           "current_packet_block_to_send_p was NULL.\n");
   }
 }
 
 void ndn_nrf_ble_unicast_disconnected() {
-  printf("ndn_nrf_ble_unicast_disconnected got called.\n");
+  NDN_LOG_INFO(BLE_DISCONNECTED, current_packet_to_send != NULL);
 
   // now that we are disconnected from the unicast connection with the controller, we can
   // actually send the data; after we finish sending, we will reconnect to the controller and
   // also restart scanning for packets from the other board, so that we can simultaneously detect
   // other ndn-lite ble face messages as well as messages from the unicast connection to the phone
-  if (current_packet_block_to_send_p != NULL) {
-    printf("in ndn_nrf_ble_unicast_disconnected, current_packet_block_to_send_p wasn't NULL.\n");
-    ndn_nrf_ble_send_extended_adv_packet("nrf_sdk_ble_adv_start inside of "
-                                         "ndn_nrf_ble_unicast_disconnected failed.\n");
+  if (current_packet_to_send != NULL) {
+    ndn_nrf_ble_send_extended_adv_packet();
   } else {
-    printf("in ndn_nrf_ble_unicast_disconnected, current_packet_block_to_send_p was NULL.\n");
-    // because the current_packet_block_to_send_p was NULL, it means that the disconnection wasn't
+    // because the current_packet_to_send was NULL, it means that the disconnection wasn't
     // triggered by the ndn-lite ble face to send data, and may be due to the controller moving out of
     // range; in that case, we resume legacy advertisements,
     // in order to connect to the controller as soon as it can be connected to again
@@ -229,11 +242,11 @@ void ndn_nrf_ble_unicast_disconnected() {
 }
 
 void ndn_nrf_ble_adv_stopped(void) {
-  printf("ndn_nrf_ble_adv_stopped got called.\n");
+  NDN_LOG_DEBUG(BLE_ADV_STOPPED);
 
-  // make sure to set current_packet_block_to_send_p to NULL to indicate that we have sent
+  // make sure to release current_packet_to_send to indicate that we have sent
   // this packet to both the controller through unicast and through extended advertising broadcast
-  current_packet_block_to_send_p = NULL;
+  ndn_nrf_ble_release_current_packet();
 
   // this is a hack for now; since we are using ble advertising for both the ndn-lite ble face
   // and the secure sign on ble object, we will just share advertising between them; any time that
@@ -243,15 +256,15 @@ void ndn_nrf_ble_adv_stopped(void) {
 }
 
 void ndn_nrf_ble_recvd_data_ext_adv(const uint8_t *p_data, uint8_t length) {
-  printf("RX frame  (ext adv), payload len %u: \n", (unsigned)length);
+  NDN_LOG_DEBUG(BLE_RX_EXT_ADV, length);
 
-  ndn_face_receive(&nrf_ble_face.intf, p_data + NDN_NRF_BLE_ADV_PAYLOAD_HEADER_LENGTH,
+  ndn_face_receive_deferred(&nrf_ble_face.intf, p_data + NDN_NRF_BLE_ADV_PAYLOAD_HEADER_LENGTH,
       length - NDN_NRF_BLE_ADV_PAYLOAD_HEADER_LENGTH);
 }
 
 void ndn_nrf_ble_recvd_data_unicast(const uint8_t *p_data, uint16_t length) {
-  printf("RX frame (unicast), payload len %u: \n", (unsigned)length);
+  NDN_LOG_DEBUG(BLE_RX_UNICAST, length);
 
-  ndn_face_receive(&nrf_ble_face.intf, p_data,
+  ndn_face_receive_deferred(&nrf_ble_face.intf, p_data,
       (uint8_t)length);
 }
\ No newline at end of file
@@ -48,8 +48,10 @@ typedef struct ndn_nrf_ble_face {
 ndn_nrf_ble_face_t*
 ndn_nrf_init_ble_get_face_instance();
 
+// the face is added to the forwarder, which assigns its face ID
+// returns NULL if the face table of the forwarder is full
 ndn_nrf_ble_face_t*
-ndn_nrf_ble_face_construct(uint16_t face_id);
+ndn_nrf_ble_face_construct(void);
 
 #ifdef __cplusplus
 }
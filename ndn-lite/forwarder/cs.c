@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include "cs.h"
+
+// Whether the cached name begins with the given component TLVs, e.g. the value of a Name view
+static inline bool
+cs_entry_name_starts_with(const ndn_cs_entry_t* entry, const uint8_t* prefix, uint32_t prefix_size)
+{
+  return prefix_size <= entry->name_size
+    && memcmp(entry->data->data + entry->name_offset, prefix, prefix_size) == 0;
+}
+
+void
+cs_table_init(ndn_cs_t* cs, uint8_t* region, uint16_t capacity)
+{
+  cs->slots = (ndn_cs_entry_t*)region;
+  cs->capacity = capacity;
+  for (uint16_t i = 0; i < capacity; i++) {
+    cs->slots[i].data = NULL;
+    cs->slots[i].referenced = 0;
+  }
+  cs->hand = 0;
+  cs->hit_cnt = 0;
+  cs->miss_cnt = 0;
+}
+
+ndn_cs_entry_t*
+cs_table_find(ndn_cs_t* cs, const ndn_name_view_t* name, uint32_t hash,
+              bool can_be_prefix, bool must_be_fresh, timetick_t now)
+{
+  uint32_t name_size = name->offsets[name->components_size];
+  for (uint16_t i = 0; i < cs->capacity; i++) {
+    ndn_cs_entry_t* entry = &cs->slots[i];
+    if (entry->data == NULL) {
+      continue;
+    }
+    if (must_be_fresh && entry->stale_time <= now) {
+      continue;
+    }
+    if (can_be_prefix) {
+      if (!cs_entry_name_starts_with(entry, name->value, name_size))
+        continue;
+    }
+    else {
+      if (entry->name_hash != hash || entry->name_size != name_size
+          || !cs_entry_name_starts_with(entry, name->value, name_size))
+        continue;
+    }
+    entry->referenced = 1;
+    cs->hit_cnt++;
+    return entry;
+  }
+  cs->miss_cnt++;
+  return NULL;
+}
+
+int
+cs_table_insert(ndn_cs_t* cs, const ndn_name_view_t* name, uint32_t hash,
+                ndn_pktbuf_t* data, uint64_t freshness_period, timetick_t now)
+{
+  ndn_cs_entry_t* entry = NULL;
+  uint32_t name_size = name->offsets[name->components_size];
+
+  if (data->size > NDN_CS_DATA_BUFFER_SIZE
+      || name->value < data->data || name->value + name_size > data->data + data->size) {
+    return NDN_OVERSIZE;
+  }
+
+  // Refresh the cached copy, or take an empty entry
+  for (uint16_t i = 0; i < cs->capacity; i++) {
+    ndn_cs_entry_t* slot = &cs->slots[i];
+    if (slot->data == NULL) {
+      if (entry == NULL)
+        entry = slot;
+    }
+    else if (slot->name_hash == hash && slot->name_size == name_size
+             && cs_entry_name_starts_with(slot, name->value, name_size)) {
+      entry = slot;
+      break;
+    }
+  }
+
+  // CLOCK: give referenced entries a second chance
+  while (entry == NULL) {
+    ndn_cs_entry_t* slot = &cs->slots[cs->hand];
+    cs->hand = (cs->hand + 1) % cs->capacity;
+    if (slot->referenced) {
+      slot->referenced = 0;
+    }
+    else {
+      entry = slot;
+    }
+  }
+
+  // retain first, since the replaced Data may be the same packet buffer
+  pktbuf_retain(data);
+  if (entry->data != NULL) {
+    pktbuf_release(entry->data);
+  }
+  entry->name_offset = name->value - data->data;
+  entry->name_size = name_size;
+  entry->name_hash = hash;
+  entry->stale_time = now + freshness_period;
+  entry->data = data;
+  entry->referenced = 0;
+  return 0;
+}
+
+void
+cs_table_clear(ndn_cs_t* cs)
+{
+  for (uint16_t i = 0; i < cs->capacity; i++) {
+    if (cs->slots[i].data != NULL) {
+      pktbuf_release(cs->slots[i].data);
+      cs->slots[i].data = NULL;
+    }
+    cs->slots[i].referenced = 0;
+  }
+}
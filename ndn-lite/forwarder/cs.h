@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef FORWARDER_CS_H_
+#define FORWARDER_CS_H_
+
+#include "../encode/name.h"
+#include "scheduler.h"
+#include "packet-buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * ndn_cs_entry is a class of Content Store (CS) entries.
+ */
+typedef struct ndn_cs_entry {
+  /**
+   * The offset of the Name TLV value in @p data.
+   * The name is not copied, since the cached Data already contains it.
+   */
+  uint16_t name_offset;
+
+  /**
+   * The size of the Name TLV value in @p data.
+   */
+  uint16_t name_size;
+
+  /**
+   * The hash of the Data name, obtained from ndn_name_view_hash().
+   */
+  uint32_t name_hash;
+
+  /**
+   * The time after which the Data can no longer satisfy a MustBeFresh Interest.
+   */
+  timetick_t stale_time;
+
+  /**
+   * The wire format Data, a reference to the packet buffer it arrived in.
+   * NULL indicates an empty entry.
+   */
+  ndn_pktbuf_t* data;
+
+  /**
+   * The reference bit of the CLOCK replacement policy.
+   */
+  uint8_t referenced;
+} ndn_cs_entry_t;
+
+/**
+ * The class of Content Store (CS).
+ * The CS keeps at most @p capacity wire format Data packets and replaces
+ * them with the CLOCK policy, an approximation of LRU that only needs one
+ * bit per entry. The packets are shared with the faces through packet buffers,
+ * not copied.
+ */
+typedef struct ndn_cs {
+  /**
+   * The CS entries, @p capacity of them.
+   */
+  ndn_cs_entry_t* slots;
+
+  /**
+   * The number of entries.
+   */
+  uint16_t capacity;
+
+  /**
+   * The hand of the CLOCK replacement policy.
+   */
+  uint16_t hand;
+
+  /**
+   * The number of Interests satisfied by the CS.
+   */
+  uint32_t hit_cnt;
+
+  /**
+   * The number of Interests not satisfied by the CS.
+   */
+  uint32_t miss_cnt;
+} ndn_cs_t;
+
+/**
+ * The bytes of memory region taken by a CS: the entries, aligned to NDN_POOL_ALIGN.
+ */
+#define NDN_CS_REGION_SIZE(capacity) \
+  NDN_POOL_ALIGN_UP(sizeof(ndn_cs_entry_t) * (size_t)(capacity))
+
+/**
+ * Init an empty CS.
+ * @param cs. Output. The CS to be inited.
+ * @param region. Input. The memory region the entries are carved from, aligned to
+ *                NDN_POOL_ALIGN and of NDN_CS_REGION_SIZE() bytes. It must outlive the CS.
+ * @param capacity. Input. The number of entries, at least 1.
+ */
+void
+cs_table_init(ndn_cs_t* cs, uint8_t* region, uint16_t capacity);
+
+/**
+ * Find a cached Data that satisfies an Interest.
+ * This function updates the hit and miss counters.
+ * @param cs. Input/Output. The CS.
+ * @param name. Input. The view of the Interest name.
+ * @param hash. Input. The value of ndn_name_view_hash(@p name).
+ * @param can_be_prefix. Input. Whether the Interest has CanBePrefix.
+ * @param must_be_fresh. Input. Whether the Interest has MustBeFresh.
+ * @param now. Input. The current time.
+ * @return the CS entry. NULL if there is no matching Data.
+ */
+ndn_cs_entry_t*
+cs_table_find(ndn_cs_t* cs, const ndn_name_view_t* name, uint32_t hash,
+              bool can_be_prefix, bool must_be_fresh, timetick_t now);
+
+/**
+ * Insert a Data into the CS, replacing an old entry if the CS is full.
+ * A Data with the same name as a cached one replaces it.
+ * The CS takes a reference to the packet buffer, and releases the one of the replaced entry.
+ * @param cs. Input/Output. The CS.
+ * @param name. Input. The view of the Data name, which must refer into @p data.
+ * @param hash. Input. The value of ndn_name_view_hash(@p name).
+ * @param data. Input/Output. The packet buffer of the wire format Data.
+ * @param freshness_period. Input. The FreshnessPeriod of the Data. 0 if absent.
+ * @param now. Input. The current time.
+ * @return 0 if there is no error. NDN_OVERSIZE if the Data is larger than NDN_CS_DATA_BUFFER_SIZE.
+ */
+int
+cs_table_insert(ndn_cs_t* cs, const ndn_name_view_t* name, uint32_t hash,
+                ndn_pktbuf_t* data, uint64_t freshness_period, timetick_t now);
+
+/**
+ * Remove all the entries, releasing their packet buffers.
+ * @param cs. Input/Output. The CS.
+ */
+void
+cs_table_clear(ndn_cs_t* cs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FORWARDER_CS_H_
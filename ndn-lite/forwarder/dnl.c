@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include "dnl.h"
+#include <string.h>
+
+// Mix a (name, nonce) pair into one key, using the finalizer of MurmurHash3
+static uint32_t
+dnl_key(uint32_t name_hash, uint32_t nonce)
+{
+  uint32_t key = name_hash ^ (nonce * 0x9e3779b1u);
+  key ^= key >> 16;
+  key *= 0x85ebca6bu;
+  key ^= key >> 13;
+  key *= 0xc2b2ae35u;
+  key ^= key >> 16;
+  return key;
+}
+
+// The i-th bit position of a key, by a multiplicative hash of the key and i.
+// Double hashing would repeat positions, as the filter size is not a prime.
+static uint16_t
+dnl_bit(uint32_t key, uint8_t i)
+{
+  uint32_t h = (key ^ (i * 0x9e3779b9u)) * 0x85ebca6bu;
+  return (uint16_t)((h >> 16) % NDN_DNL_FILTER_SIZE);
+}
+
+static bool
+dnl_filter_find(const uint8_t* filter, uint32_t key)
+{
+  for (uint8_t i = 0; i < NDN_DNL_HASH_COUNT; i++) {
+    uint16_t bit = dnl_bit(key, i);
+    if ((filter[bit >> 3] & (1 << (bit & 7))) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void
+dnl_table_init(ndn_dnl_t* dnl)
+{
+  memset(dnl->filters, 0, sizeof(dnl->filters));
+  dnl->current = 0;
+  dnl->count = 0;
+}
+
+bool
+dnl_table_find(const ndn_dnl_t* dnl, uint32_t name_hash, uint32_t nonce)
+{
+  uint32_t key = dnl_key(name_hash, nonce);
+  return dnl_filter_find(dnl->filters[0], key) || dnl_filter_find(dnl->filters[1], key);
+}
+
+void
+dnl_table_insert(ndn_dnl_t* dnl, uint32_t name_hash, uint32_t nonce)
+{
+  uint32_t key = dnl_key(name_hash, nonce);
+  uint8_t* filter = dnl->filters[dnl->current];
+  for (uint8_t i = 0; i < NDN_DNL_HASH_COUNT; i++) {
+    uint16_t bit = dnl_bit(key, i);
+    filter[bit >> 3] |= (1 << (bit & 7));
+  }
+
+  // Start a new generation, dropping the records of the older one
+  dnl->count++;
+  if (dnl->count >= NDN_DNL_GENERATION_SIZE) {
+    dnl->current ^= 1;
+    memset(dnl->filters[dnl->current], 0, NDN_DNL_FILTER_SIZE / 8);
+    dnl->count = 0;
+  }
+}
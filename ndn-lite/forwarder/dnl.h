@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef FORWARDER_DNL_H_
+#define FORWARDER_DNL_H_
+
+#include "../ndn-constants.h"
+#include <inttypes.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The hash functions of each Bloom filter.
+ * A filter with k hash functions and k / ln 2 bits for each record gives a false positive
+ * at 2^-k, and a lookup checks both generations.
+ */
+#define NDN_DNL_HASH_COUNT (NDN_DNL_FALSE_POSITIVE_BITS + 1)
+
+/**
+ * The bits of each Bloom filter, a multiple of 8.
+ */
+#define NDN_DNL_FILTER_SIZE \
+  ((NDN_DNL_GENERATION_SIZE * NDN_DNL_HASH_COUNT * 1443 / 1000 + 7) / 8 * 8)
+
+#if NDN_DNL_FILTER_SIZE > 65535
+#error NDN_DNL_GENERATION_SIZE is too large for the Bloom filters of the DNL
+#endif
+
+/**
+ * The class of dead nonce list (DNL).
+ * The DNL remembers the (name, nonce) pairs of Interests whose PIT entries are gone,
+ * so that a looping Interest coming back later can still be detected.
+ * The records are kept in two Bloom filters used as generations: new records go to the
+ * current one, and the older one is cleared and reused after NDN_DNL_GENERATION_SIZE
+ * records. A record is thus remembered for at least NDN_DNL_GENERATION_SIZE insertions.
+ * False positives are possible, in which case an Interest is dropped and the consumer
+ * retransmits it with a new nonce. The filters are sized for a rate of about
+ * 2^-NDN_DNL_FALSE_POSITIVE_BITS.
+ */
+typedef struct ndn_dnl {
+  /**
+   * The bits of the two Bloom filters.
+   */
+  uint8_t filters[2][NDN_DNL_FILTER_SIZE / 8];
+
+  /**
+   * The index of the current generation in @p filters.
+   */
+  uint8_t current;
+
+  /**
+   * The number of records inserted into the current generation.
+   */
+  uint16_t count;
+} ndn_dnl_t;
+
+/**
+ * Init an empty DNL.
+ * @param dnl. Output. The DNL to be inited.
+ */
+void
+dnl_table_init(ndn_dnl_t* dnl);
+
+/**
+ * Check whether an Interest has been recorded in the DNL.
+ * @param dnl. Input. The DNL.
+ * @param name_hash. Input. The value of ndn_name_hash() of the Interest name.
+ * @param nonce. Input. The nonce of the Interest.
+ * @return true if the Interest is probably recorded. false if it is surely not.
+ */
+bool
+dnl_table_find(const ndn_dnl_t* dnl, uint32_t name_hash, uint32_t nonce);
+
+/**
+ * Record an Interest in the DNL.
+ * @param dnl. Input/Output. The DNL.
+ * @param name_hash. Input. The value of ndn_name_hash() of the Interest name.
+ * @param nonce. Input. The nonce of the Interest.
+ */
+void
+dnl_table_insert(ndn_dnl_t* dnl, uint32_t name_hash, uint32_t nonce);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FORWARDER_DNL_H_
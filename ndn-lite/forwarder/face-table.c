@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include "face-table.h"
+
+void
+face_table_init(ndn_face_table_t* table)
+{
+  for (uint8_t i = 0; i < NDN_FACE_TABLE_MAX_SIZE; i++) {
+    table->slots[i] = NULL;
+  }
+}
+
+int
+face_table_add(ndn_face_table_t* table, ndn_face_intf_t* face)
+{
+  if (face_table_contains(table, face)) {
+    return 0;
+  }
+  for (uint8_t i = 0; i < NDN_FACE_TABLE_MAX_SIZE; i++) {
+    if (table->slots[i] == NULL) {
+      table->slots[i] = face;
+      face->face_id = i;
+      return 0;
+    }
+  }
+  return NDN_FWD_FACE_TABLE_FULL;
+}
+
+void
+face_table_remove(ndn_face_table_t* table, ndn_face_intf_t* face)
+{
+  if (face_table_contains(table, face)) {
+    table->slots[face->face_id] = NULL;
+  }
+  face->face_id = NDN_INVALID_FACE_ID;
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef FORWARDER_FACE_TABLE_H_
+#define FORWARDER_FACE_TABLE_H_
+
+#include "face.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if NDN_FACE_TABLE_MAX_SIZE >= NDN_INVALID_FACE_ID
+#error "Face IDs must fit in one byte"
+#endif
+
+/**
+ * The class of face table.
+ * The face ID of a face is its position in the table, so a face is looked up by its ID
+ * in O(1), and the PIT and FIB refer to faces by one-byte IDs instead of pointers.
+ * An ID is reused by the next face added after its face is removed, so the tables
+ * must not keep the ID of a removed face.
+ */
+typedef struct ndn_face_table {
+  /**
+   * The faces, indexed by face ID. NULL indicates an unused ID.
+   */
+  ndn_face_intf_t* slots[NDN_FACE_TABLE_MAX_SIZE];
+} ndn_face_table_t;
+
+/**
+ * Init an empty face table.
+ * @param table. Output. The face table to be inited.
+ */
+void
+face_table_init(ndn_face_table_t* table);
+
+/**
+ * Add a face to the face table, and set its face ID.
+ * Adding a face that is already in the table keeps its face ID.
+ * @param table. Input/Output. The face table.
+ * @param face. Input/Output. The face.
+ * @return 0 if there is no error. NDN_FWD_FACE_TABLE_FULL if the table is full.
+ */
+int
+face_table_add(ndn_face_table_t* table, ndn_face_intf_t* face);
+
+/**
+ * Remove a face from the face table, and set its face ID to NDN_INVALID_FACE_ID.
+ * @param table. Input/Output. The face table.
+ * @param face. Input/Output. The face.
+ */
+void
+face_table_remove(ndn_face_table_t* table, ndn_face_intf_t* face);
+
+/**
+ * Get the face of a face ID.
+ * @param table. Input. The face table.
+ * @param face_id. Input. The face ID.
+ * @return the face. NULL if there is no such face.
+ */
+static inline ndn_face_intf_t*
+face_table_get(const ndn_face_table_t* table, uint16_t face_id)
+{
+  if (face_id >= NDN_FACE_TABLE_MAX_SIZE)
+    return NULL;
+  return table->slots[face_id];
+}
+
+/**
+ * Check whether a face is in the face table.
+ * @param table. Input. The face table.
+ * @param face. Input. The face.
+ * @return true if @p face is in the table.
+ */
+static inline bool
+face_table_contains(const ndn_face_table_t* table, const ndn_face_intf_t* face)
+{
+  return face_table_get(table, face->face_id) == face;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FORWARDER_FACE_TABLE_H_
@@ -9,28 +9,135 @@
 #include "face.h"
 #include "../encode/data.h"
 #include "forwarder.h"
-#include <stdio.h>
+#include "msg-queue.h"
+#include "../util/logger.h"
+
+// Count an outgoing packet by its TLV type
+static void
+ndn_face_count_out(ndn_face_counters_t* counters, uint8_t type)
+{
+  if (type == TLV_Interest) {
+    counters->n_out_interests++;
+  }
+  else if (type == TLV_Data) {
+    counters->n_out_data++;
+  }
+  else if (type == TLV_LpPacket) {
+    counters->n_out_nacks++;
+  }
+}
+
+// Count an outgoing packet and bring the face up before it is sent
+static void
+ndn_face_before_send(ndn_face_intf_t* self, const uint8_t* packet)
+{
+  ndn_face_count_out(&self->counters, packet[0]);
+  if (self->forwarder != NULL) {
+    ndn_face_count_out(&self->forwarder->counters.packets, packet[0]);
+  }
+
+  if (self->state != NDN_FACE_STATE_UP)
+    self->up(self);
+}
 
 int
-ndn_face_receive(ndn_face_intf_t* self, const uint8_t* packet, uint32_t size)
+ndn_face_send(ndn_face_intf_t* self, const ndn_name_t* name, const uint8_t* packet, uint32_t size)
+{
+  ndn_face_before_send(self, packet);
+  return self->send(self, name, packet, size);
+}
+
+int
+ndn_face_send_pktbuf(ndn_face_intf_t* self, const ndn_name_t* name, ndn_pktbuf_t* packet)
+{
+  ndn_face_before_send(self, packet->data);
+  if (self->send_pktbuf != NULL) {
+    return self->send_pktbuf(self, name, packet);
+  }
+  return self->send(self, name, packet->data, packet->size);
+}
+
+void
+ndn_face_destroy(ndn_face_intf_t* self)
+{
+  if (self->forwarder != NULL) {
+    forwarder_remove_face(self->forwarder, self);
+  }
+  self->state = NDN_FACE_STATE_DESTROYED;
+  self->destroy(self);
+}
+
+// Message queue callback of a deferred packet
+static void
+ndn_face_on_deferred_packet(void* self, size_t param_length, void* param)
+{
+  ndn_face_receive((ndn_face_intf_t*)self, (const uint8_t*)param, (uint32_t)param_length);
+}
+
+int
+ndn_face_receive_deferred(ndn_face_intf_t* self, const uint8_t* packet, uint32_t size)
+{
+  if (self->forwarder == NULL) {
+    return NDN_FWD_UNKNOWN_FACE;
+  }
+  if (!ndn_msgqueue_post(&self->forwarder->msgqueue, self, ndn_face_on_deferred_packet,
+                         size, (void*)packet)) {
+    // counted by the message queue, which is safe from interrupt handlers
+    return NDN_FWD_NO_MEM;
+  }
+  return 0;
+}
+
+// Pass a packet to the forwarder by its TLV type.
+// A Data is kept by the forwarder through @p pktbuf if it is given.
+static int
+ndn_face_receive_packet(ndn_face_intf_t* self, const uint8_t* packet, uint32_t size,
+                        ndn_pktbuf_t* pktbuf)
 {
   ndn_decoder_t decoder;
   uint32_t probe = 0;
+  ndn_forwarder_t* forwarder = self->forwarder;
 
-  printf("face receive packet---");
-
+  // The PIT keeps face IDs, so a face must be in the face table to take part in forwarding
+  if (forwarder == NULL || forwarder_get_face(forwarder, self->face_id) != self) {
+    return NDN_FWD_UNKNOWN_FACE;
+  }
+  ndn_face_counters_t* total = &forwarder->counters.packets;
   decoder_init(&decoder, packet, size);
   decoder_get_type(&decoder, &probe);
+  NDN_LOG_DEBUG(FACE_RECEIVE, self->face_id, probe, size);
   if (probe == TLV_Data) {
-    printf("data packet\n");
-    return ndn_forwarder_on_incoming_data(ndn_forwarder_get_instance(), self, NULL, packet, size);
+    self->counters.n_in_data++;
+    total->n_in_data++;
+    if (pktbuf != NULL) {
+      return ndn_forwarder_on_incoming_data_pktbuf(forwarder, self, pktbuf);
+    }
+    return ndn_forwarder_on_incoming_data(forwarder, self, packet, size);
   }
   else if (probe == TLV_Interest) {
-    printf("interest packet\n");
-    return ndn_forwarder_on_incoming_interest(ndn_forwarder_get_instance(), self, NULL, packet, size);
+    self->counters.n_in_interests++;
+    total->n_in_interests++;
+    return ndn_forwarder_on_incoming_interest(forwarder, self, packet, size);
+  }
+  else if (probe == TLV_LpPacket) {
+    self->counters.n_in_nacks++;
+    total->n_in_nacks++;
+    return ndn_forwarder_on_incoming_nack(forwarder, self, packet, size);
   }
   else {
     // TODO: fragmentation support
   }
   return 0;
 }
+
+int
+ndn_face_receive(ndn_face_intf_t* self, const uint8_t* packet, uint32_t size)
+{
+  return ndn_face_receive_packet(self, packet, size, NULL);
+}
+
+int
+ndn_face_receive_pktbuf(ndn_face_intf_t* self, ndn_pktbuf_t* packet)
+{
+  return ndn_face_receive_packet(self, packet->data, packet->size, packet);
+}
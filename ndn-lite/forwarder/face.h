@@ -10,6 +10,7 @@
 #define FORWARDER_FACE_H_
 
 #include "../encode/name.h"
+#include "packet-buffer.h"
 
 #define container_of(ptr, type, member) ({                \
   const typeof(((type *)0)->member) *__mptr = (ptr);      \
@@ -20,6 +21,7 @@ extern "C" {
 #endif
 
 struct ndn_face_intf;
+struct ndn_forwarder;
 
 /**
  * ndn_face_intf_up is a function pointer to the interface up function.
@@ -41,6 +43,19 @@ typedef int (*ndn_face_intf_up)(struct ndn_face_intf* self);
 typedef int (*ndn_face_intf_send)(struct ndn_face_intf* self,
                                   const ndn_name_t* name, const uint8_t* packet, uint32_t size);
 
+/**
+ * ndn_face_intf_send_pktbuf is a function pointer to the interface packet buffer sending function.
+ * A face that sends packets asynchronously, or needs headroom for its link layer header,
+ * realizes it to send a packet without copying it. The face takes its own reference to the
+ * buffer with pktbuf_retain() if it uses the buffer after returning.
+ * @param self. Input. The interface through which the packet will be sent.
+ * @param name. [optional]Input. The name of the packet.
+ * @param packet. Input/Output. The packet buffer. Its headroom can be written.
+ * @return 0 if there is no error.
+ */
+typedef int (*ndn_face_intf_send_pktbuf)(struct ndn_face_intf* self,
+                                         const ndn_name_t* name, ndn_pktbuf_t* packet);
+
 /**
  * ndn_face_intf_down is a function pointer to the interface down function.
  * After invoking the function, the interface will temporally be shut down.
@@ -56,6 +71,20 @@ typedef int (*ndn_face_intf_down)(struct ndn_face_intf* self);
  */
 typedef void (*ndn_face_intf_destroy)(struct ndn_face_intf* self);
 
+/**
+ * The packet counters of a face, or of the forwarder summed over all faces.
+ * The counters are 32-bit so that they are updated in one instruction on MCUs,
+ * and wrap around when they overflow.
+ */
+typedef struct ndn_face_counters {
+  uint32_t n_in_interests;
+  uint32_t n_in_data;
+  uint32_t n_in_nacks;
+  uint32_t n_out_interests;
+  uint32_t n_out_data;
+  uint32_t n_out_nacks;
+} ndn_face_counters_t;
+
 /**
  * ndn_face_intf is an abstraction for NDN network face.
  * This is an abstract 'class'.
@@ -69,9 +98,19 @@ typedef struct ndn_face_intf {
   ndn_face_intf_send send;
   ndn_face_intf_down down;
   ndn_face_intf_destroy destroy;
+  /**
+   * [optional] Send a packet buffer. NULL if the face only realizes @p send.
+   */
+  ndn_face_intf_send_pktbuf send_pktbuf;
 
   /**
-   * Unique Face ID.
+   * The forwarder the face is added to, set together with @p face_id.
+   * NULL if the face is not in a forwarder.
+   */
+  struct ndn_forwarder* forwarder;
+  /**
+   * Unique Face ID, assigned by the forwarder when the face is added to it.
+   * NDN_INVALID_FACE_ID if the face is not in the forwarder.
    */
   uint16_t face_id;
   /**
@@ -82,6 +121,11 @@ typedef struct ndn_face_intf {
    * The type of the face: NDN_FACE_TYPE_APP, NDN_FACE_TYPE_NET, NDN_FACE_TYPE_UNDEFINED
    */
   uint8_t type;
+  /**
+   * The packets received and sent through the face.
+   * A concrete face should zero them when it is constructed.
+   */
+  ndn_face_counters_t counters;
 } ndn_face_intf_t;
 
 /**
@@ -101,19 +145,26 @@ ndn_face_up(ndn_face_intf_t* self)
 /**
  * Send a packet through the interface to the network.
  * This function is supposed to be invoked by the forwarder ONLY.
+ * The packet is counted in the counters of the face and the forwarder.
  * @param self. Input. The interface through which the packet will be sent.
  * @param name. [optional]Input. The name of the packet.
  * @param packet. Input. The wire format packet buffer.
  * @param size. Input. The size of the wire format packet buffer.
  * @return 0 if there is no error.
  */
-static inline int
-ndn_face_send(ndn_face_intf_t* self, const ndn_name_t* name, const uint8_t* packet, uint32_t size)
-{
-  if (self->state != NDN_FACE_STATE_UP)
-    self->up(self);
-  return self->send(self, name, packet, size);
-}
+int
+ndn_face_send(ndn_face_intf_t* self, const ndn_name_t* name, const uint8_t* packet, uint32_t size);
+
+/**
+ * Send a packet buffer through the interface to the network, without copying it if the
+ * face realizes send_pktbuf. See ndn_face_send().
+ * @param self. Input. The interface through which the packet will be sent.
+ * @param name. [optional]Input. The name of the packet.
+ * @param packet. Input/Output. The packet buffer. The caller keeps its reference.
+ * @return 0 if there is no error.
+ */
+int
+ndn_face_send_pktbuf(ndn_face_intf_t* self, const ndn_name_t* name, ndn_pktbuf_t* packet);
 
 /**
  * Turn down the interface.
@@ -129,25 +180,49 @@ ndn_face_down(ndn_face_intf_t* self)
 
 /**
  * Destroy the interface.
+ * The face is removed from the forwarder first, with its routes and PIT records,
+ * so that no packet is sent to it afterwards.
  * @param self. Input. The interface to destroy.
  */
-static inline void
-ndn_face_destroy(ndn_face_intf_t* self)
-{
-  self->state = NDN_FACE_STATE_DESTROYED;
-  self->destroy(self);
-}
+void
+ndn_face_destroy(ndn_face_intf_t* self);
 
 /**
  * Send Interest to the Forwarder (Forwarder receives)
  * @param self. Input. The interface to transmit the packet to the forwarder.
  * @param packet. Input. The wire format packet buffer.
  * @param size. Input. The size of the wire format packet buffer.
- * @return 0 if there is no error.
+ * @return 0 if there is no error. NDN_FWD_UNKNOWN_FACE if the face is not in the forwarder.
  */
 int
 ndn_face_receive(ndn_face_intf_t* self, const uint8_t* packet, uint32_t size);
 
+/**
+ * Send a packet buffer to the Forwarder (Forwarder receives).
+ * The Forwarder keeps a Data by taking a reference to the buffer, instead of copying it
+ * into a buffer of its own.
+ * @param self. Input. The interface to transmit the packet to the forwarder.
+ * @param packet. Input/Output. The packet buffer. The caller keeps its reference.
+ * @return 0 if there is no error. NDN_FWD_UNKNOWN_FACE if the face is not in the forwarder.
+ */
+int
+ndn_face_receive_pktbuf(ndn_face_intf_t* self, ndn_pktbuf_t* packet);
+
+/**
+ * Send a packet to the Forwarder, to be processed later by forwarder_process().
+ * Faces receiving packets in interrupt handlers or radio callbacks should use this function
+ * instead of ndn_face_receive(), so that the forwarding does not run in the handlers.
+ * The packet is copied into the message queue, and the buffer can be reused on return.
+ * A queued packet is dropped if the face is destroyed before it is processed.
+ * @param self. Input. The interface to transmit the packet to the forwarder.
+ * @param packet. Input. The wire format packet buffer.
+ * @param size. Input. The size of the wire format packet buffer.
+ * @return 0 if there is no error. NDN_FWD_NO_MEM if the queue is full and the packet is dropped.
+ *         NDN_FWD_UNKNOWN_FACE if the face is not in a forwarder.
+ */
+int
+ndn_face_receive_deferred(ndn_face_intf_t* self, const uint8_t* packet, uint32_t size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include "fib.h"
+
+#define FIB_INDEX_MASK(fib) ((uint16_t)((fib)->index_size - 1))
+
+/************************************************************/
+/*  Definition of hash index helpers                        */
+/************************************************************/
+
+static void
+fib_index_rebuild(ndn_fib_t* fib)
+{
+  for (uint16_t i = 0; i < fib->index_size; i++) {
+    fib->index[i] = NDN_FIB_INDEX_EMPTY;
+  }
+  fib->tombstones = 0;
+  for (uint16_t i = 0; i < fib->capacity; i++) {
+    ndn_fib_entry_t* entry = &fib->slots[i];
+    if (entry->name_prefix == NDN_NAME_REF_NULL) {
+      continue;
+    }
+    uint16_t pos = entry->name_hash & FIB_INDEX_MASK(fib);
+    while (fib->index[pos] != NDN_FIB_INDEX_EMPTY) {
+      pos = (pos + 1) & FIB_INDEX_MASK(fib);
+    }
+    fib->index[pos] = i;
+    entry->index_pos = pos;
+  }
+}
+
+// find the entry with exactly @p length components that is a prefix of @p name
+static ndn_fib_entry_t*
+fib_index_find(ndn_fib_t* fib, const ndn_name_view_t* name, uint32_t length, uint32_t hash)
+{
+  uint16_t pos = hash & FIB_INDEX_MASK(fib);
+  while (fib->index[pos] != NDN_FIB_INDEX_EMPTY) {
+    if (fib->index[pos] != NDN_FIB_INDEX_TOMBSTONE) {
+      ndn_fib_entry_t* entry = &fib->slots[fib->index[pos]];
+      if (entry->name_hash == hash
+          && name_arena_components_size(&fib->names, entry->name_prefix) == length
+          && name_arena_is_prefix_of_view(&fib->names, entry->name_prefix, name) == 0) {
+        return entry;
+      }
+    }
+    pos = (pos + 1) & FIB_INDEX_MASK(fib);
+  }
+  return NULL;
+}
+
+/************************************************************/
+/*  Definition of FIB APIs                                  */
+/************************************************************/
+
+void
+fib_table_init(ndn_fib_t* fib, uint8_t* region, uint16_t capacity, uint16_t index_size,
+               uint16_t name_arena_size)
+{
+  fib->slots = (ndn_fib_entry_t*)region;
+  region += NDN_POOL_ALIGN_UP(sizeof(ndn_fib_entry_t) * (size_t)capacity);
+  fib->index = (uint16_t*)region;
+  region += NDN_POOL_ALIGN_UP(sizeof(uint16_t) * (size_t)index_size);
+  fib->free_slots = (uint16_t*)region;
+  region += NDN_POOL_ALIGN_UP(sizeof(uint16_t) * (size_t)capacity);
+  fib->capacity = capacity;
+  fib->index_size = index_size;
+
+  for (uint16_t i = 0; i < capacity; i++) {
+    fib->slots[i].name_prefix = NDN_NAME_REF_NULL;
+    // pop from the tail, so slots are handed out from 0
+    fib->free_slots[i] = capacity - 1 - i;
+  }
+  fib->free_size = capacity;
+  for (uint8_t i = 0; i <= NDN_NAME_COMPONENTS_SIZE; i++) {
+    fib->prefix_length_cnt[i] = 0;
+  }
+  name_arena_init(&fib->names, region, name_arena_size);
+  fib_index_rebuild(fib);
+}
+
+ndn_fib_entry_t*
+fib_table_find_exact(ndn_fib_t* fib, const ndn_name_t* name_prefix)
+{
+  if (name_prefix->components_size > NDN_NAME_COMPONENTS_SIZE
+      || fib->prefix_length_cnt[name_prefix->components_size] == 0) {
+    return NULL;
+  }
+  uint32_t hash = ndn_name_hash(name_prefix);
+  uint16_t pos = hash & FIB_INDEX_MASK(fib);
+  while (fib->index[pos] != NDN_FIB_INDEX_EMPTY) {
+    if (fib->index[pos] != NDN_FIB_INDEX_TOMBSTONE) {
+      ndn_fib_entry_t* entry = &fib->slots[fib->index[pos]];
+      if (entry->name_hash == hash
+          && name_arena_compare_name(&fib->names, entry->name_prefix, name_prefix) == 0) {
+        return entry;
+      }
+    }
+    pos = (pos + 1) & FIB_INDEX_MASK(fib);
+  }
+  return NULL;
+}
+
+ndn_fib_entry_t*
+fib_table_lpm(ndn_fib_t* fib, const ndn_name_view_t* name)
+{
+  uint32_t hashes[NDN_NAME_VIEW_COMPONENTS_SIZE + 1];
+  ndn_name_view_prefix_hashes(name, hashes);
+  // FIB prefixes come from ndn_name_t, so they are never longer than NDN_NAME_COMPONENTS_SIZE
+  int length = name->components_size;
+  if (length > NDN_NAME_COMPONENTS_SIZE) {
+    length = NDN_NAME_COMPONENTS_SIZE;
+  }
+  for (; length >= 0; length--) {
+    if (fib->prefix_length_cnt[length] == 0) {
+      continue;
+    }
+    ndn_fib_entry_t* entry = fib_index_find(fib, name, length, hashes[length]);
+    if (entry != NULL) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+ndn_fib_entry_t*
+fib_table_insert(ndn_fib_t* fib, const ndn_name_t* name_prefix)
+{
+  if (fib->free_size == 0 || name_prefix->components_size > NDN_NAME_COMPONENTS_SIZE) {
+    return NULL;
+  }
+  ndn_name_ref_t name_ref = name_arena_store_name(&fib->names, name_prefix);
+  if (name_ref == NDN_NAME_REF_NULL) {
+    return NULL;
+  }
+  uint32_t hash = ndn_name_hash(name_prefix);
+  uint16_t pos = hash & FIB_INDEX_MASK(fib);
+  while (fib->index[pos] != NDN_FIB_INDEX_EMPTY && fib->index[pos] != NDN_FIB_INDEX_TOMBSTONE) {
+    pos = (pos + 1) & FIB_INDEX_MASK(fib);
+  }
+  if (fib->index[pos] == NDN_FIB_INDEX_TOMBSTONE) {
+    fib->tombstones--;
+  }
+
+  uint16_t slot = fib->free_slots[--fib->free_size];
+  ndn_fib_entry_t* entry = &fib->slots[slot];
+  entry->name_prefix = name_ref;
+  entry->name_hash = hash;
+  entry->index_pos = pos;
+  entry->nexthop_size = 0;
+  fib->index[pos] = slot;
+  fib->prefix_length_cnt[name_prefix->components_size]++;
+  return entry;
+}
+
+int
+fib_entry_add_nexthop(ndn_fib_entry_t* entry, ndn_face_intf_t* face, uint8_t cost)
+{
+  uint8_t i;
+  fib_entry_remove_nexthop(entry, face);
+  if (entry->nexthop_size == NDN_FIB_MAX_NEXTHOPS) {
+    return NDN_FWD_FIB_NEXTHOP_LIST_FULL;
+  }
+  // insertion sort by cost
+  for (i = entry->nexthop_size; i > 0 && entry->nexthops[i - 1].cost > cost; i--) {
+    entry->nexthops[i] = entry->nexthops[i - 1];
+  }
+  entry->nexthops[i].face_id = face->face_id;
+  entry->nexthops[i].cost = cost;
+  entry->nexthop_size++;
+  return 0;
+}
+
+void
+fib_entry_remove_nexthop(ndn_fib_entry_t* entry, const ndn_face_intf_t* face)
+{
+  for (uint8_t i = 0; i < entry->nexthop_size; i++) {
+    if (entry->nexthops[i].face_id == face->face_id) {
+      for (; i + 1 < entry->nexthop_size; i++) {
+        entry->nexthops[i] = entry->nexthops[i + 1];
+      }
+      entry->nexthop_size--;
+      return;
+    }
+  }
+}
+
+void
+fib_entry_delete(ndn_fib_t* fib, ndn_fib_entry_t* entry)
+{
+  if (entry->name_prefix == NDN_NAME_REF_NULL) {
+    return;
+  }
+  fib->prefix_length_cnt[name_arena_components_size(&fib->names, entry->name_prefix)]--;
+  name_arena_release(&fib->names, entry->name_prefix);
+  entry->name_prefix = NDN_NAME_REF_NULL;
+  fib->free_slots[fib->free_size++] = entry - fib->slots;
+
+  // A position followed by an empty one can be emptied directly,
+  // otherwise leave a tombstone to keep later probe sequences intact
+  uint16_t pos = entry->index_pos;
+  if (fib->index[(pos + 1) & FIB_INDEX_MASK(fib)] == NDN_FIB_INDEX_EMPTY) {
+    fib->index[pos] = NDN_FIB_INDEX_EMPTY;
+    pos = (pos - 1) & FIB_INDEX_MASK(fib);
+    while (fib->index[pos] == NDN_FIB_INDEX_TOMBSTONE) {
+      fib->index[pos] = NDN_FIB_INDEX_EMPTY;
+      fib->tombstones--;
+      pos = (pos - 1) & FIB_INDEX_MASK(fib);
+    }
+  }
+  else {
+    fib->index[pos] = NDN_FIB_INDEX_TOMBSTONE;
+    fib->tombstones++;
+    if (fib->tombstones > fib->index_size / 4) {
+      fib_index_rebuild(fib);
+    }
+  }
+}
@@ -11,47 +11,196 @@
 
 #include "../encode/interest.h"
 #include "face.h"
+#include "name-arena.h"
+#include "memory-pool.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * ndn_fib_nexthop is a class of next-hop records of a FIB entry.
+ */
+typedef struct ndn_fib_nexthop {
+  /**
+   * The face ID of the face to the next hop.
+   */
+  uint8_t face_id;
+
+  /**
+   * The cost to the next hop.
+   */
+  uint8_t cost;
+} ndn_fib_nexthop_t;
+
 /**
  * ndn_fib_entry is a class of FIB entries.
  */
 typedef struct ndn_fib_entry {
   /**
-   * The name prefix.
-   * A name with components_size < 0 indicates an empty entry.
+   * The name prefix, kept in the name arena of the FIB.
+   * NDN_NAME_REF_NULL indicates an empty entry.
    */
-  ndn_name_t name_prefix;
+  ndn_name_ref_t name_prefix;
 
   /**
-   * The next-hop record.
-   * @note Only one next-hop record per entry is allowed in NDN-Lite.
+   * The hash of the name_prefix, obtained from ndn_name_hash().
    */
-  ndn_face_intf_t* next_hop;
+  uint32_t name_hash;
 
   /**
-   * The cost to the next-hop.
+   * The position of this entry in the FIB hash index.
    */
-  uint8_t cost;
+  uint16_t index_pos;
+
+  /**
+   * The next-hop records, sorted by cost from the lowest.
+   */
+  ndn_fib_nexthop_t nexthops[NDN_FIB_MAX_NEXTHOPS];
+
+  /**
+   * The count of next-hop records.
+   */
+  uint8_t nexthop_size;
 } ndn_fib_entry_t;
 
 /**
  * The class of forwarding information base (FIB).
+ * Entries are located through an open addressing hash index keyed by the
+ * prefix hash. Longest prefix match probes the index once per prefix length
+ * that is present in the table, from the longest down, so a lookup costs
+ * O(name depth) regardless of the capacity.
+ * The entries, the index and the name arena are carved from a memory region given at init.
  */
-typedef ndn_fib_entry_t ndn_fib_t[NDN_FIB_MAX_SIZE];
+typedef struct ndn_fib {
+  /**
+   * The FIB entries, @p capacity of them.
+   */
+  ndn_fib_entry_t* slots;
+
+  /**
+   * The hash index with linear probing, @p index_size elements.
+   * Each element is NDN_FIB_INDEX_EMPTY, NDN_FIB_INDEX_TOMBSTONE, or
+   * the position of an entry in @p slots.
+   */
+  uint16_t* index;
+
+  /**
+   * Stack of unused positions in @p slots.
+   */
+  uint16_t* free_slots;
+
+  /**
+   * The number of entries.
+   */
+  uint16_t capacity;
+
+  /**
+   * The number of elements of @p index, a power of two.
+   */
+  uint16_t index_size;
+
+  /**
+   * The number of unused positions in @p free_slots.
+   */
+  uint16_t free_size;
+
+  /**
+   * The number of tombstones in @p index.
+   */
+  uint16_t tombstones;
+
+  /**
+   * The number of entries for each prefix length.
+   */
+  uint16_t prefix_length_cnt[NDN_NAME_COMPONENTS_SIZE + 1];
+
+  /**
+   * The name arena keeping the name prefixes.
+   */
+  ndn_name_arena_t names;
+} ndn_fib_t;
+
+#define NDN_FIB_INDEX_EMPTY ((uint16_t)(-1))
+#define NDN_FIB_INDEX_TOMBSTONE ((uint16_t)(-2))
+
+/**
+ * The bytes of memory region taken by a FIB: the entries, the hash index, the free slot
+ * stack and the name arena, each aligned to NDN_POOL_ALIGN.
+ */
+#define NDN_FIB_REGION_SIZE(capacity, index_size, name_arena_size) \
+  (NDN_POOL_ALIGN_UP(sizeof(ndn_fib_entry_t) * (size_t)(capacity)) \
+   + NDN_POOL_ALIGN_UP(sizeof(uint16_t) * (size_t)(index_size)) \
+   + NDN_POOL_ALIGN_UP(sizeof(uint16_t) * (size_t)(capacity)) \
+   + NDN_POOL_ALIGN_UP((size_t)(name_arena_size)))
+
+/**
+ * Init an empty FIB.
+ * @param fib. Output. The FIB to be inited.
+ * @param region. Input. The memory region the tables are carved from, aligned to
+ *                NDN_POOL_ALIGN and of NDN_FIB_REGION_SIZE() bytes. It must outlive the FIB.
+ * @param capacity. Input. The number of entries, less than NDN_FIB_INDEX_TOMBSTONE.
+ * @param index_size. Input. The slots of the hash index, a power of two and at least
+ *                    twice @p capacity.
+ * @param name_arena_size. Input. The bytes of the name arena, no more than 65534.
+ */
+void
+fib_table_init(ndn_fib_t* fib, uint8_t* region, uint16_t capacity, uint16_t index_size,
+               uint16_t name_arena_size);
+
+/**
+ * Find the FIB entry whose prefix is exactly @p name_prefix.
+ * @param fib. Input. The FIB.
+ * @param name_prefix. Input. The name prefix.
+ * @return the FIB entry. NULL if there is no such entry.
+ */
+ndn_fib_entry_t*
+fib_table_find_exact(ndn_fib_t* fib, const ndn_name_t* name_prefix);
+
+/**
+ * Find the FIB entry with the longest prefix matching @p name.
+ * @param fib. Input. The FIB.
+ * @param name. Input. The view of the name to be matched, e.g. an Interest name.
+ * @return the FIB entry. NULL if no entry matches.
+ */
+ndn_fib_entry_t*
+fib_table_lpm(ndn_fib_t* fib, const ndn_name_view_t* name);
+
+/**
+ * Insert an empty FIB entry for @p name_prefix.
+ * The caller should make sure there is no entry with the same prefix.
+ * @param fib. Input/Output. The FIB.
+ * @param name_prefix. Input. The name prefix.
+ * @return the FIB entry. NULL if the FIB or its name arena is full.
+ */
+ndn_fib_entry_t*
+fib_table_insert(ndn_fib_t* fib, const ndn_name_t* name_prefix);
+
+/**
+ * Add a next hop to a FIB entry, or update the cost of an existing one.
+ * @param entry. Input/Output. The FIB entry.
+ * @param face. Input. The face to the next hop.
+ * @param cost. Input. The cost to the next hop.
+ * @return 0 if there is no error.
+ */
+int
+fib_entry_add_nexthop(ndn_fib_entry_t* entry, ndn_face_intf_t* face, uint8_t cost);
+
+/**
+ * Remove a next hop from a FIB entry.
+ * @param entry. Input/Output. The FIB entry.
+ * @param face. Input. The face to the next hop.
+ */
+void
+fib_entry_remove_nexthop(ndn_fib_entry_t* entry, const ndn_face_intf_t* face);
 
 /**
  * Delete a FIB entry.
+ * @param fib. Input/Output. The FIB holding the entry.
  * @param entry. Input. The FIB entry.
  */
-static inline void
-fib_entry_delete(ndn_fib_entry_t* entry)
-{
-  entry->name_prefix.components_size = NDN_FWD_INVALID_NAME_SIZE;
-}
+void
+fib_entry_delete(ndn_fib_t* fib, ndn_fib_entry_t* entry);
 
 #ifdef __cplusplus
 }
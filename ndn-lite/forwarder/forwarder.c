@@ -7,99 +7,429 @@
  */
 
 #include "forwarder.h"
-#include "memory-pool.h"
 #include "../encode/name.h"
 #include "../encode/data.h"
+#include "../encode/nack.h"
+#include "../face/direct-face.h"
+#include "mgmt.h"
+#include "msg-queue.h"
+#include "memory-pool.h"
+#include "../util/logger.h"
 
-#include <stdio.h>
+// Large enough for a Nack of any Interest reassembled by the faces
+#define FORWARDER_NACK_BUFFER_SIZE (NDN_FRAG_BUFFER_MAX + 16)
 
-static ndn_forwarder_t instance;
+/************************************************************/
+/*  Definition of packet parsing helpers                    */
+/************************************************************/
 
-ndn_forwarder_t*
-ndn_forwarder_get_instance(void)
+// Move the decoder over the outer T and L and the Name of a packet
+static int
+forwarder_skip_name(ndn_decoder_t* decoder)
 {
-  return &instance;
+  uint32_t probe = 0;
+  int ret = decoder_get_type(decoder, &probe);
+  if (ret != 0) return ret;
+  ret = decoder_get_length(decoder, &probe);
+  if (ret != 0) return ret;
+  ret = decoder_get_type(decoder, &probe);
+  if (ret != 0) return ret;
+  if (probe != TLV_Name) return NDN_WRONG_TLV_TYPE;
+  ret = decoder_get_length(decoder, &probe);
+  if (ret != 0) return ret;
+  return decoder_move_forward(decoder, probe);
 }
 
+// Get the view of the Name of a wire format Interest or Data without copying it
 static int
-forwarder_multicast_strategy(ndn_face_intf_t* face, ndn_name_t* name,
-                             const uint8_t* raw_interest, uint32_t size,
-                             const ndn_pit_entry_t* pit_entry);
+forwarder_decode_name_view(const uint8_t* packet, uint32_t size, ndn_name_view_t* name)
+{
+  ndn_decoder_t decoder;
+  uint32_t probe = 0;
+  decoder_init(&decoder, packet, size);
+  int ret = decoder_get_type(&decoder, &probe);
+  if (ret != 0) return ret;
+  ret = decoder_get_length(&decoder, &probe);
+  if (ret != 0) return ret;
+  return ndn_name_view_tlv_decode(&decoder, name);
+}
+
+// The fields of a wire format Interest used by the forwarder
+typedef struct forwarder_interest_info {
+  bool can_be_prefix;
+  bool must_be_fresh;
+  // Whether the Interest has a Nonce. An Interest without one is not checked for loops.
+  bool has_nonce;
+  uint32_t nonce;
+  // The offset of the Nonce value in the wire format. 0 if absent.
+  uint32_t nonce_offset;
+  uint64_t lifetime;
+  // The offset of the HopLimit value in the wire format. 0 if absent.
+  uint32_t hop_limit_offset;
+  // The value of the ForwardingHint. NULL if absent.
+  const uint8_t* forwarding_hint;
+  uint32_t forwarding_hint_size;
+} forwarder_interest_info_t;
+
+// Get the selectors, Nonce, InterestLifetime, HopLimit and ForwardingHint of a wire format Interest
+static int
+forwarder_decode_interest_info(const uint8_t* raw_interest, uint32_t size,
+                               forwarder_interest_info_t* info)
+{
+  ndn_decoder_t decoder;
+  uint32_t type = 0;
+  uint32_t length = 0;
+  decoder_init(&decoder, raw_interest, size);
+  int ret = forwarder_skip_name(&decoder);
+  if (ret != 0) return ret;
+
+  info->can_be_prefix = false;
+  info->must_be_fresh = false;
+  info->has_nonce = false;
+  info->nonce = 0;
+  info->nonce_offset = 0;
+  info->lifetime = NDN_DEFAULT_INTEREST_LIFETIME;
+  info->hop_limit_offset = 0;
+  info->forwarding_hint = NULL;
+  info->forwarding_hint_size = 0;
+  while (decoder.offset < size) {
+    if (decoder_get_type(&decoder, &type) != 0 || decoder_get_length(&decoder, &length) != 0)
+      return NDN_WRONG_TLV_LENGTH;
+    if (type == TLV_CanBePrefix) {
+      info->can_be_prefix = true;
+    }
+    else if (type == TLV_MustBeFresh) {
+      info->must_be_fresh = true;
+    }
+    else if (type == TLV_Nonce && length == 4) {
+      info->has_nonce = true;
+      info->nonce_offset = decoder.offset;
+      ret = decoder_get_uint32_value(&decoder, &info->nonce);
+      if (ret != 0) return ret;
+      continue;
+    }
+    else if (type == TLV_InterestLifetime) {
+      ret = decoder_get_uint_value(&decoder, length, &info->lifetime);
+      if (ret != 0) return ret;
+      // a longer lifetime would overflow the expiry time
+      if (info->lifetime > NDN_MAX_INTEREST_LIFETIME) {
+        info->lifetime = NDN_MAX_INTEREST_LIFETIME;
+      }
+      continue;
+    }
+    else if (type == TLV_HopLimit && length == 1) {
+      info->hop_limit_offset = decoder.offset;
+    }
+    else if (type == TLV_ForwardingHint) {
+      info->forwarding_hint = raw_interest + decoder.offset;
+      info->forwarding_hint_size = length;
+    }
+    ret = decoder_move_forward(&decoder, length);
+    if (ret != 0) return ret;
+  }
+  return 0;
+}
+
+// Get the next delegation name of a ForwardingHint.
+// Both the Names of NDN packet format v0.3 and the older Delegations holding
+// a Preference and a Name are accepted, in the order they appear.
+static int
+forwarder_decode_next_delegation(ndn_decoder_t* decoder, ndn_name_view_t* name)
+{
+  uint32_t type = 0;
+  uint32_t length = 0;
+  while (decoder->offset < decoder->input_size) {
+    uint32_t start = decoder->offset;
+    if (decoder_get_type(decoder, &type) != 0 || decoder_get_length(decoder, &length) != 0)
+      return NDN_WRONG_TLV_LENGTH;
+    if (type == TLV_Name) {
+      decoder->offset = start;
+      return ndn_name_view_tlv_decode(decoder, name);
+    }
+    if (type == TLV_Delegation) {
+      uint32_t end = decoder->offset + length;
+      int ret = decoder_get_type(decoder, &type);
+      if (ret != 0) return ret;
+      ret = decoder_get_length(decoder, &length);
+      if (ret != 0) return ret;
+      ret = decoder_move_forward(decoder, length);
+      if (ret != 0) return ret;
+      ret = ndn_name_view_tlv_decode(decoder, name);
+      if (ret != 0) return ret;
+      decoder->offset = end;
+      return 0;
+    }
+    int ret = decoder_move_forward(decoder, length);
+    if (ret != 0) return ret;
+  }
+  return NDN_WRONG_TLV_TYPE;
+}
+
+// Get the FreshnessPeriod of a wire format Data. 0 if absent.
+static int
+forwarder_decode_data_freshness(const uint8_t* raw_data, uint32_t size,
+                                uint64_t* freshness_period)
+{
+  ndn_decoder_t decoder;
+  ndn_metainfo_t meta;
+  decoder_init(&decoder, raw_data, size);
+  int ret = forwarder_skip_name(&decoder);
+  if (ret != 0) return ret;
+  ret = ndn_metainfo_tlv_decode(&decoder, &meta);
+  if (ret != 0) return ret;
+  *freshness_period = meta.enable_FreshnessPeriod ? meta.freshness_period : 0;
+  return 0;
+}
 
 /************************************************************/
-/*  Definition of PIT table APIs                            */
+/*  Definition of buffer helpers                            */
 /************************************************************/
 
+// Allocate a buffer from the memory pool of the forwarder
+static void*
+forwarder_alloc(ndn_forwarder_t* self, size_t size)
+{
+  return self->pool != NULL ? memory_pool_alloc(self->pool, size) : ndn_memory_pool_alloc(size);
+}
+
+// Free a buffer allocated by forwarder_alloc()
 static void
-pit_table_init(void)
+forwarder_free(ndn_forwarder_t* self, void* ptr)
 {
-  for (uint8_t i = 0; i < NDN_PIT_MAX_SIZE; i++) {
-    instance.pit[i].interest_name.components_size = NDN_FWD_INVALID_NAME_SIZE;
+  if (self->pool != NULL) {
+    memory_pool_free(self->pool, ptr);
+  }
+  else {
+    ndn_memory_pool_free(ptr);
   }
 }
 
-static ndn_pit_entry_t*
-pit_table_find_or_insert(ndn_name_t* name)
+/************************************************************/
+/*  Definition of Nack helpers                              */
+/************************************************************/
+
+// Send a Nack of an Interest back to a downstream face
+static int
+forwarder_send_nack(ndn_forwarder_t* self, ndn_face_intf_t* face, uint8_t reason,
+                    const uint8_t* raw_interest, uint32_t size)
 {
-  // Find
-  for (uint8_t i = 0; i < NDN_PIT_MAX_SIZE; i++) {
-    if (ndn_name_compare(&instance.pit[i].interest_name, name) == 0) {
-      return &instance.pit[i];
+  uint8_t* nack = forwarder_alloc(self, FORWARDER_NACK_BUFFER_SIZE);
+  if (nack == NULL) {
+    return NDN_FWD_NO_MEM;
+  }
+  ndn_encoder_t encoder;
+  encoder_init(&encoder, nack, FORWARDER_NACK_BUFFER_SIZE);
+  int ret = ndn_nack_tlv_encode(&encoder, reason, raw_interest, size);
+  if (ret == 0) {
+    ret = ndn_face_send(face, NULL, nack, encoder.offset);
+  }
+  forwarder_free(self, nack);
+  return ret;
+}
+
+/************************************************************/
+/*  Definition of PIT expiry                                */
+/************************************************************/
+
+// Encode a minimal Interest (Name, Nonce, InterestLifetime) of a PIT entry
+static int
+forwarder_encode_pit_interest(const ndn_pit_t* pit, const ndn_pit_entry_t* entry,
+                              uint64_t lifetime, ndn_encoder_t* encoder)
+{
+  ndn_name_view_t name;
+  name_arena_get_view(&pit->names, entry->interest_name, &name);
+  uint32_t name_size = name.offsets[name.components_size];
+  uint32_t value_size = encoder_probe_block_size(TLV_Name, name_size);
+  value_size += encoder_probe_block_size(TLV_Nonce, 4);
+  value_size += encoder_probe_block_size(TLV_InterestLifetime, encoder_probe_uint_length(lifetime));
+  int ret = encoder_append_type(encoder, TLV_Interest);
+  if (ret != 0) return ret;
+  ret = encoder_append_length(encoder, value_size);
+  if (ret != 0) return ret;
+  encoder_append_type(encoder, TLV_Name);
+  encoder_append_length(encoder, name_size);
+  ret = encoder_append_raw_buffer_value(encoder, name.value, name_size);
+  if (ret != 0) return ret;
+  encoder_append_type(encoder, TLV_Nonce);
+  encoder_append_length(encoder, 4);
+  encoder_append_uint32_value(encoder, entry->nonce);
+  encoder_append_type(encoder, TLV_InterestLifetime);
+  encoder_append_length(encoder, encoder_probe_uint_length(lifetime));
+  return encoder_append_uint_value(encoder, lifetime);
+}
+
+// Delete a PIT entry, and cancel its expiry event, which would take a scheduler slot
+// until the InterestLifetime is over
+static void
+forwarder_pit_entry_delete(ndn_forwarder_t* self, ndn_pit_entry_t* entry)
+{
+  ndn_scheduler_cancel(&self->scheduler, entry->expiry_event);
+  pit_entry_delete(&self->pit, entry);
+}
+
+// Delete a route, and cancel its expiry event
+static void
+forwarder_rib_route_delete(ndn_forwarder_t* self, ndn_rib_route_t* route)
+{
+  ndn_scheduler_cancel(&self->scheduler, route->expiry_event);
+  rib_route_delete(&self->rib, route);
+}
+
+// Remove a PIT entry that has been satisfied or expired.
+// Its nonces go to the DNL, so that the Interests looping back later are still detected.
+static void
+forwarder_pit_entry_retire(ndn_forwarder_t* self, ndn_pit_entry_t* entry)
+{
+  for (uint8_t i = 0; i < entry->in_record_size; i++) {
+    if (entry->in_records[i].has_nonce) {
+      dnl_table_insert(&self->dnl, entry->name_hash, entry->in_records[i].nonce);
     }
   }
+  forwarder_pit_entry_delete(self, entry);
+}
 
-  // Insert
-  for (uint8_t i = 0; i < NDN_PIT_MAX_SIZE; i++) {
-    if (instance.pit[i].interest_name.components_size == NDN_FWD_INVALID_NAME_SIZE) {
-      instance.pit[i].interest_name = *name;
-      instance.pit[i].incoming_face_size = 0;
-      return &instance.pit[i];
+// Encode the Interest of a PIT entry in a buffer of NDN_FORWARDER_TIMEOUT_INTEREST_SIZE bytes,
+// retire the entry, and pass the Interest to the timeout callbacks of the app faces
+static void
+forwarder_pit_entry_notify(ndn_forwarder_t* self, ndn_pit_entry_t* entry,
+                           ndn_face_intf_t* const* app_faces, uint8_t app_face_size,
+                           uint8_t* interest)
+{
+  ndn_encoder_t encoder;
+  encoder_init(&encoder, interest, NDN_FORWARDER_TIMEOUT_INTEREST_SIZE);
+  int ret = forwarder_encode_pit_interest(&self->pit, entry, entry->lifetime, &encoder);
+  forwarder_pit_entry_retire(self, entry);
+  if (ret == 0) {
+    for (uint8_t i = 0; i < app_face_size; i++) {
+      ndn_direct_face_on_interest_timeout(app_faces[i], interest, encoder.offset);
     }
   }
-  return NULL;
 }
 
-/************************************************************/
-/*  Definition of FIB table APIs                            */
-/************************************************************/
+// Notify the app faces of a PIT entry dropped by a timeout callback, e.g., evicted by the
+// Interest it expresses, while the buffer of the forwarder is in use.
+// The buffer is on the stack of this function only, which the other drops never enter.
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+static void
+forwarder_pit_entry_notify_nested(ndn_forwarder_t* self, ndn_pit_entry_t* entry,
+                                  ndn_face_intf_t* const* app_faces, uint8_t app_face_size)
+{
+  uint8_t interest[NDN_FORWARDER_TIMEOUT_INTEREST_SIZE];
+  forwarder_pit_entry_notify(self, entry, app_faces, app_face_size, interest);
+}
 
+// Remove an unsatisfied PIT entry and notify the app faces waiting on it.
+// The entry is deleted before any callback, since the app may express the Interest again.
 static void
-fib_table_init(void)
+forwarder_pit_entry_drop(ndn_forwarder_t* self, ndn_pit_entry_t* entry)
 {
-  for (uint8_t i = 0; i < NDN_FIB_MAX_SIZE; i++) {
-    instance.fib[i].name_prefix.components_size = NDN_FWD_INVALID_NAME_SIZE;
+  ndn_face_intf_t* app_faces[NDN_PIT_MAX_IN_RECORDS];
+  uint8_t app_face_size = 0;
+  for (uint8_t i = 0; i < entry->in_record_size; i++) {
+    ndn_face_intf_t* face = face_table_get(&self->face_table, entry->in_records[i].face_id);
+    if (face->type == NDN_FACE_TYPE_APP) {
+      app_faces[app_face_size++] = face;
+    }
+  }
+  self->counters.n_unsatisfied_interests++;
+  if (app_face_size == 0) {
+    forwarder_pit_entry_retire(self, entry);
+    return;
+  }
+
+  if (!self->timeout_interest_busy) {
+    self->timeout_interest_busy = true;
+    forwarder_pit_entry_notify(self, entry, app_faces, app_face_size, self->timeout_interest);
+    self->timeout_interest_busy = false;
+  }
+  else {
+    forwarder_pit_entry_notify_nested(self, entry, app_faces, app_face_size);
   }
 }
 
-static ndn_fib_entry_t*
-fib_table_find(const ndn_name_t* name)
+// Remove an expired PIT entry
+static void
+forwarder_pit_entry_expire(ndn_forwarder_t* self, ndn_pit_entry_t* entry)
 {
-    int bestL = 0;
-    int bestI = -1;
-  for (uint8_t i = 0; i < NDN_FIB_MAX_SIZE; i++) {
-    if (ndn_name_is_prefix_of(&instance.fib[i].name_prefix, name) == 0) {
-	if(bestI == -1 || &instance.fib[i].name_prefix.components_size > bestL) {
-	    bestL = &instance.fib[i].name_prefix.components_size;
-	    bestI = i;
-	}
+  if (entry->strategy->on_interest_timeout != NULL) {
+    entry->strategy->on_interest_timeout(self, entry, self->now);
+  }
+  forwarder_pit_entry_drop(self, entry);
+}
+
+// Remove a PIT entry to make room for a new one.
+// An entry already due is expired as usual; otherwise it is evicted without
+// involving the strategy, since its upstreams have not timed out.
+static void
+forwarder_pit_entry_evict(ndn_forwarder_t* self, ndn_pit_entry_t* entry)
+{
+  if (entry->expire_time < self->now) {
+    forwarder_pit_entry_expire(self, entry);
+    return;
+  }
+  self->counters.n_pit_evictions++;
+  forwarder_pit_entry_drop(self, entry);
+}
+
+// Insert a PIT entry, evicting the entries closest to expiry while the PIT is full.
+// The name must fit in the empty name arena, so that the new entry fits before the PIT
+// is emptied. The evictions are bounded by the capacity all the same.
+static ndn_pit_entry_t*
+forwarder_pit_insert(ndn_forwarder_t* self, const ndn_name_view_t* name, uint32_t name_hash)
+{
+  ndn_pit_entry_t* entry = pit_table_find_or_insert(&self->pit, name, name_hash);
+  for (uint16_t i = 0; entry == NULL && i < self->pit.capacity; i++) {
+    ndn_pit_entry_t* victim = pit_table_first_to_expire(&self->pit);
+    if (victim == NULL) {
+      return NULL;
     }
+    forwarder_pit_entry_evict(self, victim);
+    entry = pit_table_find_or_insert(&self->pit, name, name_hash);
   }
+  return entry;
+}
 
-  if (bestI == -1) return NULL;
-  return &instance.fib[bestI];
+// Find the FIB entry to forward an Interest by.
+// The Interest name is matched first. A router without a route to it, e.g., to a mobile
+// producer, falls back to the delegations of the ForwardingHint, in order.
+static ndn_fib_entry_t*
+forwarder_fib_lookup(ndn_forwarder_t* self, const ndn_name_view_t* name,
+                     const forwarder_interest_info_t* info)
+{
+  ndn_fib_entry_t* fib_entry = fib_table_lpm(&self->fib, name);
+  if (fib_entry != NULL || info->forwarding_hint == NULL) {
+    return fib_entry;
+  }
+  ndn_decoder_t decoder;
+  ndn_name_view_t delegation;
+  decoder_init(&decoder, info->forwarding_hint, info->forwarding_hint_size);
+  while (forwarder_decode_next_delegation(&decoder, &delegation) == 0) {
+    fib_entry = fib_table_lpm(&self->fib, &delegation);
+    if (fib_entry != NULL) {
+      self->counters.n_forwarding_hint_lookups++;
+      return fib_entry;
+    }
+  }
+  return NULL;
 }
 
-// static ndn_fib_entry_t*
-// fib_table_find_by_face(const ndn_face_intf_t* face)
-// {
-//   for (uint8_t i = 0; i < NDN_FIB_MAX_SIZE; i++) {
-//     if (instance.fib[i].name_prefix.components_size != NDN_FWD_INVALID_NAME_SIZE
-//         && instance.fib[i].next_hop == face) {
-//       return &instance.fib[i];
-//     }
-//   }
-//   return NULL;
-// }
+// Scheduler callback of a PIT entry's expiry.
+// The entry may have been satisfied, extended or reused since the event was posted,
+// so only an entry that is still due is removed.
+static void
+forwarder_pit_expiry_event(void* self, uint32_t iparam, void* pparam)
+{
+  (void)iparam;
+  ndn_forwarder_t* forwarder = (ndn_forwarder_t*)self;
+  ndn_pit_entry_t* entry = (ndn_pit_entry_t*)pparam;
+  if (entry->interest_name == NDN_NAME_REF_NULL
+      || entry->expire_time > forwarder->now) {
+    return;
+  }
+  forwarder_pit_entry_expire(forwarder, entry);
+}
 
 /************************************************************/
 /*  Definition of forwarder APIs                            */
@@ -107,179 +437,773 @@ fib_table_find(const ndn_name_t* name)
 
 // Send data packet out
 static int
-ndn_forwarder_on_outgoing_data(ndn_face_intf_t* face, const ndn_name_t* name,
-                               const uint8_t* raw_data, uint32_t size)
+ndn_forwarder_on_outgoing_data(ndn_face_intf_t* face, ndn_pktbuf_t* data)
 {
-  return ndn_face_send(face, name, raw_data, size);
+  return ndn_face_send_pktbuf(face, NULL, data);
 }
 
-// Send interest packet out
-static int
-ndn_forwarder_on_outgoing_interest(ndn_face_intf_t* face, const ndn_name_t* name,
-                                   const uint8_t* raw_interest, uint32_t size)
+void
+forwarder_config_init(ndn_forwarder_config_t* config)
 {
-  return ndn_face_send(face, name, raw_interest, size);
+  config->pit_size = NDN_PIT_MAX_SIZE;
+  config->pit_index_size = NDN_PIT_INDEX_SIZE;
+  config->pit_name_arena_size = NDN_PIT_NAME_ARENA_SIZE;
+  config->fib_size = NDN_FIB_MAX_SIZE;
+  config->fib_index_size = NDN_FIB_INDEX_SIZE;
+  config->fib_name_arena_size = NDN_FIB_NAME_ARENA_SIZE;
+  config->rib_size = NDN_RIB_MAX_SIZE;
+  config->rib_name_arena_size = NDN_RIB_NAME_ARENA_SIZE;
+  config->cs_size = NDN_CS_MAX_SIZE;
+  config->direct_face_cb_size = NDN_DIRECT_FACE_CB_ENTRY_SIZE;
+  config->direct_face_name_arena_size = NDN_DIRECT_FACE_NAME_ARENA_SIZE;
+  config->random_seed = NDN_STRATEGY_DEFAULT_SEED;
 }
 
-ndn_forwarder_t*
-ndn_forwarder_init(void)
+// Whether a name arena can be kept in @p size bytes
+static bool
+forwarder_check_name_arena_size(uint16_t size)
 {
-  pit_table_init();
-  fib_table_init();
-  return &instance;
+  return size > 0 && size <= 65534;
+}
+
+// Whether a table of @p size entries can be indexed by @p index_size slots
+static bool
+forwarder_check_index_size(uint16_t size, uint16_t index_size)
+{
+  return size > 0 && (index_size & (index_size - 1)) == 0 && index_size / 2 >= size;
 }
 
 int
-ndn_forwarder_fib_insert(const ndn_name_t* name_prefix,
-                         ndn_face_intf_t* face, uint8_t cost)
+forwarder_get_layout(const ndn_forwarder_config_t* config, ndn_forwarder_layout_t* layout)
 {
-  // already exists
-  for (uint8_t i = 0; i < NDN_FIB_MAX_SIZE; i++) {
-    if (ndn_name_compare(&instance.fib[i].name_prefix, name_prefix) == 0
-        && instance.fib[i].next_hop == face) {
-      if (face->state != NDN_FACE_STATE_UP)
-        ndn_face_up(face);
-      return 0;
-    }
+  if (!forwarder_check_index_size(config->pit_size, config->pit_index_size)
+      || !forwarder_check_name_arena_size(config->pit_name_arena_size)
+      || !forwarder_check_index_size(config->fib_size, config->fib_index_size)
+      || !forwarder_check_name_arena_size(config->fib_name_arena_size)
+      || config->rib_size == 0
+      || !forwarder_check_name_arena_size(config->rib_name_arena_size)
+      || config->cs_size == 0
+      || NDN_FORWARDER_SCHEDULER_SIZE(config->pit_size, config->rib_size) > NDN_SCHEDULER_MAX_SIZE
+      || config->direct_face_cb_size == 0
+      || !forwarder_check_name_arena_size(config->direct_face_name_arena_size)) {
+    return NDN_OVERSIZE;
   }
+  layout->pit = NDN_PIT_REGION_SIZE(config->pit_size, config->pit_index_size,
+                                    config->pit_name_arena_size);
+  layout->fib = NDN_FIB_REGION_SIZE(config->fib_size, config->fib_index_size,
+                                    config->fib_name_arena_size);
+  layout->rib = NDN_RIB_REGION_SIZE(config->rib_size, config->rib_name_arena_size);
+  layout->cs = NDN_CS_REGION_SIZE(config->cs_size);
+  layout->scheduler = NDN_SCHEDULER_REGION_SIZE(NDN_FORWARDER_SCHEDULER_SIZE(config->pit_size,
+                                                                            config->rib_size));
+  layout->direct_face = NDN_DIRECT_FACE_REGION_SIZE(config->direct_face_cb_size,
+                                                    config->direct_face_name_arena_size);
+  layout->total = NDN_POOL_ALIGN + layout->pit + layout->fib + layout->rib + layout->cs
+                  + layout->scheduler + layout->direct_face;
+  return 0;
+}
 
-  // find an unused fib entry
-  for (uint8_t i = 0; i < NDN_FIB_MAX_SIZE; i++) {
-    if (instance.fib[i].name_prefix.components_size == NDN_FWD_INVALID_NAME_SIZE) {
-      instance.fib[i].name_prefix = *name_prefix;
-      instance.fib[i].next_hop = face;
-      instance.fib[i].cost = cost;
-      ndn_face_up(face);
+int
+forwarder_init(ndn_forwarder_t* self, const ndn_forwarder_config_t* config,
+               uint8_t* region, size_t region_size)
+{
+  if (config != NULL) {
+    self->config = *config;
+  }
+  else {
+    forwarder_config_init(&self->config);
+  }
+  int ret = forwarder_get_layout(&self->config, &self->layout);
+  if (ret != 0) {
+    return ret;
+  }
+  if (self->layout.total > region_size) {
+    return NDN_OVERSIZE;
+  }
 
-      printf("Forwarder: successfully insert FIB\n");
+  // carve the tables from the region, one after another
+  uint8_t* cursor = region + (NDN_POOL_ALIGN - (uintptr_t)region % NDN_POOL_ALIGN) % NDN_POOL_ALIGN;
+  pit_table_init(&self->pit, cursor, self->config.pit_size, self->config.pit_index_size,
+                 self->config.pit_name_arena_size);
+  cursor += self->layout.pit;
+  fib_table_init(&self->fib, cursor, self->config.fib_size, self->config.fib_index_size,
+                 self->config.fib_name_arena_size);
+  cursor += self->layout.fib;
+  rib_table_init(&self->rib, cursor, self->config.rib_size, self->config.rib_name_arena_size);
+  cursor += self->layout.rib;
+  cs_table_init(&self->cs, cursor, self->config.cs_size);
+  cursor += self->layout.cs;
+  ndn_scheduler_init(&self->scheduler, cursor,
+                     NDN_FORWARDER_SCHEDULER_SIZE(self->config.pit_size, self->config.rib_size));
+  cursor += self->layout.scheduler;
+  self->direct_face_region = cursor;
 
-      return 0;
+  face_table_init(&self->face_table);
+  dnl_table_init(&self->dnl);
+  strategy_choice_init(&self->strategy_choice);
+  strategy_init(&self->measurements, self->config.random_seed);
+  ndn_msgqueue_init(&self->msgqueue);
+  self->pool = NULL;
+  memset(&self->counters, 0, sizeof(self->counters));
+  memset(&self->mgmt_keys, 0, sizeof(self->mgmt_keys));
+  self->timeout_interest_busy = false;
+  self->now = 0;
+  return 0;
+}
+
+void
+forwarder_process(ndn_forwarder_t* self, timetick_t now)
+{
+  self->now = now;
+  // the packets may post events after a delay
+  ndn_scheduler_set_time(&self->scheduler, now);
+  for (int i = 0; i < NDN_FORWARDER_RX_BATCH_SIZE; i++) {
+    if (!ndn_msgqueue_dispatch(&self->msgqueue)) {
+      break;
     }
   }
-  return NDN_FWD_FIB_FULL;
+  ndn_scheduler_process(&self->scheduler, now);
+}
+
+bool
+forwarder_get_next_deadline(ndn_forwarder_t* self, timetick_t* deadline)
+{
+  if (!ndn_msgqueue_empty(&self->msgqueue)) {
+    *deadline = self->now;
+    return true;
+  }
+  return ndn_scheduler_next_deadline(&self->scheduler, deadline);
 }
 
 int
-ndn_forwarder_on_incoming_data(ndn_forwarder_t* self, ndn_face_intf_t* face, ndn_name_t *name,
-                               const uint8_t* raw_data, uint32_t size)
+forwarder_add_face(ndn_forwarder_t* self, ndn_face_intf_t* face)
 {
-  (void)face;
-  bool bypass = (name != NULL);
+  // the face ID only has a meaning in the face table of its own forwarder
+  if (face->forwarder != NULL && face->forwarder != self
+      && face_table_contains(&face->forwarder->face_table, face)) {
+    return NDN_FWD_FACE_IN_OTHER_FORWARDER;
+  }
+  int ret = face_table_add(&self->face_table, face);
+  if (ret != 0) {
+    return ret;
+  }
+  face->forwarder = self;
+  return 0;
+}
 
-  // If no bypass data, we need to decode it manually
-  if (!bypass) {
-    // Allocate memory
-    name = (ndn_name_t*)ndn_memory_pool_alloc();
-    if (!name) {
-      return NDN_FWD_NO_MEM;
+void
+forwarder_remove_face(ndn_forwarder_t* self, ndn_face_intf_t* face)
+{
+  if (!face_table_contains(&self->face_table, face)) {
+    return;
+  }
+  // Tables are purged before the face ID is released, since it may be reused at once
+  for (uint16_t i = 0; i < self->rib.capacity; i++) {
+    ndn_rib_route_t* route = &self->rib.routes[i];
+    if (route->name_prefix != NDN_NAME_REF_NULL && route->face_id == face->face_id) {
+      forwarder_rib_route_delete(self, route);
+    }
+  }
+  for (uint16_t i = 0; i < self->fib.capacity; i++) {
+    ndn_fib_entry_t* entry = &self->fib.slots[i];
+    if (entry->name_prefix == NDN_NAME_REF_NULL) {
+      continue;
+    }
+    fib_entry_remove_nexthop(entry, face);
+    if (entry->nexthop_size == 0) {
+      fib_entry_delete(&self->fib, entry);
+    }
+  }
+  for (uint16_t i = 0; i < self->pit.capacity; i++) {
+    ndn_pit_entry_t* entry = &self->pit.slots[i];
+    if (entry->interest_name == NDN_NAME_REF_NULL) {
+      continue;
+    }
+    pit_entry_remove_out_record(entry, face);
+    if (pit_entry_remove_in_record(&self->pit, entry, face) && entry->in_record_size == 0) {
+      forwarder_pit_entry_delete(self, entry);
     }
-    // Decode name only
-    ndn_decoder_t decoder;
-    uint32_t probe = 0;
-    int ret = 0;
-    decoder_init(&decoder, raw_data, size);
-    ret = decoder_get_type(&decoder, &probe);
-    ret = decoder_get_length(&decoder, &probe);
-    ret = ndn_name_tlv_decode(&decoder, name);
-    if (ret < 0) {
-      ndn_memory_pool_free(name);
-      return ret;
+  }
+  strategy_remove_face(&self->measurements, face);
+  face_table_remove(&self->face_table, face);
+  face->forwarder = NULL;
+}
+
+int
+forwarder_fib_insert(ndn_forwarder_t* self, const ndn_name_t* name_prefix,
+                     ndn_face_intf_t* face, uint8_t cost)
+{
+  int ret = forwarder_add_face(self, face);
+  if (ret != 0) {
+    return ret;
+  }
+  ndn_fib_entry_t* entry = fib_table_find_exact(&self->fib, name_prefix);
+  if (entry == NULL) {
+    entry = fib_table_insert(&self->fib, name_prefix);
+    if (entry == NULL) {
+      return NDN_FWD_FIB_FULL;
     }
   }
+  ret = fib_entry_add_nexthop(entry, face, cost);
+  if (ret != 0) {
+    if (entry->nexthop_size == 0) {
+      fib_entry_delete(&self->fib, entry);
+    }
+    return ret;
+  }
+  if (face->state != NDN_FACE_STATE_UP)
+    ndn_face_up(face);
 
-  // Match with pit
-  for (uint8_t i = 0; i < NDN_PIT_MAX_SIZE; i++) {
-    if (ndn_name_compare(&self->pit[i].interest_name, name) == 0) {
-      // Send out data
-      for (uint8_t j = 0; j < self->pit[i].incoming_face_size; j++) {
-        ndn_forwarder_on_outgoing_data(self->pit[i].incoming_face[j], name, raw_data, size);
+  NDN_LOG_INFO(FORWARDER_FIB_INSERT, face->face_id, cost);
+
+  return 0;
+}
+
+bool
+forwarder_fib_remove(ndn_forwarder_t* self, const ndn_name_t* name_prefix,
+                     const ndn_face_intf_t* face)
+{
+  ndn_fib_entry_t* entry = fib_table_find_exact(&self->fib, name_prefix);
+  if (entry == NULL) {
+    return false;
+  }
+  uint8_t nexthop_size = entry->nexthop_size;
+  fib_entry_remove_nexthop(entry, face);
+  if (entry->nexthop_size == nexthop_size) {
+    return false;
+  }
+  if (entry->nexthop_size == 0) {
+    fib_entry_delete(&self->fib, entry);
+  }
+  return true;
+}
+
+// Reflect the routes of a name prefix and a face into the FIB next hop of them
+static int
+forwarder_rib_update_fib(ndn_forwarder_t* self, const ndn_name_t* name_prefix,
+                         ndn_face_intf_t* face)
+{
+  uint8_t cost = 0;
+  if (rib_table_lowest_cost(&self->rib, name_prefix, face->face_id, &cost)) {
+    return forwarder_fib_insert(self, name_prefix, face, cost);
+  }
+  forwarder_fib_remove(self, name_prefix, face);
+  return 0;
+}
+
+// Scheduler callback of a route's expiry.
+// The route may have been renewed or deleted since the event was posted,
+// so only a route that is still due is removed.
+static void
+forwarder_rib_expiry_event(void* self, uint32_t iparam, void* pparam)
+{
+  ndn_forwarder_t* forwarder = (ndn_forwarder_t*)self;
+  ndn_rib_route_t* route = (ndn_rib_route_t*)pparam;
+  (void)iparam;
+  if (route->name_prefix == NDN_NAME_REF_NULL || route->expire_time > forwarder->now) {
+    return;
+  }
+  ndn_face_intf_t* face = face_table_get(&forwarder->face_table, route->face_id);
+  ndn_name_view_t view;
+  ndn_name_t name_prefix;
+  name_arena_get_view(&forwarder->rib.names, route->name_prefix, &view);
+  int ret = ndn_name_from_view(&name_prefix, &view);
+  forwarder_rib_route_delete(forwarder, route);
+  if (ret == 0 && face != NULL) {
+    forwarder_rib_update_fib(forwarder, &name_prefix, face);
+  }
+}
+
+int
+forwarder_rib_register(ndn_forwarder_t* self, const ndn_name_t* name_prefix,
+                       ndn_face_intf_t* face, uint16_t origin, uint8_t cost, uint64_t lifetime)
+{
+  int ret = forwarder_add_face(self, face);
+  if (ret != 0) {
+    return ret;
+  }
+  if (lifetime != NDN_RIB_NEVER_EXPIRE && lifetime > NDN_RIB_MAX_EXPIRATION_PERIOD) {
+    // a longer lifetime would overflow the expiry time
+    lifetime = NDN_RIB_MAX_EXPIRATION_PERIOD;
+  }
+  ndn_rib_route_t* route = rib_table_find(&self->rib, name_prefix, face->face_id, origin);
+  bool is_new = (route == NULL);
+  if (is_new) {
+    route = rib_table_insert(&self->rib, name_prefix, face->face_id, origin);
+    if (route == NULL) {
+      return NDN_FWD_RIB_FULL;
+    }
+  }
+  // The new timer is posted before the old one is cancelled, so that a route keeps its
+  // old timer if the scheduler is full
+  ndn_event_handle_t expiry_event = NDN_EVENT_HANDLE_NONE;
+  timetick_t expire_time = NDN_RIB_NEVER_EXPIRE;
+  if (lifetime != NDN_RIB_NEVER_EXPIRE) {
+    expire_time = self->now + lifetime;
+    expiry_event = ndn_scheduler_post(&self->scheduler, expire_time, self,
+                                      forwarder_rib_expiry_event, 0, route);
+    if (expiry_event == NDN_EVENT_HANDLE_NONE) {
+      if (is_new) {
+        forwarder_rib_route_delete(self, route);
       }
-      // Delete PIT Entry
-      pit_entry_delete(&self->pit[i]);
-      break;
+      return NDN_FWD_SCHEDULER_FULL;
     }
   }
+  ndn_scheduler_cancel(&self->scheduler, route->expiry_event);
+  route->cost = cost;
+  route->expire_time = expire_time;
+  route->expiry_event = expiry_event;
+  ret = forwarder_rib_update_fib(self, name_prefix, face);
+  if (ret != 0 && is_new) {
+    // The FIB is full, so the route would never be used
+    forwarder_rib_route_delete(self, route);
+  }
+  return ret;
+}
 
-  // Free memory
-  if (!bypass) {
-    ndn_memory_pool_free(name);
+bool
+forwarder_rib_unregister(ndn_forwarder_t* self, const ndn_name_t* name_prefix,
+                         ndn_face_intf_t* face, uint16_t origin)
+{
+  ndn_rib_route_t* route = rib_table_find(&self->rib, name_prefix, face->face_id, origin);
+  if (route == NULL) {
+    return false;
+  }
+  forwarder_rib_route_delete(self, route);
+  forwarder_rib_update_fib(self, name_prefix, face);
+  return true;
+}
+
+int
+forwarder_set_strategy(ndn_forwarder_t* self, const ndn_name_t* name_prefix,
+                       const ndn_strategy_t* strategy)
+{
+  return strategy_choice_set(&self->strategy_choice, name_prefix, strategy);
+}
+
+// Receive a Data, which is in @p data, or only in @p raw_data if @p data is NULL.
+// A solicited Data is shared by the CS and the downstream faces through one packet buffer,
+// into which it is copied if it did not arrive in one.
+static int
+forwarder_on_incoming_data(ndn_forwarder_t* self, ndn_face_intf_t* face,
+                           const uint8_t* raw_data, uint32_t size, ndn_pktbuf_t* data)
+{
+  ndn_name_view_t name;
+  int ret = forwarder_decode_name_view(raw_data, size, &name);
+  if (ret != 0) {
+    return ret;
+  }
+
+  // Match with pit
+  uint32_t name_hash = ndn_name_view_hash(&name);
+  ndn_pit_entry_t* pit_entry = pit_table_find(&self->pit, &name, name_hash);
+  if (pit_entry == NULL) {
+    self->counters.n_unsolicited_data++;
+    return 0;
   }
 
+  if (data != NULL) {
+    pktbuf_retain(data);
+  }
+  else {
+    // Without memory for the copy, the Data is forwarded from the face's buffer and not cached
+    data = pktbuf_from_packet(self->pool, raw_data, size);
+    if (data != NULL) {
+      name.value = data->data + (name.value - raw_data);
+    }
+  }
+  // Cache solicited data only
+  uint64_t freshness_period = 0;
+  if (data != NULL && forwarder_decode_data_freshness(raw_data, size, &freshness_period) == 0) {
+    cs_table_insert(&self->cs, &name, name_hash, data, freshness_period, self->now);
+  }
+  if (pit_entry->strategy->before_satisfy_interest != NULL) {
+    pit_entry->strategy->before_satisfy_interest(self, pit_entry, face, self->now);
+  }
+  // Send out data, skipping the downstreams whose Interests have expired
+  for (uint8_t j = 0; j < pit_entry->in_record_size; j++) {
+    const ndn_pit_in_record_t* in_record = &pit_entry->in_records[j];
+    if (in_record->expire_time < self->now) {
+      continue;
+    }
+    ndn_face_intf_t* downstream = face_table_get(&self->face_table, in_record->face_id);
+    if (data != NULL) {
+      ndn_forwarder_on_outgoing_data(downstream, data);
+    }
+    else {
+      ndn_face_send(downstream, NULL, raw_data, size);
+    }
+  }
+  if (data != NULL) {
+    pktbuf_release(data);
+  }
+  // Delete PIT Entry
+  forwarder_pit_entry_retire(self, pit_entry);
+  self->counters.n_satisfied_interests++;
   return 0;
 }
 
 int
-ndn_forwarder_on_incoming_interest(ndn_forwarder_t* self, ndn_face_intf_t* face, ndn_name_t* name,
+ndn_forwarder_on_incoming_data(ndn_forwarder_t* self, ndn_face_intf_t* face,
+                               const uint8_t* raw_data, uint32_t size)
+{
+  return forwarder_on_incoming_data(self, face, raw_data, size, NULL);
+}
+
+int
+ndn_forwarder_on_incoming_data_pktbuf(ndn_forwarder_t* self, ndn_face_intf_t* face,
+                                      ndn_pktbuf_t* packet)
+{
+  return forwarder_on_incoming_data(self, face, packet->data, packet->size, packet);
+}
+
+int
+ndn_forwarder_on_incoming_interest(ndn_forwarder_t* self, ndn_face_intf_t* face,
                                    const uint8_t* raw_interest, uint32_t size)
 {
-  printf("Forwarder: on Interest\n");
+  NDN_LOG_DEBUG(FORWARDER_ON_INTEREST, face->face_id, size);
 
-  (void)self;
-  int ret = 0;
-  bool bypass = (name != NULL);
+  // The name is only viewed in the wire format, and copied when a PIT entry is created
+  ndn_name_view_t name;
+  int ret = forwarder_decode_name_view(raw_interest, size, &name);
+  if (ret != 0) {
+    return ret;
+  }
 
-  // If no bypass interest, we need to decode it manually
-  if (!bypass) {
-    // Allocate memory
-    // A name is expensive, don't want to do it on stack
-    name = (ndn_name_t*)ndn_memory_pool_alloc();
-    if (!name) {
-      return NDN_FWD_NO_MEM;
+  // Requests to the management prefix are answered by the forwarder itself
+  if (ndn_mgmt_is_local_request(face, &name)) {
+    ret = ndn_mgmt_on_interest(self, face, &name, raw_interest, size);
+    if (ret != 0) {
+      forwarder_send_nack(self, face, NDN_NACK_REASON_NO_ROUTE, raw_interest, size);
     }
+    return ret;
+  }
 
-    // Decode name only
-    uint32_t probe = 0;
-    ndn_decoder_t decoder;
-    decoder_init(&decoder, raw_interest, size);
-    ret = decoder_get_type(&decoder, &probe);
-    ret = decoder_get_length(&decoder, &probe);
-    ret = ndn_name_tlv_decode(&decoder, name);
-    if (ret != 0) {
-      ndn_memory_pool_free(name);
-      return ret;
+  forwarder_interest_info_t info;
+  uint32_t name_hash = ndn_name_view_hash(&name);
+  ret = forwarder_decode_interest_info(raw_interest, size, &info);
+  if (ret != 0) {
+    return ret;
+  }
+
+  // Interests from applications are local and do not take a hop.
+  // The hop is counted in the copy forwarded upstream, as the received Interest is read-only.
+  bool count_hop = (info.hop_limit_offset != 0 && face->type != NDN_FACE_TYPE_APP);
+  bool hop_limit_reached = false;
+  if (count_hop) {
+    if (raw_interest[info.hop_limit_offset] == 0) {
+      self->counters.n_hop_limit_drops++;
+      return NDN_FWD_HOP_LIMIT_EXCEEDED;
     }
+    hop_limit_reached = (raw_interest[info.hop_limit_offset] == 1);
+  }
+
+  // Detect loops by the nonce
+  ndn_pit_entry_t* pit_entry = pit_table_find(&self->pit, &name, name_hash);
+  if (pit_entry != NULL && pit_entry->expire_time < self->now) {
+    // Its expiry event has not been processed yet
+    forwarder_pit_entry_expire(self, pit_entry);
+    pit_entry = NULL;
+  }
+  if (info.has_nonce
+      && ((pit_entry != NULL && pit_entry_has_nonce(pit_entry, info.nonce))
+          || dnl_table_find(&self->dnl, name_hash, info.nonce))) {
+    self->counters.n_duplicate_nonces++;
+    forwarder_send_nack(self, face, NDN_NACK_REASON_DUPLICATE, raw_interest, size);
+    return NDN_FWD_DUPLICATE_NONCE;
+  }
+
+  // Match with cs
+  ndn_cs_entry_t* cs_entry = cs_table_find(&self->cs, &name, name_hash,
+                                           info.can_be_prefix, info.must_be_fresh, self->now);
+  if (cs_entry != NULL) {
+    // held while it is sent, since the face may express an Interest replacing the entry
+    ndn_pktbuf_t* data = pktbuf_retain(cs_entry->data);
+    ret = ndn_forwarder_on_outgoing_data(face, data);
+    pktbuf_release(data);
+    return ret;
   }
 
   // Insert into PIT
-  ndn_pit_entry_t* pit_entry = pit_table_find_or_insert(name);
-  if (pit_entry == NULL) {
-    if (!bypass) {
-      ndn_memory_pool_free(name);
-    }
+  bool is_new = (pit_entry == NULL);
+  bool is_retransmission = !is_new && pit_entry_find_in_record(pit_entry, face) != NULL;
+  if (!is_retransmission && self->pit.face_in_records[face->face_id] >= self->pit.face_quota) {
+    // One face must not take over the PIT by evicting the entries of others
+    self->counters.n_pit_quota_drops++;
+    forwarder_send_nack(self, face, NDN_NACK_REASON_CONGESTION, raw_interest, size);
     return NDN_FWD_PIT_FULL;
   }
-  pit_entry_add_incoming_face(pit_entry, face);
+  if (is_new) {
+    if (!name_arena_can_store(&self->pit.names, &name)) {
+      // evicting would empty the PIT without making room
+      return NDN_OVERSIZE;
+    }
+    pit_entry = forwarder_pit_insert(self, &name, name_hash);
+    if (pit_entry == NULL) {
+      self->counters.n_pit_full_drops++;
+      forwarder_send_nack(self, face, NDN_NACK_REASON_CONGESTION, raw_interest, size);
+      return NDN_FWD_PIT_FULL;
+    }
+    pit_entry->strategy = strategy_choice_find(&self->strategy_choice, &name);
+    self->counters.n_pit_misses++;
+  }
+  else {
+    self->counters.n_pit_hits++;
+  }
+  timetick_t expire_time = self->now + info.lifetime;
+  ret = pit_entry_insert_in_record(&self->pit, pit_entry, face, info.has_nonce, info.nonce,
+                                   expire_time, self->now);
+  if (ret != 0) {
+    // Too many consumers are waiting for the same Data
+    self->counters.n_pit_full_drops++;
+    forwarder_send_nack(self, face, NDN_NACK_REASON_CONGESTION, raw_interest, size);
+    return ret;
+  }
+  pit_entry->nonce = info.nonce;
 
-  // Multicast Strategy
-  ret = forwarder_multicast_strategy(face, name, raw_interest, size, pit_entry);
+  // Rearm the expiry timer if the entry lives longer.
+  // The new timer is posted first, so that an entry keeps its old one if the scheduler is full.
+  if (expire_time > pit_entry->expire_time) {
+    ndn_event_handle_t expiry_event = ndn_scheduler_post(&self->scheduler, expire_time, self,
+                                                         forwarder_pit_expiry_event, 0, pit_entry);
+    if (expiry_event != NDN_EVENT_HANDLE_NONE) {
+      pit_entry_set_expire_time(&self->pit, pit_entry, expire_time);
+      pit_entry->lifetime = (uint32_t)info.lifetime;
+      ndn_scheduler_cancel(&self->scheduler, pit_entry->expiry_event);
+      pit_entry->expiry_event = expiry_event;
+    }
+    else if (is_new) {
+      // An entry without a timer would never expire
+      self->counters.n_pit_full_drops++;
+      forwarder_send_nack(self, face, NDN_NACK_REASON_CONGESTION, raw_interest, size);
+      forwarder_pit_entry_delete(self, pit_entry);
+      return NDN_FWD_SCHEDULER_FULL;
+    }
+  }
 
-  // Reject PIT
-  if (ret != 0) {
-    pit_entry_delete(pit_entry);
+  // Aggregate: an Interest from a new downstream waits for the pending one
+  if (!is_new && !is_retransmission) {
+    return 0;
   }
 
-  // Free memory
-  if (!bypass) {
-    ndn_memory_pool_free(name);
+  // Forward by the strategy
+  ndn_fib_entry_t* fib_entry = forwarder_fib_lookup(self, &name, &info);
+  ndn_fib_entry_t local_entry;
+  if (fib_entry != NULL && hop_limit_reached) {
+    // An Interest out of hops can only reach the applications on this node
+    local_entry = *fib_entry;
+    local_entry.nexthop_size = 0;
+    for (uint8_t i = 0; i < fib_entry->nexthop_size; i++) {
+      ndn_face_intf_t* nexthop = face_table_get(&self->face_table, fib_entry->nexthops[i].face_id);
+      if (nexthop->type == NDN_FACE_TYPE_APP) {
+        local_entry.nexthops[local_entry.nexthop_size++] = fib_entry->nexthops[i];
+      }
+    }
+    fib_entry = &local_entry;
+  }
+  if (fib_entry != NULL && count_hop) {
+    // Forwarded without being re-encoded, with the HopLimit decreased in a copy taken
+    // from the packet buffers of this forwarder, with headroom for the faces
+    ndn_pktbuf_t* outgoing = pktbuf_from_packet(self->pool, raw_interest, size);
+    if (outgoing != NULL) {
+      outgoing->data[info.hop_limit_offset]--;
+      ret = pit_entry->strategy->after_receive_interest(self, fib_entry, pit_entry, face, &name,
+                                                        outgoing->data, size, self->now);
+      pktbuf_release(outgoing);
+    }
+    else {
+      ret = NDN_FWD_NO_MEM;
+    }
+  }
+  else if (fib_entry != NULL) {
+    ret = pit_entry->strategy->after_receive_interest(self, fib_entry, pit_entry, face, &name,
+                                                      raw_interest, size, self->now);
+  }
+  else {
+    self->counters.n_fib_misses++;
+    ret = NDN_FWD_INTEREST_REJECTED;
+  }
+
+  // Reject PIT
+  if (ret != 0) {
+    // out of out-records or packet buffers is a congestion on this node,
+    // anything else leaves no way upstream
+    uint8_t reason = (ret == NDN_FWD_PIT_ENTRY_FACE_LIST_FULL || ret == NDN_FWD_NO_MEM)
+                     ? NDN_NACK_REASON_CONGESTION : NDN_NACK_REASON_NO_ROUTE;
+    forwarder_send_nack(self, face, reason, raw_interest, size);
+    if (is_new) {
+      forwarder_pit_entry_delete(self, pit_entry);
+    }
   }
 
   return ret;
 }
 
-static int
-forwarder_multicast_strategy(ndn_face_intf_t* face, ndn_name_t* name,
-                             const uint8_t* raw_interest, uint32_t size,
-                             const ndn_pit_entry_t* pit_entry)
+int
+ndn_forwarder_on_incoming_nack(ndn_forwarder_t* self, ndn_face_intf_t* face,
+                               const uint8_t* raw_nack, uint32_t size)
 {
-  (void)pit_entry;
-  ndn_fib_entry_t* fib_entry;
-  fib_entry = fib_table_find(name);
-  if (fib_entry && fib_entry->next_hop && fib_entry->next_hop != face) {
-    ndn_forwarder_on_outgoing_interest(fib_entry->next_hop, name, raw_interest, size);
+  uint8_t reason = NDN_NACK_REASON_NONE;
+  const uint8_t* raw_interest = NULL;
+  uint32_t interest_size = 0;
+  int ret = ndn_nack_tlv_decode(raw_nack, size, &reason, &raw_interest, &interest_size);
+  if (ret != 0) {
+    return ret;
   }
-  else {
-    // TODO: Send Nack
-    return NDN_FWD_INTEREST_REJECTED;
+
+  ndn_name_view_t name;
+  forwarder_interest_info_t info;
+  ret = forwarder_decode_name_view(raw_interest, interest_size, &name);
+  if (ret != 0) {
+    return ret;
+  }
+  ret = forwarder_decode_interest_info(raw_interest, interest_size, &info);
+  if (ret != 0) {
+    return ret;
   }
+
+  // A Nack to an Interest other than the latest one sent to the face is stale
+  ndn_pit_entry_t* pit_entry = pit_table_find(&self->pit, &name, ndn_name_view_hash(&name));
+  if (pit_entry == NULL) {
+    return 0;
+  }
+  ndn_pit_out_record_t* out_record = pit_entry_find_out_record(pit_entry, face);
+  if (out_record == NULL || out_record->nonce != info.nonce) {
+    return 0;
+  }
+
+  // Pass the Nack down once every upstream has Nacked.
+  // Each downstream gets it with the nonce of its own Interest, or it would find the Nack stale.
+  pit_entry_remove_out_record(pit_entry, face);
+  if (pit_entry->out_record_size == 0) {
+    uint8_t* nack = forwarder_alloc(self, size);
+    if (nack == NULL) {
+      forwarder_pit_entry_delete(self, pit_entry);
+      return NDN_FWD_NO_MEM;
+    }
+    memcpy(nack, raw_nack, size);
+    uint8_t* nonce = NULL;
+    if (info.nonce_offset != 0) {
+      nonce = nack + (raw_interest - raw_nack) + info.nonce_offset;
+    }
+    for (uint8_t i = 0; i < pit_entry->in_record_size; i++) {
+      const ndn_pit_in_record_t* in_record = &pit_entry->in_records[i];
+      if (in_record->expire_time < self->now) {
+        continue;
+      }
+      if (nonce != NULL) {
+        ndn_encoder_t encoder;
+        encoder_init(&encoder, nonce, 4);
+        encoder_append_uint32_value(&encoder, in_record->nonce);
+      }
+      ndn_face_send(face_table_get(&self->face_table, in_record->face_id), NULL, nack, size);
+    }
+    forwarder_free(self, nack);
+    forwarder_pit_entry_delete(self, pit_entry);
+  }
+
   return 0;
 }
+
+/************************************************************/
+/*  Definition of default forwarder instance                */
+/************************************************************/
+
+// The tables of the default forwarder with the sizes of forwarder_config_init()
+#define FORWARDER_DEFAULT_REGION_SIZE \
+  (NDN_POOL_ALIGN \
+   + NDN_PIT_REGION_SIZE(NDN_PIT_MAX_SIZE, NDN_PIT_INDEX_SIZE, NDN_PIT_NAME_ARENA_SIZE) \
+   + NDN_FIB_REGION_SIZE(NDN_FIB_MAX_SIZE, NDN_FIB_INDEX_SIZE, NDN_FIB_NAME_ARENA_SIZE) \
+   + NDN_RIB_REGION_SIZE(NDN_RIB_MAX_SIZE, NDN_RIB_NAME_ARENA_SIZE) \
+   + NDN_CS_REGION_SIZE(NDN_CS_MAX_SIZE) \
+   + NDN_SCHEDULER_REGION_SIZE(NDN_FORWARDER_SCHEDULER_SIZE(NDN_PIT_MAX_SIZE, NDN_RIB_MAX_SIZE)) \
+   + NDN_DIRECT_FACE_REGION_SIZE(NDN_DIRECT_FACE_CB_ENTRY_SIZE, NDN_DIRECT_FACE_NAME_ARENA_SIZE))
+
+static ndn_forwarder_t instance;
+static uint8_t instance_region[FORWARDER_DEFAULT_REGION_SIZE];
+
+ndn_forwarder_t*
+ndn_forwarder_get_instance(void)
+{
+  return &instance;
+}
+
+ndn_forwarder_t*
+ndn_forwarder_init(void)
+{
+  forwarder_init(&instance, NULL, instance_region, sizeof(instance_region));
+  return &instance;
+}
+
+ndn_forwarder_t*
+ndn_forwarder_init_with_region(const ndn_forwarder_config_t* config,
+                               uint8_t* region, size_t region_size)
+{
+  if (forwarder_init(&instance, config, region, region_size) != 0) {
+    return NULL;
+  }
+  return &instance;
+}
+
+void
+ndn_forwarder_process(timetick_t now)
+{
+  forwarder_process(&instance, now);
+}
+
+bool
+ndn_forwarder_get_next_deadline(timetick_t* deadline)
+{
+  return forwarder_get_next_deadline(&instance, deadline);
+}
+
+int
+ndn_forwarder_add_face(ndn_face_intf_t* face)
+{
+  return forwarder_add_face(&instance, face);
+}
+
+void
+ndn_forwarder_remove_face(ndn_face_intf_t* face)
+{
+  forwarder_remove_face(&instance, face);
+}
+
+ndn_face_intf_t*
+ndn_forwarder_get_face(uint16_t face_id)
+{
+  return forwarder_get_face(&instance, face_id);
+}
+
+int
+ndn_forwarder_fib_insert(const ndn_name_t* name_prefix,
+                         ndn_face_intf_t* face, uint8_t cost)
+{
+  return forwarder_fib_insert(&instance, name_prefix, face, cost);
+}
+
+bool
+ndn_forwarder_fib_remove(const ndn_name_t* name_prefix, const ndn_face_intf_t* face)
+{
+  return forwarder_fib_remove(&instance, name_prefix, face);
+}
+
+int
+ndn_forwarder_rib_register(const ndn_name_t* name_prefix, ndn_face_intf_t* face,
+                           uint16_t origin, uint8_t cost, uint64_t lifetime)
+{
+  return forwarder_rib_register(&instance, name_prefix, face, origin, cost, lifetime);
+}
+
+bool
+ndn_forwarder_rib_unregister(const ndn_name_t* name_prefix, ndn_face_intf_t* face,
+                             uint16_t origin)
+{
+  return forwarder_rib_unregister(&instance, name_prefix, face, origin);
+}
+
+int
+ndn_forwarder_set_strategy(const ndn_name_t* name_prefix, const ndn_strategy_t* strategy)
+{
+  return forwarder_set_strategy(&instance, name_prefix, strategy);
+}
@@ -11,86 +11,595 @@
 
 #include "pit.h"
 #include "fib.h"
+#include "rib.h"
+#include "cs.h"
+#include "dnl.h"
+#include "strategy.h"
 #include "face.h"
+#include "face-table.h"
+#include "scheduler.h"
+#include "msg-queue.h"
+#include "../security/ndn-lite-ecc.h"
+#include "../security/ndn-lite-hmac.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * The counters of the forwarder, published by the management module.
+ * Packets dropped by the tables are counted here, so that the tables can be sized
+ * from what happens on a running node. The CS keeps its own hit and miss counters, and the
+ * message queue counts the packets dropped because it was full.
+ */
+typedef struct ndn_forwarder_counters {
+  /**
+   * The packets received and sent through all faces.
+   */
+  ndn_face_counters_t packets;
+  /**
+   * The Interests that found a pending PIT entry.
+   */
+  uint32_t n_pit_hits;
+  /**
+   * The Interests that created a PIT entry.
+   */
+  uint32_t n_pit_misses;
+  /**
+   * The Interests dropped because the PIT or its name arena was full even after eviction,
+   * or because a PIT entry had NDN_PIT_MAX_IN_RECORDS unexpired in-records.
+   */
+  uint32_t n_pit_full_drops;
+  /**
+   * The unexpired PIT entries evicted to make room for new Interests.
+   */
+  uint32_t n_pit_evictions;
+  /**
+   * The Interests dropped because their incoming face had the PIT face quota of in-records.
+   */
+  uint32_t n_pit_quota_drops;
+  /**
+   * The Interests that matched no FIB entry.
+   */
+  uint32_t n_fib_misses;
+  /**
+   * The Interests forwarded by a delegation of their ForwardingHint.
+   */
+  uint32_t n_forwarding_hint_lookups;
+  /**
+   * The Interests dropped because they arrived with a HopLimit of zero.
+   */
+  uint32_t n_hop_limit_drops;
+  /**
+   * The Interests dropped as looping, by the PIT or the DNL.
+   */
+  uint32_t n_duplicate_nonces;
+  /**
+   * The PIT entries satisfied by Data.
+   */
+  uint32_t n_satisfied_interests;
+  /**
+   * The PIT entries that expired before Data came back.
+   */
+  uint32_t n_unsatisfied_interests;
+  /**
+   * The Data that matched no PIT entry.
+   */
+  uint32_t n_unsolicited_data;
+} ndn_forwarder_counters_t;
+
+/**
+ * The sizes of the tables of a forwarder, which are carved from one memory region given
+ * to forwarder_init(), so that one build of the library fits a small sensor node as well
+ * as a gateway. forwarder_config_init() fills in the defaults from ndn-constants.h.
+ * The scheduler is carved from the region as well, with an event for each PIT entry and
+ * route, see NDN_FORWARDER_SCHEDULER_SIZE().
+ * The face table, the strategy-choice table and the DNL are embedded in ndn_forwarder_t
+ * with compile-time sizes.
+ */
+typedef struct ndn_forwarder_config {
+  /**
+   * The PIT entries, and the slots of the PIT hash index: a power of two and at least
+   * twice @p pit_size.
+   */
+  uint16_t pit_size;
+  uint16_t pit_index_size;
+  /**
+   * The bytes of the name arena of the PIT, no more than 65534.
+   */
+  uint16_t pit_name_arena_size;
+  /**
+   * The FIB entries, and the slots of the FIB hash index: a power of two and at least
+   * twice @p fib_size.
+   */
+  uint16_t fib_size;
+  uint16_t fib_index_size;
+  /**
+   * The bytes of the name arena of the FIB, no more than 65534.
+   */
+  uint16_t fib_name_arena_size;
+  /**
+   * The routes of the RIB, and the bytes of their name arena, no more than 65534.
+   */
+  uint16_t rib_size;
+  uint16_t rib_name_arena_size;
+  /**
+   * The Data packets kept by the CS. The memory pool of the forwarder should have a packet
+   * buffer for each of them, besides the packets being forwarded.
+   */
+  uint16_t cs_size;
+  /**
+   * The callback entries of the direct face of the forwarder, and the bytes of their
+   * name arena, no more than 65534.
+   */
+  uint16_t direct_face_cb_size;
+  uint16_t direct_face_name_arena_size;
+  /**
+   * The seed of the random numbers of the strategies, e.g., to spread the load.
+   * Forwarders in one network should be given different seeds, or they make the same choices.
+   */
+  uint32_t random_seed;
+} ndn_forwarder_config_t;
+
+/**
+ * The events of the scheduler of a forwarder with @p pit_size PIT entries and @p rib_size
+ * routes: the expiry of each PIT entry and route, and one more, since a timer is rearmed
+ * by posting the new event before the old one is cancelled.
+ */
+#define NDN_FORWARDER_SCHEDULER_SIZE(pit_size, rib_size) \
+  ((uint32_t)(pit_size) + (uint32_t)(rib_size) + 1)
+
+/**
+ * The size of the buffer a forwarder encodes the Interest of an expired PIT entry in,
+ * for the timeout callbacks of the applications. It holds the name of any Interest
+ * reassembled by the faces, with a Nonce and an InterestLifetime.
+ */
+#define NDN_FORWARDER_TIMEOUT_INTEREST_SIZE (NDN_FRAG_BUFFER_MAX + 32)
+
+/**
+ * The bytes of memory region taken by each table of a forwarder, as laid out by
+ * forwarder_init().
+ */
+typedef struct ndn_forwarder_layout {
+  size_t pit;
+  size_t fib;
+  size_t rib;
+  size_t cs;
+  size_t scheduler;
+  size_t direct_face;
+  /**
+   * The bytes needed by forwarder_init(): the tables, and NDN_POOL_ALIGN bytes to align
+   * them in a region of any alignment.
+   */
+  size_t total;
+} ndn_forwarder_layout_t;
+
+/**
+ * The keys of the management module of a forwarder, set by ndn_mgmt_set_signing_key() and
+ * ndn_mgmt_set_command_keys(). They are not copied, and NULL if not set.
+ */
+typedef struct ndn_forwarder_mgmt_keys {
+  const ndn_name_t* identity;
+  const ndn_ecc_prv_t* prv_key;
+  const ndn_ecc_pub_t* command_ecdsa_key;
+  const ndn_hmac_key_t* command_hmac_key;
+} ndn_forwarder_mgmt_keys_t;
+
 /**
  * The structure to present NDN-Lite forwarder.
- * We will support content support in future versions.
- * The NDN forwarder is a singleton in an application.
+ * A forwarder keeps all its state in this structure, so several forwarders, e.g., the
+ * nodes of a simulation or the shards of a gateway, can run in one program. Each of them
+ * is driven by the forwarder_* functions, from one thread at a time.
+ * Firmware running a single forwarder uses the ndn_forwarder_* functions instead, which
+ * drive a default instance.
  */
 typedef struct ndn_forwarder {
+  /**
+   * The faces known to the forwarder.
+   */
+  ndn_face_table_t face_table;
   /**
    * The forwarding information base (FIB).
    */
   ndn_fib_t fib;
+  /**
+   * The routing information base (RIB).
+   */
+  ndn_rib_t rib;
   /**
    * The pending Interest table (PIT).
    */
   ndn_pit_t pit;
+  /**
+   * The content store (CS).
+   */
+  ndn_cs_t cs;
+  /**
+   * The dead nonce list (DNL).
+   */
+  ndn_dnl_t dnl;
+  /**
+   * The strategy-choice table.
+   */
+  ndn_strategy_choice_t strategy_choice;
+  /**
+   * The state kept by the built-in strategies.
+   */
+  ndn_strategy_measurements_t measurements;
+  /**
+   * The events of the forwarder, e.g., PIT expiry.
+   */
+  ndn_scheduler_t scheduler;
+  /**
+   * The packets received by ndn_face_receive_deferred() and not processed yet.
+   * It counts its drops itself, since they happen in interrupt handlers.
+   */
+  ndn_msgqueue_t msgqueue;
+  /**
+   * The memory pool of the packet buffers the forwarder copies Data into, for its CS and
+   * downstream faces to share, and of the buffers it encodes Nacks and Interests in.
+   * NULL for the default memory pool.
+   * Forwarders running in one program may be given pools of their own, so that the CS of
+   * one does not take all the packet buffers of the others.
+   */
+  ndn_memory_pool_t* pool;
+  /**
+   * The packet and table counters.
+   */
+  ndn_forwarder_counters_t counters;
+  /**
+   * The keys signing the status datasets and verifying the RIB commands.
+   */
+  ndn_forwarder_mgmt_keys_t mgmt_keys;
+  /**
+   * The buffer of the Interest passed to the timeout callbacks of the app faces, reserved
+   * so that an application is notified even if the memory pool is exhausted.
+   * @p timeout_interest_busy is set while the callbacks run.
+   */
+  uint8_t timeout_interest[NDN_FORWARDER_TIMEOUT_INTEREST_SIZE];
+  bool timeout_interest_busy;
+  /**
+   * The latest time given by forwarder_process().
+   */
+  timetick_t now;
+  /**
+   * The sizes of the tables, and the bytes they take in the memory region.
+   */
+  ndn_forwarder_config_t config;
+  ndn_forwarder_layout_t layout;
+  /**
+   * The part of the memory region reserved for the callback table of the direct face.
+   */
+  uint8_t* direct_face_region;
 } ndn_forwarder_t;
 
 /**
- * Get a running instance of forwarder.
- * @return the pointer to the forwarder instance.
+ * Fill in a forwarder configuration with the default sizes: NDN_PIT_MAX_SIZE,
+ * NDN_FIB_MAX_SIZE, NDN_RIB_MAX_SIZE, NDN_CS_MAX_SIZE and NDN_DIRECT_FACE_CB_ENTRY_SIZE
+ * entries, with the hash indexes and name arenas defined next to them.
+ * @param config. Output. The configuration.
  */
-ndn_forwarder_t*
-ndn_forwarder_get_instance(void);
+void
+forwarder_config_init(ndn_forwarder_config_t* config);
+
+/**
+ * Get the bytes of memory region a forwarder needs for its tables.
+ * @param config. Input. The sizes of the tables.
+ * @param layout. Output. The bytes taken by each table, and the total.
+ * @return 0 if there is no error. NDN_OVERSIZE if a size is 0 or too large, a hash
+ *         index is not a power of two twice as large as its table, or the scheduler
+ *         would hold more than NDN_SCHEDULER_MAX_SIZE events.
+ */
+int
+forwarder_get_layout(const ndn_forwarder_config_t* config, ndn_forwarder_layout_t* layout);
 
 /**
- * Init the NDN-Lite forwarder.
+ * Init a forwarder, laying out its tables in a memory region.
  * This function should be invoked before any face registration and packet sending.
- * @return the pointer to the forwarder instance.
+ * The scheduler and the message queue of the forwarder are also inited.
+ * @param self. Output. The forwarder to be inited.
+ * @param config. Input. The sizes of the tables. NULL for the default sizes.
+ * @param region. Input. The memory region the tables are carved from. It must outlive
+ *                the forwarder.
+ * @param region_size. Input. The size of @p region in bytes, at least the total given by
+ *                     forwarder_get_layout().
+ * @return 0 if there is no error. NDN_OVERSIZE if @p config is invalid or @p region is
+ *         too small.
  */
-ndn_forwarder_t*
-ndn_forwarder_init(void);
+int
+forwarder_init(ndn_forwarder_t* self, const ndn_forwarder_config_t* config,
+               uint8_t* region, size_t region_size);
+
+/**
+ * Let the forwarder know the current time, and process the received packets.
+ * The application should invoke this function periodically in its main loop.
+ * Up to NDN_FORWARDER_RX_BATCH_SIZE packets queued by ndn_face_receive_deferred() are
+ * processed in one call, so that a burst does not starve the rest of the main loop.
+ * The time is used to judge the freshness of Data in the CS, and to run due scheduler
+ * events, which expire PIT entries after their InterestLifetime.
+ * @param self. Input/Output. The forwarder.
+ * @param now. Input. The current time in milliseconds, read from a monotonic clock,
+ *            e.g., ndn_clock_now().
+ */
+void
+forwarder_process(ndn_forwarder_t* self, timetick_t now);
+
+/**
+ * Get the earliest time at which forwarder_process() has work to do, so that the main loop
+ * can sleep until then, unless a face receives a packet before.
+ * @param self. Input/Output. The forwarder.
+ * @param deadline. Output. The time point. The time of the latest forwarder_process() if
+ *                  some received packets are left in the queue.
+ * @return false if there is nothing to wait for, i.e., the loop can sleep until a packet
+ *         is received.
+ */
+bool
+forwarder_get_next_deadline(ndn_forwarder_t* self, timetick_t* deadline);
+
+/**
+ * Add a face to the forwarder, and assign its face ID.
+ * Faces add themselves when they are constructed, so applications seldom need this function.
+ * Adding a face that is already added does nothing. A face can be in one forwarder only.
+ * @param self. Input/Output. The forwarder.
+ * @param face. Input/Output. The face.
+ * @return 0 if there is no error. NDN_FWD_FACE_TABLE_FULL if there are already
+ *         NDN_FACE_TABLE_MAX_SIZE faces. NDN_FWD_FACE_IN_OTHER_FORWARDER if the face is
+ *         in another forwarder.
+ */
+int
+forwarder_add_face(ndn_forwarder_t* self, ndn_face_intf_t* face);
+
+/**
+ * Remove a face from the forwarder, with the state referring to it.
+ * The routes and the next hops through the face are removed from the RIB and the FIB,
+ * and FIB entries left without next hops are deleted. The face is removed from the PIT entries, and PIT entries left
+ * without incoming faces are deleted. The measurements of the strategies are forgotten.
+ * This function is invoked by ndn_face_destroy().
+ * @param self. Input/Output. The forwarder.
+ * @param face. Input/Output. The face.
+ */
+void
+forwarder_remove_face(ndn_forwarder_t* self, ndn_face_intf_t* face);
 
 /**
- * Add FIB entry into the FIB.
+ * Get a face by its face ID.
+ * @param self. Input. The forwarder.
+ * @param face_id. Input. The face ID.
+ * @return the face. NULL if there is no such face.
+ */
+static inline ndn_face_intf_t*
+forwarder_get_face(const ndn_forwarder_t* self, uint16_t face_id)
+{
+  return face_table_get(&self->face_table, face_id);
+}
+
+/**
+ * Add a next hop of a name prefix into the FIB.
  * This function should be invoked before sending a packet through the specific face.
+ * A prefix can have up to NDN_FIB_MAX_NEXTHOPS next hops. Adding an existing next hop
+ * updates its cost. The face is added to the forwarder if it has not been.
+ * @param self. Input/Output. The forwarder.
  * @param name_prefix. Input. The FIB's name prefix.
  * @param face. Input/Output. The face instance to send the packet out.
  * @param cost. The cost of sending a packet through the @param face. When more than one faces
- *        can be used to send a packet, the face with lower cost will be used.
+ *        can be used to send a packet, the strategy decides whether to use the face with
+ *        lower cost.
  * @return 0 if there is no error.
  */
 int
+forwarder_fib_insert(ndn_forwarder_t* self, const ndn_name_t* name_prefix,
+                     ndn_face_intf_t* face, uint8_t cost);
+
+/**
+ * Remove a next hop of a name prefix from the FIB.
+ * The FIB entry is deleted if it is left without next hops.
+ * @param self. Input/Output. The forwarder.
+ * @param name_prefix. Input. The FIB's name prefix.
+ * @param face. Input. The face of the next hop.
+ * @return true if there was such a next hop.
+ */
+bool
+forwarder_fib_remove(ndn_forwarder_t* self, const ndn_name_t* name_prefix,
+                     const ndn_face_intf_t* face);
+
+/**
+ * Register a route into the RIB, and update the FIB next hop of the prefix and the face.
+ * Registering an existing route, i.e., of the same prefix, face and origin, updates its
+ * cost and lifetime. Once a route of a prefix and a face is registered, the FIB next hop
+ * of them follows the routes in the RIB.
+ * @param self. Input/Output. The forwarder.
+ * @param name_prefix. Input. The name prefix.
+ * @param face. Input/Output. The face of the next hop.
+ * @param origin. Input. The origin registering the route.
+ * @param cost. Input. The cost of the route.
+ * @param lifetime. Input. The lifetime of the route in milliseconds, cut to
+ *        NDN_RIB_MAX_EXPIRATION_PERIOD. NDN_RIB_NEVER_EXPIRE for a route that does not expire.
+ * @return 0 if there is no error. NDN_FWD_RIB_FULL if the RIB is full.
+ *         NDN_FWD_SCHEDULER_FULL if the expiry of the route cannot be scheduled.
+ */
+int
+forwarder_rib_register(ndn_forwarder_t* self, const ndn_name_t* name_prefix,
+                       ndn_face_intf_t* face, uint16_t origin, uint8_t cost, uint64_t lifetime);
+
+/**
+ * Unregister a route from the RIB, and update the FIB next hop of the prefix and the face.
+ * @param self. Input/Output. The forwarder.
+ * @param name_prefix. Input. The name prefix.
+ * @param face. Input. The face of the next hop.
+ * @param origin. Input. The origin which registered the route.
+ * @return true if there was such a route.
+ */
+bool
+forwarder_rib_unregister(ndn_forwarder_t* self, const ndn_name_t* name_prefix,
+                         ndn_face_intf_t* face, uint16_t origin);
+
+/**
+ * Set the forwarding strategy of a name prefix.
+ * The strategy applies to the Interests whose PIT entries are created afterwards.
+ * Interests under no configured prefix use ndn_strategy_best_route.
+ * @param self. Input/Output. The forwarder.
+ * @param name_prefix. Input. The name prefix.
+ * @param strategy. Input. The strategy, e.g., &ndn_strategy_multicast.
+ * @return 0 if there is no error.
+ */
+int
+forwarder_set_strategy(ndn_forwarder_t* self, const ndn_name_t* name_prefix,
+                       const ndn_strategy_t* strategy);
+
+/*
+ * The functions below drive the default forwarder instance, for firmware running a
+ * single forwarder. Each of them is the forwarder_* function of the same name on it.
+ */
+
+/**
+ * Get the default instance of forwarder.
+ * @return the pointer to the forwarder instance.
+ */
+ndn_forwarder_t*
+ndn_forwarder_get_instance(void);
+
+/**
+ * Init the default forwarder with the default sizes, in a memory region reserved when
+ * the program starts. See forwarder_init().
+ * @return the pointer to the forwarder instance.
+ */
+ndn_forwarder_t*
+ndn_forwarder_init(void);
+
+/**
+ * Init the default forwarder in a memory region given by the application, e.g., to size
+ * its tables for a gateway. See forwarder_init().
+ * @return the pointer to the forwarder instance. NULL if @p config is invalid or
+ *         @p region is too small.
+ */
+ndn_forwarder_t*
+ndn_forwarder_init_with_region(const ndn_forwarder_config_t* config,
+                               uint8_t* region, size_t region_size);
+
+/**
+ * Let the default forwarder process. See forwarder_process().
+ */
+void
+ndn_forwarder_process(timetick_t now);
+
+/**
+ * Get the next deadline of the default forwarder. See forwarder_get_next_deadline().
+ */
+bool
+ndn_forwarder_get_next_deadline(timetick_t* deadline);
+
+/**
+ * Add a face to the default forwarder. See forwarder_add_face().
+ */
+int
+ndn_forwarder_add_face(ndn_face_intf_t* face);
+
+/**
+ * Remove a face from the default forwarder. See forwarder_remove_face().
+ */
+void
+ndn_forwarder_remove_face(ndn_face_intf_t* face);
+
+/**
+ * Get a face of the default forwarder by its face ID. See forwarder_get_face().
+ */
+ndn_face_intf_t*
+ndn_forwarder_get_face(uint16_t face_id);
+
+/**
+ * Add a next hop into the FIB of the default forwarder. See forwarder_fib_insert().
+ */
+int
 ndn_forwarder_fib_insert(const ndn_name_t* name_prefix,
                          ndn_face_intf_t* face, uint8_t cost);
 
+/**
+ * Remove a next hop from the FIB of the default forwarder. See forwarder_fib_remove().
+ */
+bool
+ndn_forwarder_fib_remove(const ndn_name_t* name_prefix, const ndn_face_intf_t* face);
+
+/**
+ * Register a route into the RIB of the default forwarder. See forwarder_rib_register().
+ */
+int
+ndn_forwarder_rib_register(const ndn_name_t* name_prefix, ndn_face_intf_t* face,
+                           uint16_t origin, uint8_t cost, uint64_t lifetime);
+
+/**
+ * Unregister a route from the RIB of the default forwarder. See forwarder_rib_unregister().
+ */
+bool
+ndn_forwarder_rib_unregister(const ndn_name_t* name_prefix, ndn_face_intf_t* face,
+                             uint16_t origin);
+
+/**
+ * Set the forwarding strategy of a name prefix on the default forwarder.
+ * See forwarder_set_strategy().
+ */
+int
+ndn_forwarder_set_strategy(const ndn_name_t* name_prefix, const ndn_strategy_t* strategy);
+
 /**
  * Let the forwarder receive a Data packet.
  * This function is supposed to be invoked by face implementation ONLY.
+ * The name is read in place from the wire format packet, without being decoded into a copy.
+ * The HopLimit of an Interest from a network face is decremented in place, so the
+ * packet must be in writable memory. An Interest arriving with a HopLimit of zero is dropped.
  * @param self. Input/Output. The forwarder to receive the Data packet.
  * @param face. Input. The face instance who transmits the packet to the forwarder.
- * @param name. [optional] Input. The name of the packet. If name == NULL, the forwarder
- *        will decode the packet name by itself.
  * @param raw_data. Input. The wire format Data received by the @param face.
  * @param size. Input. The size of the wire format Data.
  * @return 0 if there is no error.
  */
 int
-ndn_forwarder_on_incoming_data(ndn_forwarder_t* self, ndn_face_intf_t* face, ndn_name_t *name,
+ndn_forwarder_on_incoming_data(ndn_forwarder_t* self, ndn_face_intf_t* face,
                                const uint8_t *raw_data, uint32_t size);
 
+/**
+ * Let the forwarder receive a Data packet in a packet buffer.
+ * This function is supposed to be invoked by face implementation ONLY.
+ * Unlike ndn_forwarder_on_incoming_data(), the Data is not copied into a packet buffer of the
+ * forwarder: the CS and the downstream faces take references to @p packet instead.
+ * @param self. Input/Output. The forwarder to receive the Data packet.
+ * @param face. Input. The face instance who transmits the packet to the forwarder.
+ * @param packet. Input/Output. The packet buffer of the wire format Data. The caller keeps its
+ *                reference.
+ * @return 0 if there is no error.
+ */
+int
+ndn_forwarder_on_incoming_data_pktbuf(ndn_forwarder_t* self, ndn_face_intf_t* face,
+                                      ndn_pktbuf_t* packet);
+
 /**
  * Let the forwarder receive a Interest packet.
  * This function is supposed to be invoked by face implementation ONLY.
+ * The name is read in place from the wire format packet, without being decoded into a copy.
  * @param self. Input/Output. The forwarder to receive the Interest packet.
  * @param face. Input. The face instance who transmits the packet to the forwarder.
- * @param name. [optional] Input. The name of the packet. If name == NULL, the forwarder
- *        will decode the packet name by itself.
  * @param raw_data. Input. The wire format Interest received by the @param face.
  * @param size. Input. The size of the wire format Interest.
  * @return 0 if there is no error.
  */
 int
-ndn_forwarder_on_incoming_interest(ndn_forwarder_t* self, ndn_face_intf_t* face, ndn_name_t *name,
+ndn_forwarder_on_incoming_interest(ndn_forwarder_t* self, ndn_face_intf_t* face,
                                    const uint8_t *raw_interest, uint32_t size);
 
+/**
+ * Let the forwarder receive a Nack packet.
+ * This function is supposed to be invoked by face implementation ONLY.
+ * The Nack is passed down to the downstream faces of the PIT entry once all the upstream
+ * faces have Nacked it. A Nack whose nonce differs from the out-record of the face is ignored.
+ * @param self. Input/Output. The forwarder to receive the Nack packet.
+ * @param face. Input. The face instance who transmits the packet to the forwarder.
+ * @param raw_nack. Input. The wire format Nack (NDNLPv2 LpPacket) received by the @param face.
+ * @param size. Input. The size of the wire format Nack.
+ * @return 0 if there is no error.
+ */
+int
+ndn_forwarder_on_incoming_nack(ndn_forwarder_t* self, ndn_face_intf_t* face,
+                               const uint8_t* raw_nack, uint32_t size);
+
 #ifdef __cplusplus
 }
 #endif
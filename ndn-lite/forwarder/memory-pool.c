@@ -6,66 +6,190 @@
  * directory for more details.
  */
 
-#include "../ndn-constants.h"
-#include "../encode/interest.h"
-#include "../encode/data.h"
+#include "../ndn-error-code.h"
 #include "memory-pool.h"
+#include <stdint.h>
+#include <string.h>
 
-// TODO: Make it a general mem-array.
+#define MEMORY_BLOCK_NONE 0xFFFF
+#define MEMORY_BLOCK_FREE 0
+#define MEMORY_BLOCK_USED 1
 
-#define MEMORY_BLOCK_USED 0xFF
-
-typedef struct memory_block
+static inline uint16_t
+memory_class_get_next(const ndn_memory_class_t* self, uint16_t index)
 {
-  // next make a linked-list of free blocks
-  uint8_t next;
-  uint8_t buf[NDN_POOL_BLOCK_SIZE];
-} memory_block_t;
+  uint16_t next;
+  memcpy(&next, self->blocks + (size_t)index * NDN_POOL_ALIGN_UP(self->block_size), sizeof(next));
+  return next;
+}
 
-static memory_block_t memory_pool[NDN_POOL_BLOCK_CNT];
-static uint8_t memory_pool_first;
+static inline void
+memory_class_set_next(ndn_memory_class_t* self, uint16_t index, uint16_t next)
+{
+  memcpy(self->blocks + (size_t)index * NDN_POOL_ALIGN_UP(self->block_size), &next, sizeof(next));
+}
 
 int
-ndn_memory_pool_init(void)
+memory_pool_init(ndn_memory_pool_t* self, uint8_t* region, size_t region_size,
+                 const ndn_memory_class_config_t* classes, uint8_t class_size)
 {
-  if (NDN_POOL_BLOCK_SIZE < sizeof(ndn_name_t)) {
-    return -1;
+  if (class_size > NDN_POOL_CLASS_MAX) {
+    return NDN_OVERSIZE;
+  }
+  self->class_size = 0;
+
+  // sort the classes by block size, so that allocation stops at the first fitting one
+  ndn_memory_class_config_t sorted[NDN_POOL_CLASS_MAX];
+  for (uint8_t i = 0; i < class_size; i++) {
+    uint8_t j = i;
+    while (j > 0 && sorted[j - 1].block_size > classes[i].block_size) {
+      sorted[j] = sorted[j - 1];
+      j--;
+    }
+    sorted[j] = classes[i];
   }
 
-  memory_pool_first = NDN_POOL_BLOCK_CNT - 1;
-  for (int i = 0; i < NDN_POOL_BLOCK_CNT; i ++) {
-    memory_pool[i].next = i - 1;
+  // carve the classes from the region
+  size_t skip = (NDN_POOL_ALIGN - (uintptr_t)region % NDN_POOL_ALIGN) % NDN_POOL_ALIGN;
+  if (skip > region_size) {
+    return NDN_OVERSIZE;
   }
-  memory_pool[0].next = MEMORY_BLOCK_USED;
+  uint8_t* cursor = region + skip;
+  size_t remaining = region_size - skip;
+  for (uint8_t i = 0; i < class_size; i++) {
+    ndn_memory_class_t* mem_class = &self->classes[i];
+    if (sorted[i].block_size == 0 || sorted[i].block_cnt >= MEMORY_BLOCK_NONE) {
+      return NDN_OVERSIZE;
+    }
+    size_t needed = NDN_POOL_CLASS_REGION_SIZE((size_t)sorted[i].block_size, (size_t)sorted[i].block_cnt);
+    if (needed > remaining) {
+      return NDN_OVERSIZE;
+    }
+    mem_class->states = cursor;
+    mem_class->blocks = cursor + NDN_POOL_ALIGN_UP((size_t)sorted[i].block_cnt);
+    mem_class->block_size = sorted[i].block_size;
+    mem_class->block_cnt = sorted[i].block_cnt;
+    mem_class->used = 0;
+    mem_class->high_water = 0;
+    mem_class->n_failures = 0;
+    cursor += needed;
+    remaining -= needed;
 
+    // thread the free list through the blocks
+    mem_class->first = mem_class->block_cnt > 0 ? 0 : MEMORY_BLOCK_NONE;
+    for (uint16_t j = 0; j < mem_class->block_cnt; j++) {
+      mem_class->states[j] = MEMORY_BLOCK_FREE;
+      memory_class_set_next(mem_class, j, j + 1 < mem_class->block_cnt ? j + 1 : MEMORY_BLOCK_NONE);
+    }
+  }
+  self->class_size = class_size;
   return 0;
 }
 
-uint8_t*
-ndn_memory_pool_alloc(void)
+void*
+memory_pool_alloc(ndn_memory_pool_t* self, size_t size)
 {
-  if (memory_pool_first == MEMORY_BLOCK_USED) {
-    return NULL;
+  ndn_memory_class_t* fitting = NULL;
+  for (uint8_t i = 0; i < self->class_size; i++) {
+    ndn_memory_class_t* mem_class = &self->classes[i];
+    if (mem_class->block_size < size) {
+      continue;
+    }
+    if (fitting == NULL) {
+      fitting = mem_class;
+    }
+    if (mem_class->first == MEMORY_BLOCK_NONE) {
+      continue;
+    }
+    uint16_t index = mem_class->first;
+    mem_class->first = memory_class_get_next(mem_class, index);
+    mem_class->states[index] = MEMORY_BLOCK_USED;
+    mem_class->used++;
+    if (mem_class->used > mem_class->high_water) {
+      mem_class->high_water = mem_class->used;
+    }
+    return mem_class->blocks + (size_t)index * NDN_POOL_ALIGN_UP(mem_class->block_size);
   }
-  uint8_t ret = memory_pool_first;
-  memory_pool_first = memory_pool[ret].next;
-  memory_pool[ret].next = MEMORY_BLOCK_USED;
-  return &memory_pool[ret].buf[0];
+  if (fitting != NULL) {
+    fitting->n_failures++;
+  }
+  return NULL;
 }
 
 int
-ndn_memory_pool_free(void* ptr)
+memory_pool_free(ndn_memory_pool_t* self, void* ptr)
 {
-  memory_block_t* base_addr;
-
   if (ptr == NULL) {
     return -1;
   }
-  base_addr = (memory_block_t*)((uint8_t*)ptr - ((size_t)&((memory_block_t*)NULL)->buf[0]));
-  if (base_addr->next != MEMORY_BLOCK_USED) {
-    return -1;
+  for (uint8_t i = 0; i < self->class_size; i++) {
+    ndn_memory_class_t* mem_class = &self->classes[i];
+    size_t stride = NDN_POOL_ALIGN_UP(mem_class->block_size);
+    uint8_t* block = (uint8_t*)ptr;
+    if (block < mem_class->blocks || block >= mem_class->blocks + stride * mem_class->block_cnt) {
+      continue;
+    }
+    size_t offset = (size_t)(block - mem_class->blocks);
+    if (offset % stride != 0) {
+      return -1;
+    }
+    uint16_t index = (uint16_t)(offset / stride);
+    if (mem_class->states[index] != MEMORY_BLOCK_USED) {
+      return -1;
+    }
+    mem_class->states[index] = MEMORY_BLOCK_FREE;
+    memory_class_set_next(mem_class, index, mem_class->first);
+    mem_class->first = index;
+    mem_class->used--;
+    return 0;
   }
-  base_addr->next = memory_pool_first;
-  memory_pool_first = base_addr - memory_pool;
-  return 0;
+  return -1;
+}
+
+/************************************************************/
+/*  Definition of default memory pool                       */
+/************************************************************/
+
+static const ndn_memory_class_config_t memory_pool_classes[] = {
+  {NDN_POOL_BLOCK_SIZE, NDN_POOL_BLOCK_CNT},
+  {NDN_POOL_SCRATCH_SIZE, NDN_POOL_SCRATCH_CNT},
+  {NDN_POOL_PKTBUF_SIZE, NDN_POOL_PKTBUF_CNT},
+};
+
+static uint8_t memory_pool_region[NDN_POOL_DEFAULT_REGION_SIZE];
+static ndn_memory_pool_t memory_pool;
+static bool memory_pool_inited = false;
+
+int
+ndn_memory_pool_init(void)
+{
+  int ret = memory_pool_init(&memory_pool, memory_pool_region, sizeof(memory_pool_region),
+                             memory_pool_classes,
+                             sizeof(memory_pool_classes) / sizeof(memory_pool_classes[0]));
+  memory_pool_inited = (ret == 0);
+  return ret;
+}
+
+void*
+ndn_memory_pool_alloc(size_t size)
+{
+  if (!memory_pool_inited && ndn_memory_pool_init() != 0) {
+    return NULL;
+  }
+  return memory_pool_alloc(&memory_pool, size);
+}
+
+int
+ndn_memory_pool_free(void* ptr)
+{
+  return memory_pool_free(&memory_pool, ptr);
+}
+
+const ndn_memory_pool_t*
+ndn_memory_pool_get(void)
+{
+  if (!memory_pool_inited) {
+    ndn_memory_pool_init();
+  }
+  return &memory_pool;
 }
@@ -9,45 +9,201 @@
 #ifndef memory_pool_h
 #define memory_pool_h
 
+#include "../ndn-constants.h"
 #include "../encode/name.h"
+#include <stddef.h>
 
 /*
- * Memory pool manages temporary memory blocks to store Name.
- * Memory blocks are allocated in fixed size.
+ * Memory pool manages temporary memory blocks, e.g., the scratch buffers of
+ * decoding, signing and forwarding, which would be too large for the stack.
+ * The blocks are grouped into size classes, each a fixed number of blocks of a fixed
+ * size carved from a memory region given at init. Both allocation and free take a time
+ * bounded by NDN_POOL_CLASS_MAX, and never fragment the region.
  */
 
 /**
- * The size of memory block in bytes.
- * This value should be equal to sizeof(Name)
+ * The alignment of every block in bytes.
+ */
+#define NDN_POOL_ALIGN 8
+
+/**
+ * Maximum number of size classes of a pool.
+ */
+#define NDN_POOL_CLASS_MAX 8
+
+/**
+ * Round a size up to NDN_POOL_ALIGN.
+ */
+#define NDN_POOL_ALIGN_UP(size) (((size) + NDN_POOL_ALIGN - 1) / NDN_POOL_ALIGN * NDN_POOL_ALIGN)
+
+/**
+ * The bytes of region taken by a size class, including its block states.
+ */
+#define NDN_POOL_CLASS_REGION_SIZE(block_size, block_cnt) \
+  (NDN_POOL_ALIGN_UP(block_cnt) + NDN_POOL_ALIGN_UP(block_size) * (block_cnt))
+
+/**
+ * The size of the blocks storing a Name in the default pool.
  */
 #define NDN_POOL_BLOCK_SIZE (sizeof(ndn_name_t))
 
 /**
- * Maximum number of blocks can be allocated.
- * When program statrts, memory pool will reserve
- * (NDN_POOL_BLOCK_CNT * NDN_POOL_BLOCK_SIZE) bytes.
+ * The number of the blocks storing a Name in the default pool.
  */
 #define NDN_POOL_BLOCK_CNT 4
 
 /**
- * Initialize the memory pool.
- * Reserve (NDN_POOL_BLOCK_CNT * NDN_POOL_BLOCK_SIZE) bytes.
+ * The size of the scratch blocks in the default pool.
+ * This value should be no less than the largest scratch buffer borrowed by the library,
+ * which is the signing input of a signed Interest.
+ */
+#define NDN_POOL_SCRATCH_SIZE NDN_SIGNED_INTEREST_BE_SIGNED_MAX_SIZE
+
+/**
+ * The number of the scratch blocks in the default pool, i.e., how many of them can be in
+ * use at the same time, e.g., by a callback forwarding a packet while its caller is.
+ */
+#define NDN_POOL_SCRATCH_CNT 4
+
+/**
+ * The size of the packet buffer blocks in the default pool: a packet of up to
+ * NDN_FRAG_BUFFER_MAX bytes, with the headroom and the header of a packet buffer.
+ * See packet-buffer.h.
+ */
+#define NDN_POOL_PKTBUF_SIZE (NDN_FRAG_BUFFER_MAX + 48)
+
+/**
+ * The number of the packet buffer blocks in the default pool: one for each Content Store
+ * entry of the default forwarder, and a few for the packets being forwarded or sent.
+ */
+#define NDN_POOL_PKTBUF_CNT (NDN_CS_MAX_SIZE + 4)
+
+/**
+ * The bytes reserved for the default pool when the program starts.
+ */
+#define NDN_POOL_DEFAULT_REGION_SIZE \
+  (NDN_POOL_ALIGN \
+   + NDN_POOL_CLASS_REGION_SIZE(NDN_POOL_BLOCK_SIZE, NDN_POOL_BLOCK_CNT) \
+   + NDN_POOL_CLASS_REGION_SIZE(NDN_POOL_SCRATCH_SIZE, NDN_POOL_SCRATCH_CNT) \
+   + NDN_POOL_CLASS_REGION_SIZE(NDN_POOL_PKTBUF_SIZE, NDN_POOL_PKTBUF_CNT))
+
+/**
+ * The configuration of a size class.
+ */
+typedef struct ndn_memory_class_config {
+  uint16_t block_size;
+  uint16_t block_cnt;
+} ndn_memory_class_config_t;
+
+/**
+ * A size class of a memory pool.
+ */
+typedef struct ndn_memory_class {
+  /**
+   * The blocks, NDN_POOL_ALIGN_UP(block_size) bytes each.
+   */
+  uint8_t* blocks;
+  /**
+   * Whether each block is allocated.
+   */
+  uint8_t* states;
+  uint16_t block_size;
+  uint16_t block_cnt;
+  /**
+   * The first free block, whose first bytes hold the index of the next one.
+   */
+  uint16_t first;
+  /**
+   * The number of blocks allocated now.
+   */
+  uint16_t used;
+  /**
+   * The largest number of blocks ever allocated at the same time.
+   */
+  uint16_t high_water;
+  /**
+   * The allocations of a size fitting this class that failed since no block was free
+   * in this class or a larger one.
+   */
+  uint32_t n_failures;
+} ndn_memory_class_t;
+
+/**
+ * The class of memory pool.
+ * A program can run several pools, e.g., one for each forwarder, with the memory_pool_*
+ * functions. The ndn_memory_pool_* functions use a default pool, which the library
+ * borrows its scratch buffers from.
+ */
+typedef struct ndn_memory_pool {
+  /**
+   * The size classes, from the smallest block size to the largest.
+   */
+  ndn_memory_class_t classes[NDN_POOL_CLASS_MAX];
+  uint8_t class_size;
+} ndn_memory_pool_t;
+
+/**
+ * Initialize a memory pool.
+ * The region needs NDN_POOL_ALIGN bytes, plus NDN_POOL_CLASS_REGION_SIZE() bytes for each
+ * size class.
+ * @param self. Output. The memory pool to be inited.
+ * @param region. Input. The memory region the blocks are carved from. It must outlive the pool.
+ * @param region_size. Input. The size of @p region in bytes.
+ * @param classes. Input. The size classes, in any order.
+ * @param class_size. Input. The number of size classes, up to NDN_POOL_CLASS_MAX.
+ * @return 0 if there is no error. NDN_OVERSIZE if there are too many size classes or blocks,
+ *         a block size is 0, or the region is too small for them.
  */
 int
-ndn_memory_pool_init(void);
+memory_pool_init(ndn_memory_pool_t* self, uint8_t* region, size_t region_size,
+                 const ndn_memory_class_config_t* classes, uint8_t class_size);
 
 /**
- * Allocate a new block in size NDN_POOL_BLOCK_SIZE.
- * @return A pointer to the allocated block.
+ * Allocate a block from the smallest size class that fits and has a free block.
+ * @param self. Input/Output. The memory pool.
+ * @param size. Input. The size needed in bytes.
+ * @return A pointer to the allocated block, aligned to NDN_POOL_ALIGN. NULL if there is no
+ *         free block large enough.
  */
-uint8_t*
-ndn_memory_pool_alloc(void);
+void*
+memory_pool_alloc(ndn_memory_pool_t* self, size_t size);
 
 /**
  * Free allocated memory block.
+ * @param self. Input/Output. The memory pool the block is allocated from.
  * @param ptr. Input. Pointer to the block to be freed.
+ * @return 0 if there is no error. -1 if @p ptr is not an allocated block of the pool.
+ */
+int
+memory_pool_free(ndn_memory_pool_t* self, void* ptr);
+
+/**
+ * Initialize the default memory pool, with NDN_POOL_BLOCK_CNT blocks of NDN_POOL_BLOCK_SIZE,
+ * NDN_POOL_SCRATCH_CNT blocks of NDN_POOL_SCRATCH_SIZE and NDN_POOL_PKTBUF_CNT blocks of
+ * NDN_POOL_PKTBUF_SIZE.
+ * Reserve NDN_POOL_DEFAULT_REGION_SIZE bytes.
+ * The pool is inited on its first use if this function is never called.
+ * Calling it again frees all the blocks.
+ */
+int
+ndn_memory_pool_init(void);
+
+/**
+ * Allocate a block from the default memory pool. See memory_pool_alloc().
+ */
+void*
+ndn_memory_pool_alloc(size_t size);
+
+/**
+ * Free a block allocated from the default memory pool. See memory_pool_free().
  */
 int
 ndn_memory_pool_free(void* ptr);
 
+/**
+ * Get the default memory pool, e.g., to read its statistics.
+ */
+const ndn_memory_pool_t*
+ndn_memory_pool_get(void);
+
 #endif /* memory_pool_h */
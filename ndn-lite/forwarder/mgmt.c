@@ -0,0 +1,585 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include "mgmt.h"
+#include "../encode/data.h"
+#include "../encode/signed-interest.h"
+#include <string.h>
+
+// The freshness of a status dataset, which changes with every packet
+#define MGMT_FRESHNESS_PERIOD 1000
+
+// The largest FaceStatus block: FaceId of uint16_t and six counters of uint32_t
+#define MGMT_FACE_STATUS_MAX_SIZE (2 + (2 + 2) + 6 * (2 + 4))
+#define MGMT_FACES_PER_SEGMENT (NDN_CONTENT_BUFFER_SIZE / MGMT_FACE_STATUS_MAX_SIZE)
+
+// Large enough for a Data with a full Content, the longest Name and KeyLocator, and a signature
+#define MGMT_DATA_BUFFER_SIZE \
+  (NDN_CONTENT_BUFFER_SIZE + 2 * NDN_NAME_MAX_BLOCK_SIZE + NDN_SIGNATURE_BUFFER_SIZE + 32)
+
+// The wire format components of /localhost/nfd
+static const uint8_t mgmt_prefix[] = {
+  TLV_GenericNameComponent, 9, 'l', 'o', 'c', 'a', 'l', 'h', 'o', 's', 't',
+  TLV_GenericNameComponent, 3, 'n', 'f', 'd'
+};
+// The wire format components of /localhop/nfd, where the neighbors send RIB commands
+static const uint8_t mgmt_localhop_prefix[] = {
+  TLV_GenericNameComponent, 8, 'l', 'o', 'c', 'a', 'l', 'h', 'o', 'p',
+  TLV_GenericNameComponent, 3, 'n', 'f', 'd'
+};
+#define MGMT_PREFIX_COMPONENTS_SIZE 2
+
+// The wire format components of the datasets under the prefix
+static const uint8_t mgmt_status_general[] = {
+  TLV_GenericNameComponent, 6, 's', 't', 'a', 't', 'u', 's',
+  TLV_GenericNameComponent, 7, 'g', 'e', 'n', 'e', 'r', 'a', 'l'
+};
+static const uint8_t mgmt_faces_list[] = {
+  TLV_GenericNameComponent, 5, 'f', 'a', 'c', 'e', 's',
+  TLV_GenericNameComponent, 4, 'l', 'i', 's', 't'
+};
+static const uint8_t mgmt_rib[] = {
+  TLV_GenericNameComponent, 3, 'r', 'i', 'b'
+};
+static const uint8_t mgmt_rib_register[] = {
+  TLV_GenericNameComponent, 3, 'r', 'i', 'b',
+  TLV_GenericNameComponent, 8, 'r', 'e', 'g', 'i', 's', 't', 'e', 'r'
+};
+static const uint8_t mgmt_rib_unregister[] = {
+  TLV_GenericNameComponent, 3, 'r', 'i', 'b',
+  TLV_GenericNameComponent, 10, 'u', 'n', 'r', 'e', 'g', 'i', 's', 't', 'e', 'r'
+};
+#define MGMT_DATASET_COMPONENTS_SIZE 2
+
+// The status codes of the command responses, following NFD management
+#define MGMT_STATUS_OK 200
+#define MGMT_STATUS_MALFORMED 400
+#define MGMT_STATUS_UNAUTHORIZED 403
+#define MGMT_STATUS_FACE_NOT_FOUND 410
+#define MGMT_STATUS_TABLE_FULL 500
+
+// The fields of a ControlParameters
+typedef struct mgmt_control_parameters {
+  ndn_name_t name;
+  bool has_name;
+  uint64_t face_id;
+  bool has_face_id;
+  uint64_t origin;
+  uint64_t cost;
+  uint64_t expiration_period;
+  bool has_expiration_period;
+} mgmt_control_parameters_t;
+
+// The Data is kept out of the stack, since it holds a full Content and Name.
+// The scratch buffers are shared by the forwarders, since one answers at a time.
+static ndn_data_t mgmt_data;
+static uint8_t mgmt_buffer[MGMT_DATA_BUFFER_SIZE];
+
+// The command is decoded out of the stack, since it holds a full Name and Parameters
+static ndn_interest_t mgmt_command;
+static mgmt_control_parameters_t mgmt_params;
+
+void
+ndn_mgmt_set_signing_key(ndn_forwarder_t* self, const ndn_name_t* identity,
+                         const ndn_ecc_prv_t* prv_key)
+{
+  self->mgmt_keys.identity = identity;
+  self->mgmt_keys.prv_key = prv_key;
+}
+
+void
+ndn_mgmt_set_command_keys(ndn_forwarder_t* self, const ndn_ecc_pub_t* ecdsa_key,
+                          const ndn_hmac_key_t* hmac_key)
+{
+  self->mgmt_keys.command_ecdsa_key = ecdsa_key;
+  self->mgmt_keys.command_hmac_key = hmac_key;
+}
+
+/************************************************************/
+/*  Definition of name matching helpers                     */
+/************************************************************/
+
+// Check whether @p size components from @p start are the wire format @p components
+static bool
+mgmt_name_match(const ndn_name_view_t* name, uint8_t start, uint8_t size,
+                const uint8_t* components, uint32_t components_size)
+{
+  if (name->components_size < start + size) {
+    return false;
+  }
+  uint32_t begin = name->offsets[start];
+  uint32_t end = name->offsets[start + size];
+  if (end - begin != components_size) {
+    return false;
+  }
+  return memcmp(name->value + begin, components, components_size) == 0;
+}
+
+// Get the segment number of a component. Only segment components are accepted.
+static int
+mgmt_get_segment(const ndn_name_view_t* name, uint8_t index, uint64_t* segment)
+{
+  ndn_decoder_t decoder;
+  uint32_t type = 0;
+  uint32_t length = 0;
+  decoder_init(&decoder, name->value + name->offsets[index],
+               name->offsets[index + 1] - name->offsets[index]);
+  decoder_get_type(&decoder, &type);
+  decoder_get_length(&decoder, &length);
+  if (type != TLV_SegmentNameComponent) {
+    return NDN_WRONG_TLV_TYPE;
+  }
+  return decoder_get_uint_value(&decoder, length, segment);
+}
+
+bool
+ndn_mgmt_is_local_request(const ndn_face_intf_t* face, const ndn_name_view_t* name)
+{
+  if (mgmt_name_match(name, 0, MGMT_PREFIX_COMPONENTS_SIZE, mgmt_prefix, sizeof(mgmt_prefix))) {
+    return face->type == NDN_FACE_TYPE_APP;
+  }
+  return mgmt_name_match(name, 0, MGMT_PREFIX_COMPONENTS_SIZE,
+                         mgmt_localhop_prefix, sizeof(mgmt_localhop_prefix))
+         && mgmt_name_match(name, MGMT_PREFIX_COMPONENTS_SIZE, 1, mgmt_rib, sizeof(mgmt_rib));
+}
+
+/************************************************************/
+/*  Definition of dataset encoders                          */
+/************************************************************/
+
+static int
+mgmt_append_uint(ndn_encoder_t* encoder, uint32_t type, uint64_t value)
+{
+  int ret = encoder_append_type(encoder, type);
+  if (ret != 0) return ret;
+  ret = encoder_append_length(encoder, encoder_probe_uint_length(value));
+  if (ret != 0) return ret;
+  return encoder_append_uint_value(encoder, value);
+}
+
+static int
+mgmt_encode_general_status(const ndn_forwarder_t* self, ndn_encoder_t* encoder)
+{
+  const ndn_forwarder_counters_t* counters = &self->counters;
+  uint32_t cs_size = 0;
+  for (uint16_t i = 0; i < self->cs.capacity; i++) {
+    if (self->cs.slots[i].data != NULL) {
+      cs_size++;
+    }
+  }
+
+  int ret = mgmt_append_uint(encoder, TLV_MGMT_CurrentTimestamp, self->now);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NFibEntries, self->fib.capacity - self->fib.free_size);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NPitEntries, self->pit.capacity - self->pit.free_size);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NCsEntries, cs_size);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NInInterests, counters->packets.n_in_interests);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NInData, counters->packets.n_in_data);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NInNacks, counters->packets.n_in_nacks);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NOutInterests, counters->packets.n_out_interests);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NOutData, counters->packets.n_out_data);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NOutNacks, counters->packets.n_out_nacks);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NSatisfiedInterests, counters->n_satisfied_interests);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NUnsatisfiedInterests, counters->n_unsatisfied_interests);
+  if (ret != 0) return ret;
+
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NPitHits, counters->n_pit_hits);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NPitMisses, counters->n_pit_misses);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NPitFullDrops, counters->n_pit_full_drops);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NPitEvictions, counters->n_pit_evictions);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NPitQuotaDrops, counters->n_pit_quota_drops);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NFibMisses, counters->n_fib_misses);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NForwardingHintLookups,
+                         counters->n_forwarding_hint_lookups);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NHopLimitDrops, counters->n_hop_limit_drops);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NDuplicateNonces, counters->n_duplicate_nonces);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NUnsolicitedData, counters->n_unsolicited_data);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NRxQueueDrops,
+                         ndn_msgqueue_drops(&self->msgqueue));
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NCsHits, self->cs.hit_cnt);
+  if (ret != 0) return ret;
+  return mgmt_append_uint(encoder, TLV_MGMT_NCsMisses, self->cs.miss_cnt);
+}
+
+static int
+mgmt_encode_face_status(const ndn_face_intf_t* face, ndn_encoder_t* encoder)
+{
+  const ndn_face_counters_t* counters = &face->counters;
+  uint32_t value_size = encoder_probe_block_size(TLV_MGMT_FaceId,
+                                                 encoder_probe_uint_length(face->face_id));
+  value_size += encoder_probe_block_size(TLV_MGMT_NInInterests,
+                                         encoder_probe_uint_length(counters->n_in_interests));
+  value_size += encoder_probe_block_size(TLV_MGMT_NInData,
+                                         encoder_probe_uint_length(counters->n_in_data));
+  value_size += encoder_probe_block_size(TLV_MGMT_NInNacks,
+                                         encoder_probe_uint_length(counters->n_in_nacks));
+  value_size += encoder_probe_block_size(TLV_MGMT_NOutInterests,
+                                         encoder_probe_uint_length(counters->n_out_interests));
+  value_size += encoder_probe_block_size(TLV_MGMT_NOutData,
+                                         encoder_probe_uint_length(counters->n_out_data));
+  value_size += encoder_probe_block_size(TLV_MGMT_NOutNacks,
+                                         encoder_probe_uint_length(counters->n_out_nacks));
+
+  int ret = encoder_append_type(encoder, TLV_MGMT_FaceStatus);
+  if (ret != 0) return ret;
+  ret = encoder_append_length(encoder, value_size);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_FaceId, face->face_id);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NInInterests, counters->n_in_interests);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NInData, counters->n_in_data);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NInNacks, counters->n_in_nacks);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NOutInterests, counters->n_out_interests);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_NOutData, counters->n_out_data);
+  if (ret != 0) return ret;
+  return mgmt_append_uint(encoder, TLV_MGMT_NOutNacks, counters->n_out_nacks);
+}
+
+// Collect the faces in the face table, in the order of face IDs
+static uint8_t
+mgmt_collect_faces(const ndn_face_table_t* table, const ndn_face_intf_t** faces)
+{
+  uint8_t faces_size = 0;
+  for (uint8_t i = 0; i < NDN_FACE_TABLE_MAX_SIZE; i++) {
+    if (table->slots[i] != NULL) {
+      faces[faces_size++] = table->slots[i];
+    }
+  }
+  return faces_size;
+}
+
+// Encode a segment of the face list, and set FinalBlockId to the last segment
+static int
+mgmt_encode_faces_list(const ndn_forwarder_t* self, uint64_t segment,
+                       ndn_encoder_t* encoder, ndn_metainfo_t* meta)
+{
+  const ndn_face_intf_t* faces[NDN_FACE_TABLE_MAX_SIZE];
+  uint8_t faces_size = mgmt_collect_faces(&self->face_table, faces);
+  uint32_t last_segment = 0;
+  if (faces_size > 0) {
+    last_segment = (faces_size - 1) / MGMT_FACES_PER_SEGMENT;
+  }
+  if (segment > last_segment) {
+    return NDN_FWD_INTEREST_REJECTED;
+  }
+
+  name_component_t final_block_id;
+  ndn_encoder_t component_encoder;
+  name_component_init(&final_block_id, TLV_SegmentNameComponent);
+  encoder_init(&component_encoder, final_block_id.value, sizeof(final_block_id.value));
+  encoder_append_uint_value(&component_encoder, last_segment);
+  final_block_id.size = component_encoder.offset;
+  ndn_metainfo_set_final_block_id(meta, &final_block_id);
+
+  uint32_t end = (uint32_t)(segment + 1) * MGMT_FACES_PER_SEGMENT;
+  if (end > faces_size) {
+    end = faces_size;
+  }
+  for (uint32_t i = (uint32_t)segment * MGMT_FACES_PER_SEGMENT; i < end; i++) {
+    int ret = mgmt_encode_face_status(faces[i], encoder);
+    if (ret != 0) return ret;
+  }
+  return 0;
+}
+
+/************************************************************/
+/*  Definition of RIB command helpers                       */
+/************************************************************/
+
+// Decode a ControlParameters block
+static int
+mgmt_decode_control_parameters(const uint8_t* block, uint32_t size,
+                               mgmt_control_parameters_t* params)
+{
+  ndn_decoder_t decoder;
+  uint32_t type = 0;
+  uint32_t length = 0;
+  decoder_init(&decoder, block, size);
+  int ret = decoder_get_type(&decoder, &type);
+  if (ret != 0) return ret;
+  if (type != TLV_MGMT_ControlParameters) return NDN_WRONG_TLV_TYPE;
+  ret = decoder_get_length(&decoder, &length);
+  if (ret != 0) return ret;
+  if (decoder.offset + length > size) return NDN_WRONG_TLV_LENGTH;
+
+  params->has_name = false;
+  params->has_face_id = false;
+  params->origin = 0;
+  params->cost = 0;
+  params->has_expiration_period = false;
+  uint32_t end = decoder.offset + length;
+  while (decoder.offset < end) {
+    uint32_t start = decoder.offset;
+    if (decoder_get_type(&decoder, &type) != 0 || decoder_get_length(&decoder, &length) != 0)
+      return NDN_WRONG_TLV_LENGTH;
+    if (type == TLV_Name) {
+      decoder.offset = start;
+      ret = ndn_name_tlv_decode(&decoder, &params->name);
+      if (ret != 0) return ret;
+      params->has_name = true;
+      continue;
+    }
+    else if (type == TLV_MGMT_FaceId) {
+      ret = decoder_get_uint_value(&decoder, length, &params->face_id);
+      params->has_face_id = true;
+    }
+    else if (type == TLV_MGMT_Origin) {
+      ret = decoder_get_uint_value(&decoder, length, &params->origin);
+    }
+    else if (type == TLV_MGMT_Cost) {
+      ret = decoder_get_uint_value(&decoder, length, &params->cost);
+    }
+    else if (type == TLV_MGMT_ExpirationPeriod) {
+      ret = decoder_get_uint_value(&decoder, length, &params->expiration_period);
+      params->has_expiration_period = true;
+    }
+    else {
+      ret = decoder_move_forward(&decoder, length);
+    }
+    if (ret != 0) return ret;
+  }
+  return 0;
+}
+
+static uint32_t
+mgmt_probe_control_parameters(const mgmt_control_parameters_t* params)
+{
+  uint32_t value_size = ndn_name_probe_block_size(&params->name);
+  value_size += encoder_probe_block_size(TLV_MGMT_FaceId,
+                                         encoder_probe_uint_length(params->face_id));
+  value_size += encoder_probe_block_size(TLV_MGMT_Origin,
+                                         encoder_probe_uint_length(params->origin));
+  value_size += encoder_probe_block_size(TLV_MGMT_Cost,
+                                         encoder_probe_uint_length(params->cost));
+  if (params->has_expiration_period) {
+    value_size += encoder_probe_block_size(TLV_MGMT_ExpirationPeriod,
+                                           encoder_probe_uint_length(params->expiration_period));
+  }
+  return value_size;
+}
+
+// Encode the ControlParameters of a command, with the FaceId resolved
+static int
+mgmt_encode_control_parameters(const mgmt_control_parameters_t* params, ndn_encoder_t* encoder)
+{
+  int ret = encoder_append_type(encoder, TLV_MGMT_ControlParameters);
+  if (ret != 0) return ret;
+  ret = encoder_append_length(encoder, mgmt_probe_control_parameters(params));
+  if (ret != 0) return ret;
+  ret = ndn_name_tlv_encode(encoder, &params->name);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_FaceId, params->face_id);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_Origin, params->origin);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_Cost, params->cost);
+  if (ret != 0) return ret;
+  if (params->has_expiration_period) {
+    ret = mgmt_append_uint(encoder, TLV_MGMT_ExpirationPeriod, params->expiration_period);
+  }
+  return ret;
+}
+
+// Encode a ControlResponse, with the ControlParameters as the body if the command succeeded
+static int
+mgmt_encode_control_response(uint32_t status_code, const char* status_text,
+                             const mgmt_control_parameters_t* params, ndn_encoder_t* encoder)
+{
+  uint32_t text_size = strlen(status_text);
+  uint32_t value_size = encoder_probe_block_size(TLV_MGMT_StatusCode,
+                                                 encoder_probe_uint_length(status_code));
+  value_size += encoder_probe_block_size(TLV_MGMT_StatusText, text_size);
+  if (params != NULL) {
+    value_size += encoder_probe_block_size(TLV_MGMT_ControlParameters,
+                                           mgmt_probe_control_parameters(params));
+  }
+  int ret = encoder_append_type(encoder, TLV_MGMT_ControlResponse);
+  if (ret != 0) return ret;
+  ret = encoder_append_length(encoder, value_size);
+  if (ret != 0) return ret;
+  ret = mgmt_append_uint(encoder, TLV_MGMT_StatusCode, status_code);
+  if (ret != 0) return ret;
+  ret = encoder_append_type(encoder, TLV_MGMT_StatusText);
+  if (ret != 0) return ret;
+  ret = encoder_append_length(encoder, text_size);
+  if (ret != 0) return ret;
+  ret = encoder_append_raw_buffer_value(encoder, (const uint8_t*)status_text, text_size);
+  if (ret != 0) return ret;
+  if (params != NULL) {
+    ret = mgmt_encode_control_parameters(params, encoder);
+  }
+  return ret;
+}
+
+// Verify the signature of a command.
+// Digest signatures are only accepted from the applications on this node.
+static bool
+mgmt_verify_command(const ndn_forwarder_t* self, const ndn_interest_t* command, bool is_localhost)
+{
+  const ndn_forwarder_mgmt_keys_t* keys = &self->mgmt_keys;
+  if (!command->is_SignedInterest) {
+    return false;
+  }
+  switch (command->signature.sig_type) {
+  case NDN_SIG_TYPE_ECDSA_SHA256:
+    return keys->command_ecdsa_key != NULL
+           && ndn_signed_interest_ecdsa_verify(command, keys->command_ecdsa_key) == 0;
+  case NDN_SIG_TYPE_HMAC_SHA256:
+    return keys->command_hmac_key != NULL
+           && ndn_signed_interest_hmac_verify(command, keys->command_hmac_key) == 0;
+  case NDN_SIG_TYPE_DIGEST_SHA256:
+    return is_localhost && ndn_signed_interest_digest_verify(command) == 0;
+  default:
+    return false;
+  }
+}
+
+// Execute a RIB register or unregister command, and encode the ControlResponse
+static int
+mgmt_on_rib_command(ndn_forwarder_t* self, ndn_face_intf_t* face, bool is_localhost,
+                    bool is_register, const uint8_t* raw_interest, uint32_t size, ndn_encoder_t* encoder)
+{
+  mgmt_control_parameters_t* params = &mgmt_params;
+  if (ndn_interest_from_block(&mgmt_command, raw_interest, size) != 0
+      || !mgmt_command.enable_Parameters
+      || mgmt_decode_control_parameters(mgmt_command.parameters.value, mgmt_command.parameters.size,
+                                        params) != 0
+      || !params->has_name) {
+    return mgmt_encode_control_response(MGMT_STATUS_MALFORMED, "Malformed command", NULL, encoder);
+  }
+  if (!mgmt_verify_command(self, &mgmt_command, is_localhost)) {
+    return mgmt_encode_control_response(MGMT_STATUS_UNAUTHORIZED, "Unauthorized", NULL, encoder);
+  }
+
+  // Without a FaceId, the route goes through the face sending the command
+  ndn_face_intf_t* nexthop = face;
+  if (params->has_face_id) {
+    nexthop = params->face_id < NDN_INVALID_FACE_ID ? forwarder_get_face(self, params->face_id) : NULL;
+  }
+  if (nexthop == NULL) {
+    return mgmt_encode_control_response(MGMT_STATUS_FACE_NOT_FOUND, "Face not found", NULL, encoder);
+  }
+  params->face_id = nexthop->face_id;
+  if (params->origin > UINT16_MAX) {
+    params->origin = UINT16_MAX;
+  }
+  if (params->cost > UINT8_MAX) {
+    params->cost = UINT8_MAX;
+  }
+  if (params->has_expiration_period && params->expiration_period > NDN_RIB_MAX_EXPIRATION_PERIOD) {
+    params->expiration_period = NDN_RIB_MAX_EXPIRATION_PERIOD;
+  }
+
+  if (is_register) {
+    uint64_t lifetime = params->has_expiration_period ? params->expiration_period : NDN_RIB_NEVER_EXPIRE;
+    int ret = forwarder_rib_register(self, &params->name, nexthop, (uint16_t)params->origin,
+                                     (uint8_t)params->cost, lifetime);
+    if (ret != 0) {
+      return mgmt_encode_control_response(MGMT_STATUS_TABLE_FULL, "Table full", NULL, encoder);
+    }
+  }
+  else {
+    // Unregistering a route that does not exist succeeds, as in NFD
+    forwarder_rib_unregister(self, &params->name, nexthop, (uint16_t)params->origin);
+  }
+  return mgmt_encode_control_response(MGMT_STATUS_OK, "OK", params, encoder);
+}
+
+/************************************************************/
+/*  Definition of management APIs                           */
+/************************************************************/
+
+int
+ndn_mgmt_on_interest(ndn_forwarder_t* self, ndn_face_intf_t* face, const ndn_name_view_t* name,
+                     const uint8_t* raw_interest, uint32_t size)
+{
+  const uint8_t dataset = MGMT_PREFIX_COMPONENTS_SIZE;
+  const uint8_t rest = MGMT_PREFIX_COMPONENTS_SIZE + MGMT_DATASET_COMPONENTS_SIZE;
+
+  int ret = ndn_name_from_view(&mgmt_data.name, name);
+  if (ret != 0) {
+    return NDN_FWD_INTEREST_REJECTED;
+  }
+  ndn_metainfo_init(&mgmt_data.metainfo);
+  ndn_metainfo_set_freshness_period(&mgmt_data.metainfo, MGMT_FRESHNESS_PERIOD);
+
+  ndn_encoder_t encoder;
+  bool is_localhost = mgmt_name_match(name, 0, MGMT_PREFIX_COMPONENTS_SIZE,
+                                      mgmt_prefix, sizeof(mgmt_prefix));
+  encoder_init(&encoder, mgmt_data.content_value, sizeof(mgmt_data.content_value));
+  if (mgmt_name_match(name, dataset, MGMT_DATASET_COMPONENTS_SIZE,
+                      mgmt_rib_register, sizeof(mgmt_rib_register))) {
+    ret = mgmt_on_rib_command(self, face, is_localhost, true, raw_interest, size, &encoder);
+  }
+  else if (mgmt_name_match(name, dataset, MGMT_DATASET_COMPONENTS_SIZE,
+                           mgmt_rib_unregister, sizeof(mgmt_rib_unregister))) {
+    ret = mgmt_on_rib_command(self, face, is_localhost, false, raw_interest, size, &encoder);
+  }
+  else if (!is_localhost) {
+    return NDN_FWD_INTEREST_REJECTED;
+  }
+  else if (mgmt_name_match(name, dataset, MGMT_DATASET_COMPONENTS_SIZE,
+                           mgmt_status_general, sizeof(mgmt_status_general))
+           && name->components_size == rest) {
+    ret = mgmt_encode_general_status(self, &encoder);
+  }
+  else if (mgmt_name_match(name, dataset, MGMT_DATASET_COMPONENTS_SIZE,
+                           mgmt_faces_list, sizeof(mgmt_faces_list))
+           && name->components_size <= rest + 1) {
+    uint64_t segment = 0;
+    if (name->components_size > rest && mgmt_get_segment(name, rest, &segment) != 0) {
+      return NDN_FWD_INTEREST_REJECTED;
+    }
+    ret = mgmt_encode_faces_list(self, segment, &encoder, &mgmt_data.metainfo);
+  }
+  else {
+    return NDN_FWD_INTEREST_REJECTED;
+  }
+  if (ret != 0) {
+    return ret;
+  }
+  mgmt_data.content_size = encoder.offset;
+
+  encoder_init(&encoder, mgmt_buffer, sizeof(mgmt_buffer));
+  if (self->mgmt_keys.prv_key != NULL) {
+    ret = ndn_data_tlv_encode_ecdsa_sign(&encoder, &mgmt_data, self->mgmt_keys.identity,
+                                         self->mgmt_keys.prv_key);
+  }
+  else {
+    ret = ndn_data_tlv_encode_digest_sign(&encoder, &mgmt_data);
+  }
+  if (ret != 0) {
+    return ret;
+  }
+  return ndn_face_send(face, NULL, mgmt_buffer, encoder.offset);
+}
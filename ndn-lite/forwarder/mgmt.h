@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef FORWARDER_MGMT_H_
+#define FORWARDER_MGMT_H_
+
+#include "forwarder.h"
+#include "../security/ndn-lite-ecc.h"
+#include "../security/ndn-lite-hmac.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The management module of the forwarder.
+ * The forwarder answers the Interests under /localhost/nfd from the app faces itself,
+ * following the status datasets of NFD management:
+ *   - /localhost/nfd/status/general: the forwarder status, whose Content holds the
+ *     table sizes and the counters of ndn_forwarder_counters_t.
+ *   - /localhost/nfd/faces/list[/<segment>]: a FaceStatus block with the counters of each
+ *     face. The list is segmented to fit the Content of a Data, and the last segment
+ *     is given by FinalBlockId.
+ * It also serves the RIB commands of NFD management, sent by applications under
+ * /localhost/nfd or by neighbors, e.g., a routing controller, under /localhop/nfd:
+ *   - rib/register and rib/unregister: the command is a Signed Interest whose Parameters
+ *     hold a ControlParameters block with Name, and optionally FaceId, Origin, Cost and
+ *     ExpirationPeriod. Without a FaceId, the route goes through the face the command
+ *     came from. The Content of the Data is a ControlResponse.
+ *   - A command is executed if its signature is verified by a key set with
+ *     ndn_mgmt_set_command_keys(). DigestSha256 is only accepted under /localhost.
+ * The Data carries the name of the Interest, and is signed by a DigestSha256 signature
+ * unless a key is set by ndn_mgmt_set_signing_key().
+ * The keys are set for each forwarder. The Data and the command are decoded and encoded in
+ * static buffers shared by all the forwarders of a program, so ndn_mgmt_on_interest() must
+ * not be invoked by two threads at the same time, nor by an app callback of the Data it sends.
+ */
+
+/**
+ * Set the key signing the status datasets.
+ * @param self. Input/Output. The forwarder.
+ * @param identity. Input. The identity name put in the KeyLocator. The name is not copied,
+ *        so it should live as long as it is used.
+ * @param prv_key. Input. The private ECC key. NULL to use the DigestSha256 signature.
+ */
+void
+ndn_mgmt_set_signing_key(ndn_forwarder_t* self, const ndn_name_t* identity,
+                         const ndn_ecc_prv_t* prv_key);
+
+/**
+ * Set the keys authenticating the RIB commands.
+ * The keys are not copied, so they should live as long as they are used.
+ * @param self. Input/Output. The forwarder.
+ * @param ecdsa_key. Input. The ECC public key verifying ECDSA signatures. NULL to reject them.
+ * @param hmac_key. Input. The HMAC key verifying HMAC signatures. NULL to reject them.
+ */
+void
+ndn_mgmt_set_command_keys(ndn_forwarder_t* self, const ndn_ecc_pub_t* ecdsa_key,
+                          const ndn_hmac_key_t* hmac_key);
+
+/**
+ * Check whether an Interest should be answered by the management module.
+ * Interests under /localhost are only accepted from the app faces, since /localhost is
+ * limited to the node. RIB commands under /localhop are accepted from any face.
+ * @param face. Input. The face the Interest came from.
+ * @param name. Input. The name of the Interest.
+ * @return true if the Interest is under the management prefix.
+ */
+bool
+ndn_mgmt_is_local_request(const ndn_face_intf_t* face, const ndn_name_view_t* name);
+
+/**
+ * Answer an Interest under the management prefix.
+ * The Data is sent back to the face directly, without going through the PIT and the CS.
+ * @param self. Input. The forwarder whose status is published.
+ * @param face. Input. The face the Interest came from.
+ * @param name. Input. The name of the Interest.
+ * @param raw_interest. Input. The wire format Interest.
+ * @param size. Input. The size of the wire format Interest.
+ * @return 0 if there is no error. NDN_FWD_INTEREST_REJECTED if no dataset has the name,
+ *         in which case the caller Nacks the Interest.
+ */
+int
+ndn_mgmt_on_interest(ndn_forwarder_t* self, ndn_face_intf_t* face, const ndn_name_view_t* name,
+                     const uint8_t* raw_interest, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FORWARDER_MGMT_H_
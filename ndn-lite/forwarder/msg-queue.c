@@ -5,95 +5,141 @@
  * General Public License v2.1. See the file LICENSE in the top level
  * directory for more details.
  */
- 
+
 #include "msg-queue.h"
 #include <string.h>
 
+// Messages are aligned, so that the headers and the parameters can be accessed in place
+#define MSGQUEUE_ALIGN 8
+#define MSGQUEUE_ALIGN_UP(size) (((size) + MSGQUEUE_ALIGN - 1) & ~(size_t)(MSGQUEUE_ALIGN - 1))
+
 typedef struct ndn_msg{
+  /**
+   * The callback, stored last by the poster.
+   * NULL for a message being posted, or msgqueue_padding for the padding before a wrap.
+   */
+  _Atomic(ndn_msg_callback) func;
   void* obj;
-  ndn_msg_callback func;
   size_t length;
+  size_t param_length;
   uint8_t param[];
 } ndn_msg_t;
 
-static uint8_t msg_queue[NDN_MSGQUEUE_SIZE];
-static ndn_msg_t *pfront, *ptail;
+#define MSGQUEUE_HEADER_SIZE MSGQUEUE_ALIGN_UP(sizeof(ndn_msg_t))
 
-#define MSGQUEUE_NEXT(ptr) \
-  ptr = (ndn_msg_t*)(((uint8_t*)ptr) + ptr->length); \
-  if(((uint8_t*)ptr) >= &msg_queue[NDN_MSGQUEUE_SIZE]){ \
-    ptr = (ndn_msg_t*)&msg_queue[0]; \
-  };
+/**
+ * A poster reserves space by moving @p tail with a compare-and-swap, and stores the
+ * callback after the rest of the message. The dispatcher stops at a message whose callback
+ * is still NULL, and zeroes the messages it has dispatched, so that a reserved message
+ * always reads NULL until it is complete.
+ * A message never wraps around the end of the ring. The space before the end is padded,
+ * by a padding message if it can hold the header, or implicitly otherwise.
+ */
+#define MSGQUEUE_AT(self, pos) ((ndn_msg_t*)&(self)->ring.bytes[(pos) % NDN_MSGQUEUE_SIZE])
 
+// The callback of a padding message, which is never invoked but marks the padding
+static void
+msgqueue_padding(void *self, size_t param_length, void *param)
+{
+  (void)self;
+  (void)param_length;
+  (void)param;
+}
 
 void
-ndn_msgqueue_init(void) {
-  pfront = ptail = (ndn_msg_t*)&msg_queue;
+ndn_msgqueue_init(ndn_msgqueue_t* self) {
+  memset(self->ring.bytes, 0, sizeof(self->ring.bytes));
+  atomic_store(&self->front, 0);
+  atomic_store(&self->tail, 0);
+  atomic_store(&self->drops, 0);
 }
 
 bool
-ndn_msgqueue_empty(void) {
-  if(pfront->func == NDN_MSG_PADDING && pfront != ptail){
-    pfront = (ndn_msg_t*)&msg_queue;
-  }
-  if(pfront == ptail){
-    // defrag when empty
-    pfront = ptail = (ndn_msg_t*)&msg_queue[0];
-    return true;
-  } else
-    return false;
+ndn_msgqueue_empty(ndn_msgqueue_t* self) {
+  return atomic_load_explicit(&self->front, memory_order_relaxed)
+         == atomic_load_explicit(&self->tail, memory_order_acquire);
+}
+
+uint32_t
+ndn_msgqueue_drops(const ndn_msgqueue_t* self) {
+  return atomic_load_explicit(&self->drops, memory_order_relaxed);
 }
 
 bool
-ndn_msgqueue_dispatch(void) {
-  if(ndn_msgqueue_empty())
-    return false;
-  
-  pfront->func(pfront->obj, pfront->length - sizeof(ndn_msg_t), pfront->param);
-  MSGQUEUE_NEXT(pfront);
-  return true;
+ndn_msgqueue_dispatch(ndn_msgqueue_t* self) {
+  uint32_t pos = atomic_load_explicit(&self->front, memory_order_relaxed);
+  while(pos != atomic_load_explicit(&self->tail, memory_order_acquire)){
+    uint32_t rest = NDN_MSGQUEUE_SIZE - pos % NDN_MSGQUEUE_SIZE;
+    if(rest < MSGQUEUE_HEADER_SIZE){
+      // implicit padding
+      pos += rest;
+      atomic_store_explicit(&self->front, pos, memory_order_release);
+      continue;
+    }
+
+    ndn_msg_t* msg = MSGQUEUE_AT(self, pos);
+    ndn_msg_callback func = atomic_load_explicit(&msg->func, memory_order_acquire);
+    if(func == NULL){
+      // still being posted
+      return false;
+    }
+    if(func != msgqueue_padding){
+      func(msg->obj, msg->param_length, msg->param);
+    }
+
+    size_t length = msg->length;
+    memset(msg, 0, length);
+    pos += length;
+    atomic_store_explicit(&self->front, pos, memory_order_release);
+    if(func != msgqueue_padding){
+      return true;
+    }
+  }
+  return false;
 }
 
 bool
-ndn_msgqueue_post(void *target,
+ndn_msgqueue_post(ndn_msgqueue_t* self,
+                  void *target,
                   ndn_msg_callback reason,
                   size_t param_length,
                   void *param)
 {
-  size_t len = param_length + sizeof(ndn_msg_t);
-  size_t space;
-
-  // defrag the memory
-  ndn_msgqueue_empty();
-  
-  if(pfront > ptail) {
-    // -1 is to prevent (ptail == pfront) after call
-    space = ((uint8_t*)pfront) - ((uint8_t*)ptail) - 1;
-  } else {
-    space = (&msg_queue[NDN_MSGQUEUE_SIZE] - ((uint8_t*)ptail));
+  size_t len = MSGQUEUE_ALIGN_UP(MSGQUEUE_HEADER_SIZE + param_length);
+  uint32_t pos = atomic_load_explicit(&self->tail, memory_order_relaxed);
+  uint32_t padding;
+
+  if(len > NDN_MSGQUEUE_SIZE){
+    atomic_fetch_add_explicit(&self->drops, 1, memory_order_relaxed);
+    return false;
   }
-  
-  // After tail?
-  if(pfront >= ptail || space >= len){
-    // No-padding (= is to prevent ptail == pfront after call)
-    if(space < len || (space == len && pfront == (ndn_msg_t*)&msg_queue))
-      return false;
-  } else {
-    // Padding & rewind (= is to prevent ptail == pfront after call)
-    if(((uint8_t*)pfront) - &msg_queue[0] <= len)
+
+  // Reserve the padding and the message
+  do {
+    uint32_t rest = NDN_MSGQUEUE_SIZE - pos % NDN_MSGQUEUE_SIZE;
+    padding = (rest < len) ? rest : 0;
+    uint32_t used = pos - atomic_load_explicit(&self->front, memory_order_acquire);
+    if(used + padding + len > NDN_MSGQUEUE_SIZE){
+      atomic_fetch_add_explicit(&self->drops, 1, memory_order_relaxed);
       return false;
-    
-    ptail->func = NDN_MSG_PADDING;
-    ptail->length = space;
-    
-    ptail = (ndn_msg_t*)&msg_queue[0];
+    }
+  } while(!atomic_compare_exchange_weak_explicit(&self->tail, &pos, pos + padding + len,
+                                                memory_order_relaxed, memory_order_relaxed));
+
+  if(padding >= MSGQUEUE_HEADER_SIZE){
+    ndn_msg_t* pad = MSGQUEUE_AT(self, pos);
+    pad->obj = NULL;
+    pad->length = padding;
+    pad->param_length = 0;
+    atomic_store_explicit(&pad->func, msgqueue_padding, memory_order_release);
   }
-  
-  ptail->obj = target;
-  ptail->func = reason;
-  ptail->length = len;
-  memcpy(ptail->param, param, param_length);
-  MSGQUEUE_NEXT(ptail);
-  
+
+  ndn_msg_t* msg = MSGQUEUE_AT(self, pos + padding);
+  msg->obj = target;
+  msg->length = len;
+  msg->param_length = param_length;
+  memcpy(msg->param, param, param_length);
+  atomic_store_explicit(&msg->func, reason, memory_order_release);
+
   return true;
 }
@@ -11,6 +11,8 @@
 
 #include <inttypes.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -18,29 +20,86 @@ extern "C" {
 
 /**
  * The size of message queue in bytes.
+ * It should be a power of two.
  */
 #define NDN_MSGQUEUE_SIZE 4096
 
-#define NDN_MSG_PADDING (void*)(-1)
-
+/**
+ * The message queue defers work from interrupt handlers to the main loop.
+ * A message is a callback with a copy of its parameter. Messages can be posted from
+ * several contexts at the same time, e.g., the main loop and radio interrupt handlers,
+ * without a lock, while they are dispatched by the main loop only.
+ */
 typedef void(*ndn_msg_callback)(void *self,
                                 size_t param_length,
                                 void *param);
 
+/**
+ * The class of message queue.
+ * Each forwarder owns one, so that several forwarders can run in one program.
+ * The queue is a ring of bytes. @p front and @p tail count the bytes dispatched and
+ * reserved, and wrap around with uint32_t, which NDN_MSGQUEUE_SIZE divides.
+ * @p drops counts the messages refused because the queue was full.
+ */
+typedef struct ndn_msgqueue {
+  union {
+    uint8_t bytes[NDN_MSGQUEUE_SIZE];
+    uint64_t align;
+  } ring;
+  _Atomic uint32_t front;
+  _Atomic uint32_t tail;
+  _Atomic uint32_t drops;
+} ndn_msgqueue_t;
+
+/**
+ * Init an empty message queue.
+ * @param self. Output. The message queue to be inited.
+ */
 void
-ndn_msgqueue_init(void);
+ndn_msgqueue_init(ndn_msgqueue_t* self);
 
+/**
+ * Post a message.
+ * This function can be invoked from interrupt handlers.
+ * @param self. Input/Output. The message queue.
+ * @param target. Input. The first argument of the callback.
+ * @param reason. Input. The callback.
+ * @param param_length. Input. The size of @p param.
+ * @param param. Input. The parameter, copied into the queue.
+ * @return true if the message is posted. false if the queue is full.
+ */
 bool
-ndn_msgqueue_post(void *target,
+ndn_msgqueue_post(ndn_msgqueue_t* self,
+                  void *target,
                   ndn_msg_callback reason,
                   size_t param_length,
                   void *param);
-  
+
+/**
+ * Invoke the callback of the oldest message and remove the message.
+ * The parameter passed to the callback stays valid until the callback returns.
+ * This function must not be invoked from several contexts, nor by a callback.
+ * @param self. Input/Output. The message queue.
+ * @return true if a message is dispatched. false if there is no complete message.
+ */
 bool
-ndn_msgqueue_dispatch(void);
+ndn_msgqueue_dispatch(ndn_msgqueue_t* self);
 
+/**
+ * Check whether there is no message in the queue.
+ * @param self. Input. The message queue.
+ * @return true if the queue is empty.
+ */
 bool
-ndn_msgqueue_empty(void);
+ndn_msgqueue_empty(ndn_msgqueue_t* self);
+
+/**
+ * Get the number of messages refused by ndn_msgqueue_post because the queue was full.
+ * @param self. Input. The message queue.
+ * @return the number of refused messages, wrapping around with uint32_t.
+ */
+uint32_t
+ndn_msgqueue_drops(const ndn_msgqueue_t* self);
 
 #ifdef __cplusplus
 }
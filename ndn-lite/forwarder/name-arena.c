@@ -0,0 +1,305 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include "name-arena.h"
+
+// A block of the arena: a header, followed by the component offsets and the components
+// of a name if it is in use. Blocks tile the whole buffer, and no two free blocks are
+// adjacent. A free block keeps the links of its free list in place of the offsets, and
+// its size in its last two bytes, so that the block after it can find it.
+typedef struct name_arena_block {
+  uint16_t block_size;
+  uint8_t flags;
+  uint8_t components_size;
+  uint16_t offsets[];
+} name_arena_block_t;
+
+#define NAME_ARENA_IN_USE 1
+#define NAME_ARENA_PREV_IN_USE 2
+
+// The header, the two links and the trailing size of a free block
+#define NAME_ARENA_MIN_BLOCK_SIZE 10
+// A free block is split only if the rest can still keep a short name
+#define NAME_ARENA_MIN_SPLIT_SIZE 16
+
+static inline name_arena_block_t*
+name_arena_block(const ndn_name_arena_t* arena, ndn_name_ref_t ref)
+{
+  return (name_arena_block_t*)(arena->buffer + ref);
+}
+
+static inline const uint8_t*
+name_arena_block_value(const name_arena_block_t* block)
+{
+  return (const uint8_t*)&block->offsets[block->components_size + 1];
+}
+
+static inline uint16_t
+name_arena_block_value_size(const name_arena_block_t* block)
+{
+  return block->offsets[block->components_size];
+}
+
+// Blocks below 128 bytes are classed by 8 bytes, and the larger ones by powers of two
+static inline uint8_t
+name_arena_class(uint16_t size)
+{
+  if (size < 128) {
+    return (uint8_t)(size >> 3);
+  }
+  uint8_t log = 7;
+  while ((size >> (log + 1)) != 0) {
+    log++;
+  }
+  return (uint8_t)(16 + log - 7);
+}
+
+// The index of the lowest bit set in a non-zero bitmap
+static inline uint8_t
+name_arena_first_bit(uint32_t bits)
+{
+#if defined(__GNUC__)
+  return (uint8_t)__builtin_ctz(bits);
+#else
+  uint8_t index = 0;
+  while ((bits & 1) == 0) {
+    bits >>= 1;
+    index++;
+  }
+  return index;
+#endif
+}
+
+static void
+name_arena_link_free(ndn_name_arena_t* arena, ndn_name_ref_t ref)
+{
+  name_arena_block_t* block = name_arena_block(arena, ref);
+  uint8_t size_class = name_arena_class(block->block_size);
+  ndn_name_ref_t head = arena->free_heads[size_class];
+  block->flags &= ~NAME_ARENA_IN_USE;
+  block->offsets[0] = head;
+  block->offsets[1] = NDN_NAME_REF_NULL;
+  if (head != NDN_NAME_REF_NULL) {
+    name_arena_block(arena, head)->offsets[1] = ref;
+  }
+  arena->free_heads[size_class] = ref;
+  arena->free_classes |= (uint32_t)1 << size_class;
+  *(uint16_t*)(arena->buffer + ref + block->block_size - sizeof(uint16_t)) = block->block_size;
+}
+
+static void
+name_arena_unlink_free(ndn_name_arena_t* arena, ndn_name_ref_t ref)
+{
+  name_arena_block_t* block = name_arena_block(arena, ref);
+  uint8_t size_class = name_arena_class(block->block_size);
+  ndn_name_ref_t next = block->offsets[0];
+  ndn_name_ref_t prev = block->offsets[1];
+  if (prev != NDN_NAME_REF_NULL) {
+    name_arena_block(arena, prev)->offsets[0] = next;
+  }
+  else {
+    arena->free_heads[size_class] = next;
+    if (next == NDN_NAME_REF_NULL) {
+      arena->free_classes &= ~((uint32_t)1 << size_class);
+    }
+  }
+  if (next != NDN_NAME_REF_NULL) {
+    name_arena_block(arena, next)->offsets[1] = prev;
+  }
+}
+
+// Take a free block of at least size bytes and mark it in use: the first block of the
+// class of the size if it is large enough, or else any block of a larger class
+static ndn_name_ref_t
+name_arena_alloc(ndn_name_arena_t* arena, uint32_t size)
+{
+  size = (size + 1) & ~1u;
+  if (size < NAME_ARENA_MIN_BLOCK_SIZE) {
+    size = NAME_ARENA_MIN_BLOCK_SIZE;
+  }
+  if (size > arena->size) {
+    return NDN_NAME_REF_NULL;
+  }
+  uint8_t size_class = name_arena_class((uint16_t)size);
+  ndn_name_ref_t ref = arena->free_heads[size_class];
+  if (ref == NDN_NAME_REF_NULL || name_arena_block(arena, ref)->block_size < size) {
+    uint32_t larger = arena->free_classes & ~(((uint32_t)2 << size_class) - 1);
+    if (larger == 0) {
+      return NDN_NAME_REF_NULL;
+    }
+    ref = arena->free_heads[name_arena_first_bit(larger)];
+  }
+  name_arena_unlink_free(arena, ref);
+  name_arena_block_t* block = name_arena_block(arena, ref);
+  uint16_t next = ref + block->block_size;
+  if (block->block_size - size >= NAME_ARENA_MIN_SPLIT_SIZE) {
+    name_arena_block_t* rest = name_arena_block(arena, ref + size);
+    rest->block_size = block->block_size - size;
+    rest->flags = NAME_ARENA_PREV_IN_USE;
+    block->block_size = size;
+    name_arena_link_free(arena, ref + size);
+  }
+  else if (next < arena->size) {
+    name_arena_block(arena, next)->flags |= NAME_ARENA_PREV_IN_USE;
+  }
+  block->flags |= NAME_ARENA_IN_USE;
+  return ref;
+}
+
+void
+name_arena_init(ndn_name_arena_t* arena, void* buffer, uint16_t size)
+{
+  arena->buffer = (uint8_t*)buffer;
+  arena->size = size & ~1u;
+  for (uint8_t i = 0; i < NDN_NAME_ARENA_CLASSES; i++) {
+    arena->free_heads[i] = NDN_NAME_REF_NULL;
+  }
+  arena->free_classes = 0;
+  if (arena->size >= NAME_ARENA_MIN_BLOCK_SIZE) {
+    name_arena_block_t* block = name_arena_block(arena, 0);
+    block->block_size = arena->size;
+    block->flags = NAME_ARENA_PREV_IN_USE;
+    name_arena_link_free(arena, 0);
+  }
+}
+
+// The bytes a block keeping the name of a Name view needs, before rounding
+static inline uint32_t
+name_arena_view_block_size(const ndn_name_view_t* name)
+{
+  return sizeof(name_arena_block_t) + (name->components_size + 1) * sizeof(uint16_t)
+         + name->offsets[name->components_size];
+}
+
+bool
+name_arena_can_store(const ndn_name_arena_t* arena, const ndn_name_view_t* name)
+{
+  // the released blocks are merged, so an empty arena is one block of the whole buffer
+  return arena->size >= NAME_ARENA_MIN_BLOCK_SIZE
+         && ((name_arena_view_block_size(name) + 1) & ~1u) <= arena->size;
+}
+
+ndn_name_ref_t
+name_arena_store(ndn_name_arena_t* arena, const ndn_name_view_t* name)
+{
+  uint32_t offsets_size = (name->components_size + 1) * sizeof(uint16_t);
+  uint16_t value_size = name->offsets[name->components_size];
+  ndn_name_ref_t ref = name_arena_alloc(arena, name_arena_view_block_size(name));
+  if (ref == NDN_NAME_REF_NULL) {
+    return NDN_NAME_REF_NULL;
+  }
+  name_arena_block_t* block = name_arena_block(arena, ref);
+  block->components_size = name->components_size;
+  memcpy(block->offsets, name->offsets, offsets_size);
+  memcpy((uint8_t*)name_arena_block_value(block), name->value, value_size);
+  return ref;
+}
+
+ndn_name_ref_t
+name_arena_store_name(ndn_name_arena_t* arena, const ndn_name_t* name)
+{
+  uint32_t offsets_size = (name->components_size + 1) * sizeof(uint16_t);
+  uint32_t value_size = 0;
+  for (uint8_t i = 0; i < name->components_size; i++) {
+    value_size += name_component_probe_block_size(&name->components[i]);
+  }
+  ndn_name_ref_t ref = name_arena_alloc(arena, sizeof(name_arena_block_t) + offsets_size + value_size);
+  if (ref == NDN_NAME_REF_NULL) {
+    return NDN_NAME_REF_NULL;
+  }
+  name_arena_block_t* block = name_arena_block(arena, ref);
+  block->components_size = name->components_size;
+  ndn_encoder_t encoder;
+  encoder_init(&encoder, (uint8_t*)name_arena_block_value(block), value_size);
+  for (uint8_t i = 0; i < name->components_size; i++) {
+    block->offsets[i] = encoder.offset;
+    name_component_tlv_encode(&encoder, &name->components[i]);
+  }
+  block->offsets[name->components_size] = value_size;
+  return ref;
+}
+
+void
+name_arena_release(ndn_name_arena_t* arena, ndn_name_ref_t ref)
+{
+  if (ref == NDN_NAME_REF_NULL) {
+    return;
+  }
+  name_arena_block_t* block = name_arena_block(arena, ref);
+  uint16_t size = block->block_size;
+  uint16_t next = ref + size;
+  if (next < arena->size && !(name_arena_block(arena, next)->flags & NAME_ARENA_IN_USE)) {
+    name_arena_unlink_free(arena, next);
+    size += name_arena_block(arena, next)->block_size;
+  }
+  if (!(block->flags & NAME_ARENA_PREV_IN_USE)) {
+    uint16_t prev_size = *(const uint16_t*)(arena->buffer + ref - sizeof(uint16_t));
+    ref -= prev_size;
+    name_arena_unlink_free(arena, ref);
+    size += prev_size;
+    block = name_arena_block(arena, ref);
+  }
+  // the block before a free block is in use, as free neighbors are always merged
+  block->block_size = size;
+  block->flags = NAME_ARENA_PREV_IN_USE;
+  if (ref + size < arena->size) {
+    name_arena_block(arena, ref + size)->flags &= ~NAME_ARENA_PREV_IN_USE;
+  }
+  name_arena_link_free(arena, ref);
+}
+
+void
+name_arena_get_view(const ndn_name_arena_t* arena, ndn_name_ref_t ref, ndn_name_view_t* view)
+{
+  const name_arena_block_t* block = name_arena_block(arena, ref);
+  view->value = name_arena_block_value(block);
+  view->components_size = block->components_size;
+  memcpy(view->offsets, block->offsets, (block->components_size + 1) * sizeof(uint16_t));
+}
+
+uint8_t
+name_arena_components_size(const ndn_name_arena_t* arena, ndn_name_ref_t ref)
+{
+  return name_arena_block(arena, ref)->components_size;
+}
+
+// Names are kept in the canonical TLV encoding, so comparing the bytes is enough
+int
+name_arena_compare_view(const ndn_name_arena_t* arena, ndn_name_ref_t ref,
+                        const ndn_name_view_t* view)
+{
+  const name_arena_block_t* block = name_arena_block(arena, ref);
+  uint16_t value_size = name_arena_block_value_size(block);
+  if (value_size != view->offsets[view->components_size]) {
+    return -1;
+  }
+  return memcmp(name_arena_block_value(block), view->value, value_size) == 0 ? 0 : -1;
+}
+
+int
+name_arena_compare_name(const ndn_name_arena_t* arena, ndn_name_ref_t ref,
+                        const ndn_name_t* name)
+{
+  ndn_name_view_t view;
+  name_arena_get_view(arena, ref, &view);
+  return ndn_name_view_compare_name(&view, name);
+}
+
+// A sequence of whole component TLVs that begins the view's value is a prefix of it
+int
+name_arena_is_prefix_of_view(const ndn_name_arena_t* arena, ndn_name_ref_t ref,
+                             const ndn_name_view_t* view)
+{
+  const name_arena_block_t* block = name_arena_block(arena, ref);
+  uint16_t value_size = name_arena_block_value_size(block);
+  if (block->components_size > view->components_size
+      || value_size != view->offsets[block->components_size]) {
+    return 1;
+  }
+  return memcmp(name_arena_block_value(block), view->value, value_size) == 0 ? 0 : 1;
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef FORWARDER_NAME_ARENA_H_
+#define FORWARDER_NAME_ARENA_H_
+
+#include "../encode/name.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The reference to a name kept in a name arena, i.e., its offset in the arena.
+ */
+typedef uint16_t ndn_name_ref_t;
+
+/**
+ * The reference to no name, which also marks an empty table entry.
+ */
+#define NDN_NAME_REF_NULL ((ndn_name_ref_t)(-1))
+
+/**
+ * The number of size classes of the free blocks of a name arena.
+ */
+#define NDN_NAME_ARENA_CLASSES 25
+
+/**
+ * The class of name arenas.
+ * A name arena keeps names in their compact form: the TLV encoded components plus
+ * a table of component offsets, so that a name takes as many bytes as it needs
+ * instead of sizeof(ndn_name_t). Neither the number of components (up to
+ * NDN_NAME_VIEW_COMPONENTS_SIZE) nor the size of a component is limited as in ndn_name_t.
+ * Names are allocated from a caller provided buffer. The free blocks are kept in lists by
+ * size class, so that allocating a name takes constant time, and a released block is
+ * merged with its free neighbors at once.
+ */
+typedef struct ndn_name_arena {
+  /**
+   * The buffer keeping the names. It must be 2-byte aligned.
+   */
+  uint8_t* buffer;
+
+  /**
+   * The size of @p buffer, no more than 65534 bytes.
+   */
+  uint16_t size;
+
+  /**
+   * The first free block of each size class. NDN_NAME_REF_NULL if there is none.
+   */
+  ndn_name_ref_t free_heads[NDN_NAME_ARENA_CLASSES];
+
+  /**
+   * The bitmap of the size classes having free blocks.
+   */
+  uint32_t free_classes;
+} ndn_name_arena_t;
+
+/**
+ * Init an empty name arena.
+ * @param arena. Output. The name arena to be inited.
+ * @param buffer. Input. The 2-byte aligned buffer keeping the names.
+ * @param size. Input. The size of @p buffer.
+ */
+void
+name_arena_init(ndn_name_arena_t* arena, void* buffer, uint16_t size);
+
+/**
+ * Copy the name referred by a Name view into a name arena.
+ * @param arena. Input/Output. The name arena.
+ * @param name. Input. The Name view.
+ * @return the reference to the stored name. NDN_NAME_REF_NULL if the arena is full.
+ */
+ndn_name_ref_t
+name_arena_store(ndn_name_arena_t* arena, const ndn_name_view_t* name);
+
+/**
+ * Copy a Name into a name arena.
+ * @param arena. Input/Output. The name arena.
+ * @param name. Input. The Name.
+ * @return the reference to the stored name. NDN_NAME_REF_NULL if the arena is full.
+ */
+ndn_name_ref_t
+name_arena_store_name(ndn_name_arena_t* arena, const ndn_name_t* name);
+
+/**
+ * Check whether a name fits in a name arena once all the names kept are released.
+ * A name failing this check is never stored, however many names are released.
+ * @param arena. Input. The name arena.
+ * @param name. Input. The Name view.
+ * @return true if @p name fits in the empty arena.
+ */
+bool
+name_arena_can_store(const ndn_name_arena_t* arena, const ndn_name_view_t* name);
+
+/**
+ * Release a name kept in a name arena.
+ * @param arena. Input/Output. The name arena.
+ * @param ref. Input. The reference to the name. Nothing happens if it is NDN_NAME_REF_NULL.
+ */
+void
+name_arena_release(ndn_name_arena_t* arena, ndn_name_ref_t ref);
+
+/**
+ * Get the view of a name kept in a name arena.
+ * @param arena. Input. The name arena.
+ * @param ref. Input. The reference to the name.
+ * @param view. Output. The Name view, valid until the name is released.
+ */
+void
+name_arena_get_view(const ndn_name_arena_t* arena, ndn_name_ref_t ref, ndn_name_view_t* view);
+
+/**
+ * Get the number of components of a name kept in a name arena.
+ * @param arena. Input. The name arena.
+ * @param ref. Input. The reference to the name.
+ * @return the number of components.
+ */
+uint8_t
+name_arena_components_size(const ndn_name_arena_t* arena, ndn_name_ref_t ref);
+
+/**
+ * Compare a name kept in a name arena with a Name view.
+ * @param arena. Input. The name arena.
+ * @param ref. Input. The reference to the name.
+ * @param view. Input. The Name view.
+ * @return 0 if the two names are the same.
+ */
+int
+name_arena_compare_view(const ndn_name_arena_t* arena, ndn_name_ref_t ref,
+                        const ndn_name_view_t* view);
+
+/**
+ * Compare a name kept in a name arena with a Name.
+ * @param arena. Input. The name arena.
+ * @param ref. Input. The reference to the name.
+ * @param name. Input. The Name.
+ * @return 0 if the two names are the same.
+ */
+int
+name_arena_compare_name(const ndn_name_arena_t* arena, ndn_name_ref_t ref,
+                        const ndn_name_t* name);
+
+/**
+ * Check whether a name kept in a name arena is a prefix of a Name view.
+ * @param arena. Input. The name arena.
+ * @param ref. Input. The reference to the name.
+ * @param view. Input. The Name view.
+ * @return 0 if the kept name is a prefix of @p view.
+ */
+int
+name_arena_is_prefix_of_view(const ndn_name_arena_t* arena, ndn_name_ref_t ref,
+                             const ndn_name_view_t* view);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FORWARDER_NAME_ARENA_H_
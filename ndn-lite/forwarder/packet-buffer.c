@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include "packet-buffer.h"
+#include <string.h>
+
+ndn_pktbuf_t*
+pktbuf_alloc(ndn_memory_pool_t* pool, uint16_t headroom, uint16_t size)
+{
+  size_t block_size = sizeof(ndn_pktbuf_t) + (size_t)headroom + size;
+  ndn_pktbuf_t* self = pool != NULL ? memory_pool_alloc(pool, block_size)
+                                    : ndn_memory_pool_alloc(block_size);
+  if (self == NULL) {
+    return NULL;
+  }
+  self->pool = pool;
+  self->data = self->buffer + headroom;
+  self->size = size;
+  self->headroom = headroom;
+  self->refcnt = 1;
+  return self;
+}
+
+ndn_pktbuf_t*
+pktbuf_from_packet(ndn_memory_pool_t* pool, const uint8_t* packet, uint32_t size)
+{
+  if (size > UINT16_MAX) {
+    return NULL;
+  }
+  ndn_pktbuf_t* self = pktbuf_alloc(pool, NDN_PKTBUF_HEADROOM, (uint16_t)size);
+  if (self != NULL) {
+    memcpy(self->data, packet, size);
+  }
+  return self;
+}
+
+void
+pktbuf_release(ndn_pktbuf_t* self)
+{
+  if (--self->refcnt != 0) {
+    return;
+  }
+  if (self->pool != NULL) {
+    memory_pool_free(self->pool, self);
+  }
+  else {
+    ndn_memory_pool_free(self);
+  }
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef FORWARDER_PACKET_BUFFER_H_
+#define FORWARDER_PACKET_BUFFER_H_
+
+#include "memory-pool.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The headroom reserved before a packet by ndn_pktbuf_alloc(), e.g., for the header of
+ * a link layer frame. It fits the 9-byte header of an IEEE 802.15.4 frame.
+ */
+#define NDN_PKTBUF_HEADROOM 16
+
+/**
+ * The class of packet buffer.
+ * A packet buffer holds a wire format packet shared by the forwarder, the faces and the
+ * Content Store, which take references to it instead of copying the packet.
+ * It is freed back to its memory pool when the last reference is released.
+ * The packet is read-only while the buffer is shared. The headroom before the packet is
+ * scratch space of the face sending the buffer, valid until the send function returns.
+ */
+typedef struct ndn_pktbuf {
+  /**
+   * The memory pool the buffer is allocated from. NULL for the default pool.
+   */
+  ndn_memory_pool_t* pool;
+  /**
+   * The wire format packet, which follows @p headroom bytes of headroom.
+   */
+  uint8_t* data;
+  uint16_t size;
+  uint16_t headroom;
+  /**
+   * The number of references to the buffer.
+   */
+  uint16_t refcnt;
+  /**
+   * The headroom and the packet.
+   */
+  uint8_t buffer[];
+} ndn_pktbuf_t;
+
+/**
+ * Allocate a packet buffer with one reference, without initializing the packet.
+ * @param pool. Input/Output. The memory pool to allocate the buffer from. NULL for the
+ *              default pool.
+ * @param headroom. Input. The bytes reserved before the packet.
+ * @param size. Input. The size of the packet.
+ * @return the packet buffer. NULL if there is no memory.
+ */
+ndn_pktbuf_t*
+pktbuf_alloc(ndn_memory_pool_t* pool, uint16_t headroom, uint16_t size);
+
+/**
+ * Allocate a packet buffer with NDN_PKTBUF_HEADROOM bytes of headroom, and copy a packet into it.
+ * @param pool. Input/Output. The memory pool to allocate the buffer from. NULL for the
+ *              default pool.
+ * @param packet. Input. The wire format packet.
+ * @param size. Input. The size of the packet.
+ * @return the packet buffer, with one reference. NULL if there is no memory.
+ */
+ndn_pktbuf_t*
+pktbuf_from_packet(ndn_memory_pool_t* pool, const uint8_t* packet, uint32_t size);
+
+/**
+ * Take a reference to a packet buffer.
+ * @param self. Input/Output. The packet buffer.
+ * @return @p self.
+ */
+static inline ndn_pktbuf_t*
+pktbuf_retain(ndn_pktbuf_t* self)
+{
+  self->refcnt++;
+  return self;
+}
+
+/**
+ * Release a reference to a packet buffer, and free it if it was the last one.
+ * @param self. Input/Output. The packet buffer.
+ */
+void
+pktbuf_release(ndn_pktbuf_t* self);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FORWARDER_PACKET_BUFFER_H_
@@ -8,18 +8,353 @@
 
 #include "pit.h"
 
+#define PIT_INDEX_MASK(pit) ((uint16_t)((pit)->index_size - 1))
+
+/************************************************************/
+/*  Definition of hash index helpers                        */
+/************************************************************/
+
+static void
+pit_index_rebuild(ndn_pit_t* pit)
+{
+  for (uint16_t i = 0; i < pit->index_size; i++) {
+    pit->index[i] = NDN_PIT_INDEX_EMPTY;
+  }
+  pit->tombstones = 0;
+  for (uint16_t i = 0; i < pit->capacity; i++) {
+    ndn_pit_entry_t* entry = &pit->slots[i];
+    if (entry->interest_name == NDN_NAME_REF_NULL) {
+      continue;
+    }
+    uint16_t pos = entry->name_hash & PIT_INDEX_MASK(pit);
+    while (pit->index[pos] != NDN_PIT_INDEX_EMPTY) {
+      pos = (pos + 1) & PIT_INDEX_MASK(pit);
+    }
+    pit->index[pos] = i;
+    entry->index_pos = pos;
+  }
+}
+
+/************************************************************/
+/*  Definition of expiry heap helpers                       */
+/************************************************************/
+
+// Whether the entry in slot a should be evicted before the one in slot b
+static bool
+pit_heap_before(const ndn_pit_t* pit, uint16_t a, uint16_t b)
+{
+  const ndn_pit_entry_t* x = &pit->slots[a];
+  const ndn_pit_entry_t* y = &pit->slots[b];
+  if (x->expire_time != y->expire_time) {
+    return x->expire_time < y->expire_time;
+  }
+  return (int32_t)(x->insert_seq - y->insert_seq) < 0;
+}
+
+static void
+pit_heap_set(ndn_pit_t* pit, uint16_t pos, uint16_t slot)
+{
+  pit->expiry_heap[pos] = slot;
+  pit->slots[slot].heap_pos = pos;
+}
+
+static void
+pit_heap_sift_up(ndn_pit_t* pit, uint16_t pos)
+{
+  uint16_t slot = pit->expiry_heap[pos];
+  while (pos > 0) {
+    uint16_t parent = (pos - 1) / 2;
+    if (!pit_heap_before(pit, slot, pit->expiry_heap[parent])) {
+      break;
+    }
+    pit_heap_set(pit, pos, pit->expiry_heap[parent]);
+    pos = parent;
+  }
+  pit_heap_set(pit, pos, slot);
+}
+
+static void
+pit_heap_sift_down(ndn_pit_t* pit, uint16_t pos)
+{
+  uint16_t size = pit->capacity - pit->free_size;
+  uint16_t slot = pit->expiry_heap[pos];
+  while (2 * pos + 1 < size) {
+    uint16_t child = 2 * pos + 1;
+    if (child + 1 < size && pit_heap_before(pit, pit->expiry_heap[child + 1], pit->expiry_heap[child])) {
+      child++;
+    }
+    if (!pit_heap_before(pit, pit->expiry_heap[child], slot)) {
+      break;
+    }
+    pit_heap_set(pit, pos, pit->expiry_heap[child]);
+    pos = child;
+  }
+  pit_heap_set(pit, pos, slot);
+}
+
+/************************************************************/
+/*  Definition of PIT APIs                                  */
+/************************************************************/
+
+void
+pit_table_init(ndn_pit_t* pit, uint8_t* region, uint16_t capacity, uint16_t index_size,
+               uint16_t name_arena_size)
+{
+  pit->slots = (ndn_pit_entry_t*)region;
+  region += NDN_POOL_ALIGN_UP(sizeof(ndn_pit_entry_t) * (size_t)capacity);
+  pit->index = (uint16_t*)region;
+  region += NDN_POOL_ALIGN_UP(sizeof(uint16_t) * (size_t)index_size);
+  pit->free_slots = (uint16_t*)region;
+  region += NDN_POOL_ALIGN_UP(sizeof(uint16_t) * (size_t)capacity);
+  pit->expiry_heap = (uint16_t*)region;
+  region += NDN_POOL_ALIGN_UP(sizeof(uint16_t) * (size_t)capacity);
+  pit->capacity = capacity;
+  pit->index_size = index_size;
+  pit->face_quota = capacity > 1 ? capacity / 2 : 1;
+
+  for (uint16_t i = 0; i < capacity; i++) {
+    pit->slots[i].interest_name = NDN_NAME_REF_NULL;
+    // pop from the tail, so slots are handed out from 0
+    pit->free_slots[i] = capacity - 1 - i;
+  }
+  pit->free_size = capacity;
+  pit->insert_cnt = 0;
+  for (uint8_t i = 0; i < NDN_FACE_TABLE_MAX_SIZE; i++) {
+    pit->face_in_records[i] = 0;
+  }
+  name_arena_init(&pit->names, region, name_arena_size);
+  pit_index_rebuild(pit);
+}
+
+ndn_pit_entry_t*
+pit_table_find(ndn_pit_t* pit, const ndn_name_view_t* name, uint32_t hash)
+{
+  uint16_t pos = hash & PIT_INDEX_MASK(pit);
+  while (pit->index[pos] != NDN_PIT_INDEX_EMPTY) {
+    if (pit->index[pos] != NDN_PIT_INDEX_TOMBSTONE) {
+      ndn_pit_entry_t* entry = &pit->slots[pit->index[pos]];
+      if (entry->name_hash == hash
+          && name_arena_compare_view(&pit->names, entry->interest_name, name) == 0) {
+        return entry;
+      }
+    }
+    pos = (pos + 1) & PIT_INDEX_MASK(pit);
+  }
+  return NULL;
+}
+
+ndn_pit_entry_t*
+pit_table_find_or_insert(ndn_pit_t* pit, const ndn_name_view_t* name, uint32_t hash)
+{
+  // Find, remembering the first reusable position on the probe sequence
+  uint16_t insert_pos = NDN_PIT_INDEX_EMPTY;
+  uint16_t pos = hash & PIT_INDEX_MASK(pit);
+  while (pit->index[pos] != NDN_PIT_INDEX_EMPTY) {
+    if (pit->index[pos] == NDN_PIT_INDEX_TOMBSTONE) {
+      if (insert_pos == NDN_PIT_INDEX_EMPTY)
+        insert_pos = pos;
+    }
+    else {
+      ndn_pit_entry_t* entry = &pit->slots[pit->index[pos]];
+      if (entry->name_hash == hash
+          && name_arena_compare_view(&pit->names, entry->interest_name, name) == 0) {
+        return entry;
+      }
+    }
+    pos = (pos + 1) & PIT_INDEX_MASK(pit);
+  }
+
+  // Insert
+  if (pit->free_size == 0) {
+    return NULL;
+  }
+  ndn_name_ref_t name_ref = name_arena_store(&pit->names, name);
+  if (name_ref == NDN_NAME_REF_NULL) {
+    return NULL;
+  }
+  if (insert_pos == NDN_PIT_INDEX_EMPTY) {
+    insert_pos = pos;
+  }
+  else {
+    pit->tombstones--;
+  }
+  uint16_t slot = pit->free_slots[--pit->free_size];
+  ndn_pit_entry_t* entry = &pit->slots[slot];
+  entry->interest_name = name_ref;
+  entry->name_hash = hash;
+  entry->index_pos = insert_pos;
+  entry->in_record_size = 0;
+  entry->out_record_size = 0;
+  entry->nonce = 0;
+  entry->expire_time = 0;
+  entry->lifetime = 0;
+  entry->expiry_event = NDN_EVENT_HANDLE_NONE;
+  entry->insert_seq = pit->insert_cnt++;
+  entry->strategy = NULL;
+  entry->strategy_info = 0;
+  pit->index[insert_pos] = slot;
+  // the heap holds the entries in use, the new one being the last
+  pit_heap_set(pit, pit->capacity - 1 - pit->free_size, slot);
+  pit_heap_sift_up(pit, entry->heap_pos);
+  return entry;
+}
+
+ndn_pit_entry_t*
+pit_table_first_to_expire(ndn_pit_t* pit)
+{
+  if (pit->free_size == pit->capacity) {
+    return NULL;
+  }
+  return &pit->slots[pit->expiry_heap[0]];
+}
+
+void
+pit_entry_set_expire_time(ndn_pit_t* pit, ndn_pit_entry_t* entry, timetick_t expire_time)
+{
+  entry->expire_time = expire_time;
+  pit_heap_sift_up(pit, entry->heap_pos);
+  pit_heap_sift_down(pit, entry->heap_pos);
+}
+
+ndn_pit_in_record_t*
+pit_entry_find_in_record(ndn_pit_entry_t* entry, const ndn_face_intf_t* face)
+{
+  for (uint8_t i = 0; i < entry->in_record_size; i ++) {
+    if (entry->in_records[i].face_id == face->face_id) {
+      return &entry->in_records[i];
+    }
+  }
+  return NULL;
+}
+
 int
-pit_entry_add_incoming_face(ndn_pit_entry_t* entry, ndn_face_intf_t* face)
+pit_entry_insert_in_record(ndn_pit_t* pit, ndn_pit_entry_t* entry, const ndn_face_intf_t* face,
+                           bool has_nonce, uint32_t nonce, timetick_t expire_time, timetick_t now)
 {
-  for (uint8_t i = 0; i < entry->incoming_face_size; i ++) {
-    if (entry->incoming_face[i] == face) {
-      return 0;
+  ndn_pit_in_record_t* record = pit_entry_find_in_record(entry, face);
+  if (record == NULL && entry->in_record_size < NDN_PIT_MAX_IN_RECORDS) {
+    record = &entry->in_records[entry->in_record_size ++];
+    pit->face_in_records[face->face_id]++;
+  }
+  for (uint8_t i = 0; record == NULL && i < entry->in_record_size; i ++) {
+    if (entry->in_records[i].expire_time < now) {
+      record = &entry->in_records[i];
+      pit->face_in_records[record->face_id]--;
+      pit->face_in_records[face->face_id]++;
     }
   }
-  if (entry->incoming_face_size == NDN_MAX_FACE_PER_PIT_ENTRY) {
+  if (record == NULL) {
     return NDN_FWD_PIT_ENTRY_FACE_LIST_FULL;
   }
-  entry->incoming_face[entry->incoming_face_size] = face;
-  entry->incoming_face_size ++;
+  record->face_id = face->face_id;
+  record->has_nonce = has_nonce;
+  record->nonce = nonce;
+  record->expire_time = expire_time;
+  return 0;
+}
+
+bool
+pit_entry_remove_in_record(ndn_pit_t* pit, ndn_pit_entry_t* entry, const ndn_face_intf_t* face)
+{
+  ndn_pit_in_record_t* record = pit_entry_find_in_record(entry, face);
+  if (record == NULL) {
+    return false;
+  }
+  pit->face_in_records[record->face_id]--;
+  *record = entry->in_records[-- entry->in_record_size];
+  return true;
+}
+
+ndn_pit_out_record_t*
+pit_entry_find_out_record(ndn_pit_entry_t* entry, const ndn_face_intf_t* face)
+{
+  for (uint8_t i = 0; i < entry->out_record_size; i ++) {
+    if (entry->out_records[i].face_id == face->face_id) {
+      return &entry->out_records[i];
+    }
+  }
+  return NULL;
+}
+
+int
+pit_entry_insert_out_record(ndn_pit_entry_t* entry, const ndn_face_intf_t* face,
+                            uint32_t nonce, timetick_t now)
+{
+  ndn_pit_out_record_t* record = pit_entry_find_out_record(entry, face);
+  if (record == NULL) {
+    if (entry->out_record_size == NDN_PIT_MAX_OUT_RECORDS) {
+      return NDN_FWD_PIT_ENTRY_FACE_LIST_FULL;
+    }
+    record = &entry->out_records[entry->out_record_size ++];
+  }
+  record->face_id = face->face_id;
+  record->nonce = nonce;
+  record->last_sent = now;
   return 0;
 }
+
+bool
+pit_entry_remove_out_record(ndn_pit_entry_t* entry, const ndn_face_intf_t* face)
+{
+  ndn_pit_out_record_t* record = pit_entry_find_out_record(entry, face);
+  if (record == NULL) {
+    return false;
+  }
+  *record = entry->out_records[-- entry->out_record_size];
+  return true;
+}
+
+bool
+pit_entry_has_nonce(const ndn_pit_entry_t* entry, uint32_t nonce)
+{
+  for (uint8_t i = 0; i < entry->in_record_size; i ++) {
+    if (entry->in_records[i].has_nonce && entry->in_records[i].nonce == nonce) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+pit_entry_delete(ndn_pit_t* pit, ndn_pit_entry_t* entry)
+{
+  if (entry->interest_name == NDN_NAME_REF_NULL) {
+    return;
+  }
+  for (uint8_t i = 0; i < entry->in_record_size; i ++) {
+    pit->face_in_records[entry->in_records[i].face_id]--;
+  }
+  name_arena_release(&pit->names, entry->interest_name);
+  entry->interest_name = NDN_NAME_REF_NULL;
+
+  // Fill the position in the heap with the last entry
+  uint16_t last = pit->expiry_heap[pit->capacity - 1 - pit->free_size];
+  pit->free_slots[pit->free_size++] = entry - pit->slots;
+  if (last != entry - pit->slots) {
+    uint16_t heap_pos = entry->heap_pos;
+    pit_heap_set(pit, heap_pos, last);
+    pit_heap_sift_up(pit, heap_pos);
+    pit_heap_sift_down(pit, pit->slots[last].heap_pos);
+  }
+
+  // A position followed by an empty one can be emptied directly,
+  // otherwise leave a tombstone to keep later probe sequences intact
+  uint16_t pos = entry->index_pos;
+  if (pit->index[(pos + 1) & PIT_INDEX_MASK(pit)] == NDN_PIT_INDEX_EMPTY) {
+    pit->index[pos] = NDN_PIT_INDEX_EMPTY;
+    // tombstones right before an empty position are no longer needed
+    pos = (pos - 1) & PIT_INDEX_MASK(pit);
+    while (pit->index[pos] == NDN_PIT_INDEX_TOMBSTONE) {
+      pit->index[pos] = NDN_PIT_INDEX_EMPTY;
+      pit->tombstones--;
+      pos = (pos - 1) & PIT_INDEX_MASK(pit);
+    }
+  }
+  else {
+    pit->index[pos] = NDN_PIT_INDEX_TOMBSTONE;
+    pit->tombstones++;
+    if (pit->tombstones > pit->index_size / 4) {
+      pit_index_rebuild(pit);
+    }
+  }
+}
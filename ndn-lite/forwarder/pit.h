@@ -11,59 +11,373 @@
 
 #include "../encode/interest.h"
 #include "face.h"
+#include "name-arena.h"
+#include "memory-pool.h"
+#include "scheduler.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+struct ndn_strategy;
+
+/**
+ * ndn_pit_in_record is a class of the records of downstream faces in a PIT entry.
+ */
+typedef struct ndn_pit_in_record {
+  /**
+   * The face ID of the downstream face.
+   */
+  uint8_t face_id;
+
+  /**
+   * Whether the latest Interest from the face has a nonce. If not, @p nonce is not used
+   * to detect loops.
+   */
+  bool has_nonce;
+
+  /**
+   * The nonce of the latest Interest from the face.
+   */
+  uint32_t nonce;
+
+  /**
+   * The time point when the latest Interest from the face expires.
+   * Data is not sent to the face after that.
+   */
+  timetick_t expire_time;
+} ndn_pit_in_record_t;
+
+/**
+ * ndn_pit_out_record is a class of the records of upstream faces in a PIT entry.
+ */
+typedef struct ndn_pit_out_record {
+  /**
+   * The face ID of the upstream face.
+   */
+  uint8_t face_id;
+
+  /**
+   * The nonce of the latest Interest sent to the face.
+   */
+  uint32_t nonce;
+
+  /**
+   * The time when the latest Interest was sent to the face, to take RTT samples.
+   */
+  timetick_t last_sent;
+} ndn_pit_out_record_t;
+
 /**
  * ndn_pit_entry is a class of PIT entries.
  */
 typedef struct ndn_pit_entry {
   /**
-   * The name of representative Interest.
-   * A name with components_size < 0 indicates an empty entry.
+   * The name of representative Interest, kept in the name arena of the PIT.
+   * NDN_NAME_REF_NULL indicates an empty entry.
+   */
+  ndn_name_ref_t interest_name;
+
+  /**
+   * The hash of the interest_name, obtained from ndn_name_hash().
+   */
+  uint32_t name_hash;
+
+  /**
+   * The position of this entry in the PIT hash index.
+   */
+  uint16_t index_pos;
+
+  /**
+   * The position of this entry in the PIT expiry heap.
+   */
+  uint16_t heap_pos;
+
+  /**
+   * The order in which the entry was inserted, to evict the older one of two entries
+   * expiring at the same time.
+   */
+  uint32_t insert_seq;
+
+  /**
+   * The count of in-records.
+   */
+  uint8_t in_record_size;
+
+  /**
+   * The count of out-records.
+   */
+  uint8_t out_record_size;
+
+  /**
+   * The in-records, one for each downstream face.
+   */
+  ndn_pit_in_record_t in_records[NDN_PIT_MAX_IN_RECORDS];
+
+  /**
+   * The out-records, one for each upstream face.
+   */
+  ndn_pit_out_record_t out_records[NDN_PIT_MAX_OUT_RECORDS];
+
+  /**
+   * The nonce of the representative Interest, i.e., the latest one received.
+   */
+  uint32_t nonce;
+
+  /**
+   * The time point when this entry expires, which is the latest expiry of its in-records.
+   * The forwarder arms a scheduler event for it.
+   * Set it with pit_entry_set_expire_time(), which keeps the expiry heap in order.
    */
-  ndn_name_t interest_name;
+  timetick_t expire_time;
 
   /**
-   * Collection of incoming faces.
+   * The InterestLifetime of the Interest which set expire_time, in milliseconds,
+   * for the Interest given to the applications when the entry expires.
    */
-  ndn_face_intf_t* incoming_face[NDN_MAX_FACE_PER_PIT_ENTRY];
+  uint32_t lifetime;
 
   /**
-   * The count of incoming faces.
+   * The scheduler event armed for expire_time, to cancel it when the entry is deleted
+   * or extended. NDN_EVENT_HANDLE_NONE if there is none.
    */
-  uint8_t incoming_face_size;
+  ndn_event_handle_t expiry_event;
 
   /**
-   * @todo How to timeout?
+   * The strategy forwarding this entry's Interests, resolved when the entry is created.
    */
+  const struct ndn_strategy* strategy;
+
+  /**
+   * Opaque state kept by the strategy for this entry.
+   */
+  uint32_t strategy_info;
 } ndn_pit_entry_t;
 
 /**
  * The class of pending Interest table (PIT).
+ * Entries are kept in an array carved from a memory region given at init, and located
+ * through an open addressing hash index keyed by the name hash, so that lookup does not
+ * depend on the capacity.
+ * A binary min-heap orders the entries by expiry, so that the forwarder can evict the
+ * entry closest to expiry when the PIT is full.
  */
-typedef ndn_pit_entry_t ndn_pit_t[NDN_PIT_MAX_SIZE];
+typedef struct ndn_pit {
+  /**
+   * The PIT entries, @p capacity of them.
+   */
+  ndn_pit_entry_t* slots;
+
+  /**
+   * The hash index with linear probing, @p index_size elements.
+   * Each element is NDN_PIT_INDEX_EMPTY, NDN_PIT_INDEX_TOMBSTONE, or
+   * the position of an entry in @p slots.
+   */
+  uint16_t* index;
+
+  /**
+   * Stack of unused positions in @p slots.
+   */
+  uint16_t* free_slots;
+
+  /**
+   * The number of entries.
+   */
+  uint16_t capacity;
+
+  /**
+   * The number of elements of @p index, a power of two.
+   */
+  uint16_t index_size;
+
+  /**
+   * The in-records a face may hold, so that it cannot evict the entries of the others.
+   * It is half the capacity.
+   */
+  uint16_t face_quota;
+
+  /**
+   * The number of unused positions in @p free_slots.
+   */
+  uint16_t free_size;
+
+  /**
+   * The number of tombstones in @p index.
+   */
+  uint16_t tombstones;
+
+  /**
+   * The expiry heap: positions in @p slots, ordered by expire_time and then insert_seq.
+   * The heap holds @p capacity - @p free_size entries.
+   */
+  uint16_t* expiry_heap;
+
+  /**
+   * The insert_seq of the next entry.
+   */
+  uint32_t insert_cnt;
+
+  /**
+   * The number of in-records of each face, indexed by face ID, for the per-face quota.
+   */
+  uint16_t face_in_records[NDN_FACE_TABLE_MAX_SIZE];
+
+  /**
+   * The name arena keeping the Interest names.
+   */
+  ndn_name_arena_t names;
+} ndn_pit_t;
+
+#define NDN_PIT_INDEX_EMPTY ((uint16_t)(-1))
+#define NDN_PIT_INDEX_TOMBSTONE ((uint16_t)(-2))
+
+/**
+ * The bytes of memory region taken by a PIT: the entries, the hash index, the free slot
+ * stack, the expiry heap and the name arena, each aligned to NDN_POOL_ALIGN.
+ */
+#define NDN_PIT_REGION_SIZE(capacity, index_size, name_arena_size) \
+  (NDN_POOL_ALIGN_UP(sizeof(ndn_pit_entry_t) * (size_t)(capacity)) \
+   + NDN_POOL_ALIGN_UP(sizeof(uint16_t) * (size_t)(index_size)) \
+   + 2 * NDN_POOL_ALIGN_UP(sizeof(uint16_t) * (size_t)(capacity)) \
+   + NDN_POOL_ALIGN_UP((size_t)(name_arena_size)))
 
 /**
- * Add an incoming face to a PIT entry.
+ * Init an empty PIT.
+ * @param pit. Output. The PIT to be inited.
+ * @param region. Input. The memory region the tables are carved from, aligned to
+ *                NDN_POOL_ALIGN and of NDN_PIT_REGION_SIZE() bytes. It must outlive the PIT.
+ * @param capacity. Input. The number of entries, less than NDN_PIT_INDEX_TOMBSTONE.
+ * @param index_size. Input. The slots of the hash index, a power of two and at least
+ *                    twice @p capacity.
+ * @param name_arena_size. Input. The bytes of the name arena, no more than 65534.
+ */
+void
+pit_table_init(ndn_pit_t* pit, uint8_t* region, uint16_t capacity, uint16_t index_size,
+               uint16_t name_arena_size);
+
+/**
+ * Find the PIT entry of an Interest name.
+ * @param pit. Input. The PIT.
+ * @param name. Input. The view of the Interest name.
+ * @param hash. Input. The value of ndn_name_view_hash(@p name).
+ * @return the PIT entry. NULL if there is no such entry.
+ */
+ndn_pit_entry_t*
+pit_table_find(ndn_pit_t* pit, const ndn_name_view_t* name, uint32_t hash);
+
+/**
+ * Find the PIT entry of an Interest name, or insert an empty one.
+ * The name is copied only when a new entry is inserted.
+ * @param pit. Input/Output. The PIT.
+ * @param name. Input. The view of the Interest name.
+ * @param hash. Input. The value of ndn_name_view_hash(@p name).
+ * @return the PIT entry. NULL if the PIT or its name arena is full.
+ */
+ndn_pit_entry_t*
+pit_table_find_or_insert(ndn_pit_t* pit, const ndn_name_view_t* name, uint32_t hash);
+
+/**
+ * Get the PIT entry that expires first, which is the one to evict when the PIT is full.
+ * Of two entries expiring at the same time, the older one comes first.
+ * @param pit. Input. The PIT.
+ * @return the PIT entry. NULL if the PIT is empty.
+ */
+ndn_pit_entry_t*
+pit_table_first_to_expire(ndn_pit_t* pit);
+
+/**
+ * Set the expiry time of a PIT entry.
+ * @param pit. Input/Output. The PIT holding the entry.
+ * @param entry. Input/Output. The PIT entry.
+ * @param expire_time. Input. The time point when the entry expires.
+ */
+void
+pit_entry_set_expire_time(ndn_pit_t* pit, ndn_pit_entry_t* entry, timetick_t expire_time);
+
+/**
+ * Find the in-record of a downstream face in a PIT entry.
  * @param entry. Input. The PIT entry.
- * @param face. Input. The incoming face.
- * @return 0 if there is no error.
+ * @param face. Input. The downstream face.
+ * @return the in-record. NULL if there is no such record.
+ */
+ndn_pit_in_record_t*
+pit_entry_find_in_record(ndn_pit_entry_t* entry, const ndn_face_intf_t* face);
+
+/**
+ * Add the in-record of a downstream face to a PIT entry, or update an existing one.
+ * When the entry has NDN_PIT_MAX_IN_RECORDS in-records, an expired one is replaced.
+ * @param pit. Input/Output. The PIT holding the entry.
+ * @param entry. Input/Output. The PIT entry.
+ * @param face. Input. The downstream face.
+ * @param has_nonce. Input. Whether the Interest received from @p face has a nonce.
+ * @param nonce. Input. The nonce of the Interest received from @p face, if it has one.
+ * @param expire_time. Input. The time point when the Interest expires.
+ * @param now. Input. The current time.
+ * @return 0 if there is no error. NDN_FWD_PIT_ENTRY_FACE_LIST_FULL if all the in-records
+ *         are unexpired.
  */
 int
-pit_entry_add_incoming_face(ndn_pit_entry_t* entry, ndn_face_intf_t* face);
+pit_entry_insert_in_record(ndn_pit_t* pit, ndn_pit_entry_t* entry, const ndn_face_intf_t* face,
+                           bool has_nonce, uint32_t nonce, timetick_t expire_time, timetick_t now);
+
+/**
+ * Remove the in-record of a downstream face from a PIT entry.
+ * @param pit. Input/Output. The PIT holding the entry.
+ * @param entry. Input/Output. The PIT entry.
+ * @param face. Input. The downstream face.
+ * @return true if there was such a record.
+ */
+bool
+pit_entry_remove_in_record(ndn_pit_t* pit, ndn_pit_entry_t* entry, const ndn_face_intf_t* face);
+
+/**
+ * Find the out-record of an upstream face in a PIT entry.
+ * @param entry. Input. The PIT entry.
+ * @param face. Input. The upstream face.
+ * @return the out-record. NULL if there is no such record.
+ */
+ndn_pit_out_record_t*
+pit_entry_find_out_record(ndn_pit_entry_t* entry, const ndn_face_intf_t* face);
+
+/**
+ * Add the out-record of an upstream face to a PIT entry, or update an existing one.
+ * @param entry. Input/Output. The PIT entry.
+ * @param face. Input. The upstream face.
+ * @param nonce. Input. The nonce of the Interest sent to @p face.
+ * @param now. Input. The time when the Interest is sent to @p face.
+ * @return 0 if there is no error. NDN_FWD_PIT_ENTRY_FACE_LIST_FULL if the entry has
+ *         NDN_PIT_MAX_OUT_RECORDS out-records.
+ */
+int
+pit_entry_insert_out_record(ndn_pit_entry_t* entry, const ndn_face_intf_t* face,
+                            uint32_t nonce, timetick_t now);
+
+/**
+ * Remove the out-record of an upstream face from a PIT entry.
+ * @param entry. Input/Output. The PIT entry.
+ * @param face. Input. The upstream face.
+ * @return true if there was such a record.
+ */
+bool
+pit_entry_remove_out_record(ndn_pit_entry_t* entry, const ndn_face_intf_t* face);
+
+/**
+ * Check whether an Interest with the nonce has been received by a PIT entry,
+ * from any of its downstream faces. The in-records without a nonce are skipped.
+ * @param entry. Input. The PIT entry.
+ * @param nonce. Input. The nonce.
+ * @return true if the nonce is a duplicate.
+ */
+bool
+pit_entry_has_nonce(const ndn_pit_entry_t* entry, uint32_t nonce);
 
 /**
  * Delete a PIT entry.
+ * @param pit. Input/Output. The PIT holding the entry.
  * @param entry. Input. The PIT entry.
  */
-static inline void
-pit_entry_delete(ndn_pit_entry_t* entry)
-{
-  entry->interest_name.components_size = NDN_FWD_INVALID_NAME_SIZE;
-}
+void
+pit_entry_delete(ndn_pit_t* pit, ndn_pit_entry_t* entry);
 
 #ifdef __cplusplus
 }
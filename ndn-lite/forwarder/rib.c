@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include "rib.h"
+
+// Whether a route has a name prefix, with its hash computed by the caller
+static bool
+rib_route_match(const ndn_rib_t* rib, const ndn_rib_route_t* route,
+                const ndn_name_t* name_prefix, uint32_t hash)
+{
+  return route->name_prefix != NDN_NAME_REF_NULL
+         && route->name_hash == hash
+         && name_arena_compare_name(&rib->names, route->name_prefix, name_prefix) == 0;
+}
+
+void
+rib_table_init(ndn_rib_t* rib, uint8_t* region, uint16_t capacity, uint16_t name_arena_size)
+{
+  rib->routes = (ndn_rib_route_t*)region;
+  region += NDN_POOL_ALIGN_UP(sizeof(ndn_rib_route_t) * (size_t)capacity);
+  rib->capacity = capacity;
+  for (uint16_t i = 0; i < capacity; i++) {
+    rib->routes[i].name_prefix = NDN_NAME_REF_NULL;
+  }
+  name_arena_init(&rib->names, region, name_arena_size);
+}
+
+ndn_rib_route_t*
+rib_table_find(ndn_rib_t* rib, const ndn_name_t* name_prefix, uint8_t face_id, uint16_t origin)
+{
+  uint32_t hash = ndn_name_hash(name_prefix);
+  for (uint16_t i = 0; i < rib->capacity; i++) {
+    ndn_rib_route_t* route = &rib->routes[i];
+    if (route->face_id == face_id && route->origin == origin
+        && rib_route_match(rib, route, name_prefix, hash)) {
+      return route;
+    }
+  }
+  return NULL;
+}
+
+ndn_rib_route_t*
+rib_table_insert(ndn_rib_t* rib, const ndn_name_t* name_prefix, uint8_t face_id, uint16_t origin)
+{
+  for (uint16_t i = 0; i < rib->capacity; i++) {
+    ndn_rib_route_t* route = &rib->routes[i];
+    if (route->name_prefix != NDN_NAME_REF_NULL) {
+      continue;
+    }
+    route->name_prefix = name_arena_store_name(&rib->names, name_prefix);
+    if (route->name_prefix == NDN_NAME_REF_NULL) {
+      return NULL;
+    }
+    route->name_hash = ndn_name_hash(name_prefix);
+    route->face_id = face_id;
+    route->cost = 0;
+    route->origin = origin;
+    route->expire_time = NDN_RIB_NEVER_EXPIRE;
+    route->expiry_event = NDN_EVENT_HANDLE_NONE;
+    return route;
+  }
+  return NULL;
+}
+
+bool
+rib_table_lowest_cost(ndn_rib_t* rib, const ndn_name_t* name_prefix, uint8_t face_id,
+                      uint8_t* cost)
+{
+  uint32_t hash = ndn_name_hash(name_prefix);
+  bool found = false;
+  for (uint16_t i = 0; i < rib->capacity; i++) {
+    const ndn_rib_route_t* route = &rib->routes[i];
+    if (route->face_id != face_id || !rib_route_match(rib, route, name_prefix, hash)) {
+      continue;
+    }
+    if (!found || route->cost < *cost) {
+      *cost = route->cost;
+    }
+    found = true;
+  }
+  return found;
+}
+
+void
+rib_route_delete(ndn_rib_t* rib, ndn_rib_route_t* route)
+{
+  name_arena_release(&rib->names, route->name_prefix);
+  route->name_prefix = NDN_NAME_REF_NULL;
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef FORWARDER_RIB_H_
+#define FORWARDER_RIB_H_
+
+#include "name-arena.h"
+#include "memory-pool.h"
+#include "face.h"
+#include "scheduler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The expire time of a route that never expires.
+ */
+#define NDN_RIB_NEVER_EXPIRE ((timetick_t)(-1))
+
+/**
+ * The class of routes.
+ * A route is registered by an origin, e.g., an application or a routing controller,
+ * and is identified by its name prefix, face and origin.
+ */
+typedef struct ndn_rib_route {
+  /**
+   * The name prefix, kept in the name arena of the RIB.
+   * NDN_NAME_REF_NULL indicates an empty route.
+   */
+  ndn_name_ref_t name_prefix;
+
+  /**
+   * The hash of the name_prefix, obtained from ndn_name_hash().
+   */
+  uint32_t name_hash;
+
+  /**
+   * The face ID of the next hop.
+   */
+  uint8_t face_id;
+
+  /**
+   * The cost of the next hop.
+   */
+  uint8_t cost;
+
+  /**
+   * The origin registering the route.
+   */
+  uint16_t origin;
+
+  /**
+   * The time point when this route expires. NDN_RIB_NEVER_EXPIRE if it does not.
+   */
+  timetick_t expire_time;
+
+  /**
+   * The scheduler event armed for expire_time, to cancel it when the route is deleted
+   * or renewed. NDN_EVENT_HANDLE_NONE if there is none.
+   */
+  ndn_event_handle_t expiry_event;
+} ndn_rib_route_t;
+
+/**
+ * The class of routing information base (RIB).
+ * The RIB keeps the routes registered by the management commands. The FIB next hop of
+ * a name prefix and a face takes the lowest cost among the routes of them, and is
+ * updated on every change of these routes only.
+ * Routes are scanned linearly, since they change at the pace of the management commands.
+ */
+typedef struct ndn_rib {
+  /**
+   * The routes, @p capacity of them.
+   */
+  ndn_rib_route_t* routes;
+
+  /**
+   * The number of routes.
+   */
+  uint16_t capacity;
+
+  /**
+   * The name arena keeping the name prefixes.
+   */
+  ndn_name_arena_t names;
+} ndn_rib_t;
+
+/**
+ * The bytes of memory region taken by a RIB: the routes and the name arena, each aligned
+ * to NDN_POOL_ALIGN.
+ */
+#define NDN_RIB_REGION_SIZE(capacity, name_arena_size) \
+  (NDN_POOL_ALIGN_UP(sizeof(ndn_rib_route_t) * (size_t)(capacity)) \
+   + NDN_POOL_ALIGN_UP((size_t)(name_arena_size)))
+
+/**
+ * Init an empty RIB.
+ * @param rib. Output. The RIB to be inited.
+ * @param region. Input. The memory region the tables are carved from, aligned to
+ *                NDN_POOL_ALIGN and of NDN_RIB_REGION_SIZE() bytes. It must outlive the RIB.
+ * @param capacity. Input. The number of routes.
+ * @param name_arena_size. Input. The bytes of the name arena, no more than 65534.
+ */
+void
+rib_table_init(ndn_rib_t* rib, uint8_t* region, uint16_t capacity, uint16_t name_arena_size);
+
+/**
+ * Find the route of a name prefix, a face and an origin.
+ * @param rib. Input. The RIB.
+ * @param name_prefix. Input. The name prefix.
+ * @param face_id. Input. The face ID.
+ * @param origin. Input. The origin.
+ * @return the route. NULL if there is no such route.
+ */
+ndn_rib_route_t*
+rib_table_find(ndn_rib_t* rib, const ndn_name_t* name_prefix, uint8_t face_id, uint16_t origin);
+
+/**
+ * Insert an empty route of a name prefix, a face and an origin.
+ * The caller should have checked that the route does not exist.
+ * @param rib. Input/Output. The RIB.
+ * @param name_prefix. Input. The name prefix.
+ * @param face_id. Input. The face ID.
+ * @param origin. Input. The origin.
+ * @return the new route. NULL if the RIB or its name arena is full.
+ */
+ndn_rib_route_t*
+rib_table_insert(ndn_rib_t* rib, const ndn_name_t* name_prefix, uint8_t face_id, uint16_t origin);
+
+/**
+ * Get the lowest cost among the routes of a name prefix and a face.
+ * @param rib. Input. The RIB.
+ * @param name_prefix. Input. The name prefix.
+ * @param face_id. Input. The face ID.
+ * @param cost. Output. The lowest cost.
+ * @return true if there is any route of @p name_prefix and @p face_id.
+ */
+bool
+rib_table_lowest_cost(ndn_rib_t* rib, const ndn_name_t* name_prefix, uint8_t face_id,
+                      uint8_t* cost);
+
+/**
+ * Delete a route.
+ * @param rib. Input/Output. The RIB.
+ * @param route. Input/Output. The route.
+ */
+void
+rib_route_delete(ndn_rib_t* rib, ndn_rib_route_t* route);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FORWARDER_RIB_H_
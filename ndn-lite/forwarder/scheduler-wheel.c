@@ -0,0 +1,328 @@
+/*
+ * Copyright (C) 2019 Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include "scheduler.h"
+
+#ifdef NDN_SCHEDULER_TIMING_WHEEL
+
+/*
+ * A hierarchical timing wheel.
+ * Level 0 has a slot for each of the next 64 milliseconds, and a slot of level l spans
+ * 64^l milliseconds. An event is linked into the slot of the coarsest level which it is
+ * not beyond, so that posting and cancelling take O(1). When the wheel reaches the start
+ * of a slot of level l > 0, the events in it are moved to finer levels, which happens at
+ * most NDN_SCHEDULER_WHEEL_LEVELS - 1 times for each event. The occupied slots are kept
+ * in bitmaps, so that the wheel skips the empty ones instead of stepping every millisecond.
+ */
+
+#define WHEEL_BITS 6
+#define WHEEL_MASK (NDN_SCHEDULER_WHEEL_SLOTS - 1)
+#define WHEEL_SPAN ((timetick_t)1 << (WHEEL_BITS * NDN_SCHEDULER_WHEEL_LEVELS))
+#define WHEEL_NONE NDN_SCHEDULER_SLOT_NONE
+#define WHEEL_DUE_LIST (NDN_SCHEDULER_WHEEL_LISTS - 1)
+#define WHEEL_LIST_FREE NDN_SCHEDULER_WHEEL_LISTS
+
+#define HANDLE_OF(slot, generation) \
+  (((ndn_event_handle_t)(generation) << NDN_SCHEDULER_SLOT_BITS) | (slot))
+#define HANDLE_SLOT(handle) ((ndn_event_slot_t)(handle))
+#define HANDLE_GENERATION(handle) ((ndn_event_slot_t)((handle) >> NDN_SCHEDULER_SLOT_BITS))
+
+// The index of the lowest bit set in a non-zero bitmap
+static inline uint8_t
+wheel_first_bit(uint64_t bits)
+{
+#if defined(__GNUC__)
+  return (uint8_t)__builtin_ctzll(bits);
+#else
+  uint8_t index = 0;
+  while ((bits & 1) == 0) {
+    bits >>= 1;
+    index++;
+  }
+  return index;
+#endif
+}
+
+static void
+wheel_link(ndn_scheduler_t* self, ndn_event_slot_t slot, uint16_t list)
+{
+  ndn_event_t* event = &self->events[slot];
+  event->list = list;
+  event->next = WHEEL_NONE;
+  event->prev = self->tails[list];
+  if (event->prev != WHEEL_NONE) {
+    self->events[event->prev].next = slot;
+  }
+  else {
+    self->heads[list] = slot;
+  }
+  self->tails[list] = slot;
+  if (list != WHEEL_DUE_LIST) {
+    self->occupied[list / NDN_SCHEDULER_WHEEL_SLOTS] |= (uint64_t)1 << (list & WHEEL_MASK);
+  }
+}
+
+static void
+wheel_unlink(ndn_scheduler_t* self, ndn_event_slot_t slot)
+{
+  ndn_event_t* event = &self->events[slot];
+  uint16_t list = event->list;
+  if (event->prev != WHEEL_NONE) {
+    self->events[event->prev].next = event->next;
+  }
+  else {
+    self->heads[list] = event->next;
+  }
+  if (event->next != WHEEL_NONE) {
+    self->events[event->next].prev = event->prev;
+  }
+  else {
+    self->tails[list] = event->prev;
+  }
+  if (self->heads[list] == WHEEL_NONE && list != WHEEL_DUE_LIST) {
+    self->occupied[list / NDN_SCHEDULER_WHEEL_SLOTS] &= ~((uint64_t)1 << (list & WHEEL_MASK));
+  }
+}
+
+// Link an event into the list of its tick, relative to the wheel time
+static void
+wheel_place(ndn_scheduler_t* self, ndn_event_slot_t slot)
+{
+  timetick_t tick = self->events[slot].tick;
+  if (tick < self->wheel_time) {
+    wheel_link(self, slot, WHEEL_DUE_LIST);
+    return;
+  }
+  timetick_t delta = tick - self->wheel_time;
+  if (delta >= WHEEL_SPAN) {
+    // wait in the last slot the wheel reaches, which is before the tick
+    delta = WHEEL_SPAN - 1;
+    tick = self->wheel_time + delta;
+  }
+  uint8_t level = 0;
+  while (delta >> (WHEEL_BITS * (level + 1)) != 0) {
+    level++;
+  }
+  uint16_t index = (uint16_t)((tick >> (WHEEL_BITS * level)) & WHEEL_MASK);
+  wheel_link(self, slot, level * NDN_SCHEDULER_WHEEL_SLOTS + index);
+}
+
+// Take a pending event out of its list and free its slot
+static void
+wheel_remove(ndn_scheduler_t* self, ndn_event_slot_t slot)
+{
+  wheel_unlink(self, slot);
+  self->events[slot].list = WHEEL_LIST_FREE;
+  self->event_cnt--;
+  self->free_slots[self->capacity - self->event_cnt - 1] = slot;
+}
+
+// Move the events of the slots starting at the wheel time to finer levels
+static void
+wheel_settle(ndn_scheduler_t* self)
+{
+  for (uint8_t level = 1; level < NDN_SCHEDULER_WHEEL_LEVELS; level++) {
+    uint8_t shift = WHEEL_BITS * level;
+    if ((self->wheel_time & (((timetick_t)1 << shift) - 1)) != 0) {
+      break;
+    }
+    uint16_t index = (uint16_t)((self->wheel_time >> shift) & WHEEL_MASK);
+    uint16_t list = level * NDN_SCHEDULER_WHEEL_SLOTS + index;
+    ndn_event_slot_t slot = self->heads[list];
+    self->heads[list] = WHEEL_NONE;
+    self->tails[list] = WHEEL_NONE;
+    self->occupied[level] &= ~((uint64_t)1 << index);
+    while (slot != WHEEL_NONE) {
+      ndn_event_slot_t next = self->events[slot].next;
+      wheel_place(self, slot);
+      slot = next;
+    }
+  }
+}
+
+// Get when the wheel reaches the next occupied slot of a level: the tick of its events
+// for level 0, or the start of the slot for the others.
+static bool
+wheel_next_slot(const ndn_scheduler_t* self, uint8_t level, timetick_t* time)
+{
+  uint64_t bits = self->occupied[level];
+  if (bits == 0) {
+    return false;
+  }
+  uint8_t shift = WHEEL_BITS * level;
+  timetick_t current = self->wheel_time >> shift;
+  // the current slot of a coarser level has been emptied when the wheel reached it,
+  // so the events there are a round later, and the search starts from the slot after it
+  uint8_t start = level == 0 ? 0 : 1;
+  uint8_t from = (uint8_t)((current + start) & WHEEL_MASK);
+  if (from != 0) {
+    bits = (bits >> from) | (bits << (NDN_SCHEDULER_WHEEL_SLOTS - from));
+  }
+  timetick_t ahead = start + wheel_first_bit(bits);
+  if (level == 0) {
+    *time = self->wheel_time + ahead;
+  }
+  else {
+    *time = (current + ahead) << shift;
+  }
+  return true;
+}
+
+// Run the events of a list, including the ones the callbacks add to it
+static bool
+wheel_run_list(ndn_scheduler_t* self, uint16_t list)
+{
+  bool ret = false;
+  while (self->heads[list] != WHEEL_NONE) {
+    // Pop the event before invoking it, since the callback may post new events
+    ndn_event_slot_t slot = self->heads[list];
+    ndn_event_t event = self->events[slot];
+    wheel_remove(self, slot);
+    event.func(event.obj, event.iparam, event.pparam);
+    ret = true;
+  }
+  return ret;
+}
+
+void
+ndn_scheduler_init(ndn_scheduler_t* self, uint8_t* region, ndn_event_slot_t capacity)
+{
+  self->events = (ndn_event_t*)region;
+  region += NDN_POOL_ALIGN_UP(sizeof(ndn_event_t) * (size_t)capacity);
+  self->free_slots = (ndn_event_slot_t*)region;
+  self->capacity = capacity;
+  for (ndn_event_slot_t i = 0; i < capacity; i++) {
+    self->events[i].list = WHEEL_LIST_FREE;
+    self->events[i].generation = 0;
+    // slot 0 is on the top
+    self->free_slots[i] = (ndn_event_slot_t)(capacity - 1 - i);
+  }
+  for (uint16_t i = 0; i < NDN_SCHEDULER_WHEEL_LISTS; i++) {
+    self->heads[i] = WHEEL_NONE;
+    self->tails[i] = WHEEL_NONE;
+  }
+  for (uint8_t i = 0; i < NDN_SCHEDULER_WHEEL_LEVELS; i++) {
+    self->occupied[i] = 0;
+  }
+  self->wheel_time = 0;
+  self->event_cnt = 0;
+  self->now = 0;
+}
+
+ndn_event_handle_t
+ndn_scheduler_post(ndn_scheduler_t* self,
+                   timetick_t timepoint,
+                   void *target,
+                   ndn_event_callback reason,
+                   uint32_t iparam,
+                   void *pparam)
+{
+  if (self->event_cnt >= self->capacity) {
+    return NDN_EVENT_HANDLE_NONE;
+  }
+  ndn_event_slot_t slot = self->free_slots[self->capacity - self->event_cnt - 1];
+  ndn_event_t* event = &self->events[slot];
+  event->tick = timepoint;
+  event->obj = target;
+  event->func = reason;
+  event->iparam = iparam;
+  event->pparam = pparam;
+  // a handle is never NDN_EVENT_HANDLE_NONE, as the generation is never 0
+  if (++event->generation == 0) {
+    event->generation = 1;
+  }
+  self->event_cnt++;
+  wheel_place(self, slot);
+  return HANDLE_OF(slot, event->generation);
+}
+
+ndn_event_handle_t
+ndn_scheduler_post_after(ndn_scheduler_t* self,
+                         timetick_t delay,
+                         void *target,
+                         ndn_event_callback reason,
+                         uint32_t iparam,
+                         void *pparam)
+{
+  return ndn_scheduler_post(self, self->now + delay, target, reason, iparam, pparam);
+}
+
+bool
+ndn_scheduler_cancel(ndn_scheduler_t* self, ndn_event_handle_t handle)
+{
+  ndn_event_slot_t slot = HANDLE_SLOT(handle);
+  if (handle == NDN_EVENT_HANDLE_NONE || slot >= self->capacity) {
+    return false;
+  }
+  const ndn_event_t* event = &self->events[slot];
+  if (event->list == WHEEL_LIST_FREE || event->generation != HANDLE_GENERATION(handle)) {
+    return false;
+  }
+  wheel_remove(self, slot);
+  return true;
+}
+
+bool
+ndn_scheduler_process(ndn_scheduler_t* self, timetick_t now)
+{
+  bool ret = false;
+  ndn_scheduler_set_time(self, now);
+  while (true) {
+    if (wheel_run_list(self, WHEEL_DUE_LIST)) {
+      ret = true;
+    }
+    if (self->wheel_time >= now) {
+      break;
+    }
+    // the events of this millisecond, in one batch
+    if (wheel_run_list(self, (uint16_t)(self->wheel_time & WHEEL_MASK))) {
+      ret = true;
+    }
+    // skip to the next occupied slot
+    timetick_t next = now;
+    for (uint8_t level = 0; level < NDN_SCHEDULER_WHEEL_LEVELS; level++) {
+      timetick_t time;
+      if (wheel_next_slot(self, level, &time) && time < next) {
+        next = time;
+      }
+    }
+    self->wheel_time = next;
+    wheel_settle(self);
+  }
+  return ret;
+}
+
+bool
+ndn_scheduler_next_deadline(const ndn_scheduler_t* self, timetick_t* deadline)
+{
+  if (self->event_cnt == 0) {
+    return false;
+  }
+  if (self->heads[WHEEL_DUE_LIST] != WHEEL_NONE) {
+    *deadline = self->wheel_time;
+    return true;
+  }
+  bool found = false;
+  for (uint8_t level = 0; level < NDN_SCHEDULER_WHEEL_LEVELS; level++) {
+    timetick_t time;
+    if (!wheel_next_slot(self, level, &time)) {
+      continue;
+    }
+    // an event runs once the time has passed its tick, and a slot is moved once it is reached
+    if (level == 0) {
+      time++;
+    }
+    if (!found || time < *deadline) {
+      *deadline = time;
+      found = true;
+    }
+  }
+  return found;
+}
+
+#endif // NDN_SCHEDULER_TIMING_WHEEL
@@ -8,78 +8,182 @@
 
 #include "scheduler.h"
 
-#define LEFT(x) ((x) << 1)
-#define RIGHT(x) (((x) << 1) | 1)
-#define PARENT(x) ((x) >> 1)
+#ifndef NDN_SCHEDULER_TIMING_WHEEL
 
-typedef struct ndn_event {
-  timetick_t tick;
-  void* obj;
-  ndn_event_callback func;
-  void* pparam;
-  int32_t iparam;
-} ndn_event_t;
+#define HANDLE_OF(slot, generation) \
+  (((ndn_event_handle_t)(generation) << NDN_SCHEDULER_SLOT_BITS) | (slot))
+#define HANDLE_SLOT(handle) ((ndn_event_slot_t)(handle))
+#define HANDLE_GENERATION(handle) ((ndn_event_slot_t)((handle) >> NDN_SCHEDULER_SLOT_BITS))
 
-static ndn_event_t events[NDN_SCHEDULER_SIZE + 1];
-static uint32_t event_cnt;
+// Whether the event in slot a should run before the one in slot b
+static bool
+scheduler_before(const ndn_scheduler_t* self, ndn_event_slot_t a, ndn_event_slot_t b)
+{
+  const ndn_event_t* x = &self->events[a];
+  const ndn_event_t* y = &self->events[b];
+  if (x->tick != y->tick) {
+    return x->tick < y->tick;
+  }
+  return (int32_t)(x->post_seq - y->post_seq) < 0;
+}
+
+static void
+scheduler_heap_set(ndn_scheduler_t* self, ndn_event_slot_t pos, ndn_event_slot_t slot)
+{
+  self->heap[pos] = slot;
+  self->events[slot].heap_pos = pos;
+}
+
+static void
+scheduler_sift_up(ndn_scheduler_t* self, ndn_event_slot_t pos)
+{
+  ndn_event_slot_t slot = self->heap[pos];
+  while (pos > 0) {
+    ndn_event_slot_t parent = (pos - 1) / 2;
+    if (!scheduler_before(self, slot, self->heap[parent])) {
+      break;
+    }
+    scheduler_heap_set(self, pos, self->heap[parent]);
+    pos = parent;
+  }
+  scheduler_heap_set(self, pos, slot);
+}
+
+static void
+scheduler_sift_down(ndn_scheduler_t* self, ndn_event_slot_t pos)
+{
+  ndn_event_slot_t slot = self->heap[pos];
+  while (true) {
+    uint32_t child = 2 * (uint32_t)pos + 1;
+    if (child >= self->event_cnt) {
+      break;
+    }
+    if (child + 1 < self->event_cnt && scheduler_before(self, self->heap[child + 1], self->heap[child])) {
+      child++;
+    }
+    if (!scheduler_before(self, self->heap[child], slot)) {
+      break;
+    }
+    scheduler_heap_set(self, pos, self->heap[child]);
+    pos = (ndn_event_slot_t)child;
+  }
+  scheduler_heap_set(self, pos, slot);
+}
+
+// Take a pending event out of the heap and free its slot
+static void
+scheduler_remove(ndn_scheduler_t* self, ndn_event_slot_t slot)
+{
+  ndn_event_slot_t pos = self->events[slot].heap_pos;
+  ndn_event_slot_t last = self->heap[--self->event_cnt];
+  if (pos != self->event_cnt) {
+    scheduler_heap_set(self, pos, last);
+    scheduler_sift_up(self, pos);
+    scheduler_sift_down(self, self->events[last].heap_pos);
+  }
+  self->events[slot].heap_pos = NDN_SCHEDULER_SLOT_NONE;
+  self->free_slots[self->capacity - self->event_cnt - 1] = slot;
+}
 
 void
-ndn_scheduler_init(void)
+ndn_scheduler_init(ndn_scheduler_t* self, uint8_t* region, ndn_event_slot_t capacity)
 {
-  event_cnt = 0;
+  self->events = (ndn_event_t*)region;
+  region += NDN_POOL_ALIGN_UP(sizeof(ndn_event_t) * (size_t)capacity);
+  self->free_slots = (ndn_event_slot_t*)region;
+  region += NDN_POOL_ALIGN_UP(sizeof(ndn_event_slot_t) * (size_t)capacity);
+  self->heap = (ndn_event_slot_t*)region;
+  self->capacity = capacity;
+  for (ndn_event_slot_t i = 0; i < capacity; i++) {
+    self->events[i].heap_pos = NDN_SCHEDULER_SLOT_NONE;
+    self->events[i].generation = 0;
+    // slot 0 is on the top
+    self->free_slots[i] = (ndn_event_slot_t)(capacity - 1 - i);
+  }
+  self->event_cnt = 0;
+  self->post_cnt = 0;
+  self->now = 0;
 }
 
-bool
-ndn_scheduler_post(timetick_t timepoint,
+ndn_event_handle_t
+ndn_scheduler_post(ndn_scheduler_t* self,
+                   timetick_t timepoint,
                    void *target,
                    ndn_event_callback reason,
                    uint32_t iparam,
                    void *pparam)
 {
-  int i;
+  if (self->event_cnt >= self->capacity) {
+    return NDN_EVENT_HANDLE_NONE;
+  }
+  ndn_event_slot_t slot = self->free_slots[self->capacity - self->event_cnt - 1];
+  ndn_event_t* event = &self->events[slot];
+  event->tick = timepoint;
+  event->obj = target;
+  event->func = reason;
+  event->iparam = iparam;
+  event->pparam = pparam;
+  event->post_seq = self->post_cnt++;
+  // a handle is never NDN_EVENT_HANDLE_NONE, as the generation is never 0
+  if (++event->generation == 0) {
+    event->generation = 1;
+  }
+  scheduler_heap_set(self, (ndn_event_slot_t)self->event_cnt++, slot);
+  scheduler_sift_up(self, event->heap_pos);
+  return HANDLE_OF(slot, event->generation);
+}
 
-  if(event_cnt >= NDN_SCHEDULER_SIZE)
+ndn_event_handle_t
+ndn_scheduler_post_after(ndn_scheduler_t* self,
+                         timetick_t delay,
+                         void *target,
+                         ndn_event_callback reason,
+                         uint32_t iparam,
+                         void *pparam)
+{
+  return ndn_scheduler_post(self, self->now + delay, target, reason, iparam, pparam);
+}
+
+bool
+ndn_scheduler_cancel(ndn_scheduler_t* self, ndn_event_handle_t handle)
+{
+  ndn_event_slot_t slot = HANDLE_SLOT(handle);
+  if (handle == NDN_EVENT_HANDLE_NONE || slot >= self->capacity) {
+    return false;
+  }
+  const ndn_event_t* event = &self->events[slot];
+  if (event->heap_pos == NDN_SCHEDULER_SLOT_NONE || event->generation != HANDLE_GENERATION(handle)) {
     return false;
-  
-  event_cnt ++;
-  events[0].tick = timepoint;
-  events[0].obj = target;
-  events[0].func = reason;
-  events[0].iparam = iparam;
-  events[0].pparam = pparam;
-  
-  for(i = event_cnt; i > 1 && events[PARENT(i)].tick > events[0].tick; i = PARENT(i))
-    events[i] = events[PARENT(i)];
-  events[i] = events[0];
-  
+  }
+  scheduler_remove(self, slot);
   return true;
 }
 
 bool
-ndn_scheduler_process(timetick_t now)
+ndn_scheduler_process(ndn_scheduler_t* self, timetick_t now)
 {
-  int i, large;
   bool ret = false;
-  
-  while(event_cnt >= 1 && events[1].tick < now) {
-    events[1].func(events[1].obj, events[1].iparam, events[1].pparam);
-    event_cnt --;
-    
-    i = 1;
-    while(i > 0 || i <= event_cnt) {
-      large = event_cnt + 1;
-      if(LEFT(i) <= event_cnt && events[LEFT(i)].tick < events[large].tick)
-        large = LEFT(i);
-      if(RIGHT(i) <= event_cnt && events[RIGHT(i)].tick < events[large].tick)
-        large = RIGHT(i);
-      events[i] = events[large];
-      if(large != event_cnt + 1)
-        i = large;
-      else
-        break;
-    }
-    
+  ndn_scheduler_set_time(self, now);
+  while (self->event_cnt > 0 && self->events[self->heap[0]].tick < now) {
+    // Pop the event before invoking it, since the callback may post new events
+    ndn_event_slot_t slot = self->heap[0];
+    ndn_event_t event = self->events[slot];
+    scheduler_remove(self, slot);
+    event.func(event.obj, event.iparam, event.pparam);
     ret = true;
   }
   return ret;
 }
+
+bool
+ndn_scheduler_next_deadline(const ndn_scheduler_t* self, timetick_t* deadline)
+{
+  if (self->event_cnt == 0) {
+    return false;
+  }
+  // an event runs once the time has passed its tick
+  *deadline = self->events[self->heap[0]].tick + 1;
+  return true;
+}
+
+#endif // NDN_SCHEDULER_TIMING_WHEEL
@@ -9,40 +9,298 @@
 #ifndef FORWARDER_SCHEDULER_H_
 #define FORWARDER_SCHEDULER_H_
 
-#include <inttypes.h>
+#include "../util/clock.h"
+#include "memory-pool.h"
 #include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-// TODO: This is a temporary solution. Wait for the timer to be implemented.
-typedef uint64_t timetick_t;
+/*
+ * The event slots are numbered with 16 bits by default, which suits the few timers of a
+ * device. Defining NDN_SCHEDULER_WIDE_SLOTS at compile time numbers them with 32 bits, for
+ * a scheduler of more than 65534 events, at the cost of larger handles and slot links.
+ * The timing wheel is meant for many events, so it always has wide slots.
+ */
+#if defined(NDN_SCHEDULER_TIMING_WHEEL) && !defined(NDN_SCHEDULER_WIDE_SLOTS)
+#define NDN_SCHEDULER_WIDE_SLOTS
+#endif
+
+#ifdef NDN_SCHEDULER_WIDE_SLOTS
+/**
+ * The number of an event slot.
+ */
+typedef uint32_t ndn_event_slot_t;
 
 /**
- * The maximum events in the scheduler
+ * The handle of a posted event, to cancel it: the generation of its slot, followed by
+ * the slot number.
+ * A handle stays unique while its event is pending, and is no longer valid once the event
+ * has run or been cancelled.
+ */
+typedef uint64_t ndn_event_handle_t;
+
+/**
+ * The bits of the slot number in a handle.
+ */
+#define NDN_SCHEDULER_SLOT_BITS 32
+
+/**
+ * The most events a scheduler can hold, so that the positions of the heap do not overflow.
+ */
+#define NDN_SCHEDULER_MAX_SIZE 0x7FFFFFFE
+#else
+typedef uint16_t ndn_event_slot_t;
+typedef uint32_t ndn_event_handle_t;
+#define NDN_SCHEDULER_SLOT_BITS 16
+#define NDN_SCHEDULER_MAX_SIZE 65534
+#endif
+
+/**
+ * The slot of no event, which marks a free slot and the ends of the lists of the
+ * timing wheel.
+ */
+#define NDN_SCHEDULER_SLOT_NONE ((ndn_event_slot_t)(-1))
+
+/*
+ * The scheduler keeps its events in a binary heap by default, which takes O(log n) to post,
+ * cancel and run an event, and suits the few timers of a device.
+ * Defining NDN_SCHEDULER_TIMING_WHEEL at compile time replaces it with a hierarchical
+ * timing wheel of the same API, which takes O(1) to post and cancel an event and runs the
+ * events of each millisecond in one batch, for a scheduler of many events.
  */
-#define NDN_SCHEDULER_SIZE 127
+#ifdef NDN_SCHEDULER_TIMING_WHEEL
+
+/**
+ * The slots of each level of the timing wheel, which fit a 64-bit bitmap.
+ */
+#define NDN_SCHEDULER_WHEEL_SLOTS 64
+
+/**
+ * The levels of the timing wheel.
+ * A slot of level l spans 64^l milliseconds, so that the wheel spans 2^30 milliseconds,
+ * about 12 days. An event later than that waits in the top level, and is placed again
+ * when its slot is reached.
+ */
+#define NDN_SCHEDULER_WHEEL_LEVELS 5
+
+/**
+ * The event lists of the timing wheel: one for each slot, and one for the events already
+ * due when they are posted.
+ */
+#define NDN_SCHEDULER_WHEEL_LISTS (NDN_SCHEDULER_WHEEL_LEVELS * NDN_SCHEDULER_WHEEL_SLOTS + 1)
+
+#endif // NDN_SCHEDULER_TIMING_WHEEL
+
+/**
+ * The handle of no event, returned when an event cannot be posted.
+ */
+#define NDN_EVENT_HANDLE_NONE 0
 
 typedef void(*ndn_event_callback)(void *self,
                                   uint32_t iparam,
                                   void *pparam);
 
+typedef struct ndn_event {
+  timetick_t tick;
+  void* obj;
+  ndn_event_callback func;
+  void* pparam;
+  int32_t iparam;
+
+#ifdef NDN_SCHEDULER_TIMING_WHEEL
+  /**
+   * The list of the wheel holding the event. NDN_SCHEDULER_WHEEL_LISTS if the slot is free.
+   */
+  uint16_t list;
+
+  /**
+   * The neighbors of the event in its list. NDN_SCHEDULER_SLOT_NONE at the ends.
+   */
+  ndn_event_slot_t prev;
+  ndn_event_slot_t next;
+#else
+  /**
+   * The order in which the event was posted, to run the events due at the same tick
+   * in that order.
+   */
+  uint32_t post_seq;
+
+  /**
+   * The position of the event in the heap. NDN_SCHEDULER_SLOT_NONE if the slot is free.
+   */
+  ndn_event_slot_t heap_pos;
+#endif
+
+  /**
+   * Incremented each time the slot is taken, so that the handle of a past event in the
+   * same slot is told apart. It is as wide as a slot number, so that a handle holds both.
+   */
+  ndn_event_slot_t generation;
+} ndn_event_t;
 
+/**
+ * The class of scheduler.
+ * Each forwarder owns one, so that several forwarders can run in one program.
+ * Events are kept in fixed slots carved from a memory region, ordered by a binary
+ * min-heap of slot numbers on their ticks, or by a timing wheel if
+ * NDN_SCHEDULER_TIMING_WHEEL is defined.
+ */
+typedef struct ndn_scheduler {
+  /**
+   * The event slots.
+   */
+  ndn_event_t* events;
+
+#ifdef NDN_SCHEDULER_TIMING_WHEEL
+  /**
+   * The first and the last events of each list. NDN_SCHEDULER_SLOT_NONE if it is empty.
+   * The list of slot s in level l is at l * NDN_SCHEDULER_WHEEL_SLOTS + s.
+   */
+  ndn_event_slot_t heads[NDN_SCHEDULER_WHEEL_LISTS];
+  ndn_event_slot_t tails[NDN_SCHEDULER_WHEEL_LISTS];
+
+  /**
+   * Whether each slot of each level has an event.
+   */
+  uint64_t occupied[NDN_SCHEDULER_WHEEL_LEVELS];
+
+  /**
+   * The next millisecond of the wheel to run. The events before it have been run, except
+   * the ones in the list of due events.
+   */
+  timetick_t wheel_time;
+#else
+  /**
+   * The slots of the pending events, as a binary heap on their ticks.
+   */
+  ndn_event_slot_t* heap;
+  uint32_t post_cnt;
+#endif
+
+  /**
+   * The stack of the free slots, the top being at capacity - event_cnt - 1.
+   */
+  ndn_event_slot_t* free_slots;
+
+  /**
+   * The number of event slots.
+   */
+  ndn_event_slot_t capacity;
+
+  uint32_t event_cnt;
+
+  /**
+   * The current time, given by the latest ndn_scheduler_process() or
+   * ndn_scheduler_set_time(). Delays are counted from it.
+   */
+  timetick_t now;
+} ndn_scheduler_t;
+
+/**
+ * The bytes of memory region taken by a scheduler: the event slots, the free slot stack
+ * and the heap if there is one, each aligned to NDN_POOL_ALIGN.
+ */
+#ifdef NDN_SCHEDULER_TIMING_WHEEL
+#define NDN_SCHEDULER_REGION_SIZE(capacity) \
+  (NDN_POOL_ALIGN_UP(sizeof(ndn_event_t) * (size_t)(capacity)) \
+   + NDN_POOL_ALIGN_UP(sizeof(ndn_event_slot_t) * (size_t)(capacity)))
+#else
+#define NDN_SCHEDULER_REGION_SIZE(capacity) \
+  (NDN_POOL_ALIGN_UP(sizeof(ndn_event_t) * (size_t)(capacity)) \
+   + 2 * NDN_POOL_ALIGN_UP(sizeof(ndn_event_slot_t) * (size_t)(capacity)))
+#endif
+
+/**
+ * Init an empty scheduler.
+ * @param self. Output. The scheduler to be inited.
+ * @param region. Input. The memory region the event slots are carved from, aligned to
+ *                NDN_POOL_ALIGN and of NDN_SCHEDULER_REGION_SIZE() bytes. It must outlive
+ *                the scheduler.
+ * @param capacity. Input. The number of event slots, up to NDN_SCHEDULER_MAX_SIZE.
+ */
 void
-ndn_scheduler_init(void);
+ndn_scheduler_init(ndn_scheduler_t* self, uint8_t* region, ndn_event_slot_t capacity);
 
-// TODO: Current scheduler uses absolute timepoint due to the absence of timer.
-bool
-ndn_scheduler_post(timetick_t timepoint,
+/**
+ * Post an event at a time point.
+ * @param self. Input/Output. The scheduler.
+ * @param timepoint. Input. The time point. The event runs in the first
+ *                   ndn_scheduler_process() given a later time.
+ * @param target. Input. The object passed to the callback.
+ * @param reason. Input. The callback.
+ * @param iparam. Input. The integer parameter passed to the callback.
+ * @param pparam. Input. The pointer parameter passed to the callback.
+ * @return the handle of the event. NDN_EVENT_HANDLE_NONE if the scheduler is full.
+ */
+ndn_event_handle_t
+ndn_scheduler_post(ndn_scheduler_t* self,
+                   timetick_t timepoint,
                    void *target,
                    ndn_event_callback reason,
                    uint32_t iparam,
                    void *pparam);
 
-// TODO: Current scheduler gives current time explicitly due to the absence of timer.
+/**
+ * Post an event after a delay from the current time of the scheduler.
+ * See ndn_scheduler_post().
+ */
+ndn_event_handle_t
+ndn_scheduler_post_after(ndn_scheduler_t* self,
+                         timetick_t delay,
+                         void *target,
+                         ndn_event_callback reason,
+                         uint32_t iparam,
+                         void *pparam);
+
+/**
+ * Cancel a pending event.
+ * @param self. Input/Output. The scheduler.
+ * @param handle. Input. The handle returned when the event was posted.
+ * @return true if the event was pending. false if it has run, has been cancelled, or
+ *         @p handle is NDN_EVENT_HANDLE_NONE.
+ */
+bool
+ndn_scheduler_cancel(ndn_scheduler_t* self, ndn_event_handle_t handle);
+
+/**
+ * Run the events due before a time point, in the order of their ticks.
+ * The heap runs the events due at the same tick in the order they were posted, while the
+ * timing wheel runs them in any order.
+ * A callback may post or cancel events.
+ * @param self. Input/Output. The scheduler.
+ * @param now. Input. The current time, read from a monotonic clock, e.g., ndn_clock_now().
+ * @return true if any event was run.
+ */
+bool
+ndn_scheduler_process(ndn_scheduler_t* self, timetick_t now);
+
+/**
+ * Get the earliest time at which ndn_scheduler_process() will run an event, e.g., to
+ * know how long the main loop can sleep.
+ * @param self. Input. The scheduler.
+ * @param deadline. Output. The time point, which may have passed already.
+ *                  The timing wheel may give an earlier time than the event, when it only
+ *                  moves the events to a finer level, so ask again after processing.
+ * @return false if there is no pending event.
+ */
 bool
-ndn_scheduler_process(timetick_t now);
+ndn_scheduler_next_deadline(const ndn_scheduler_t* self, timetick_t* deadline);
+
+/**
+ * Advance the current time of the scheduler without running the events, so that the
+ * events posted after a delay before the next ndn_scheduler_process() are timed right.
+ * @param self. Input/Output. The scheduler.
+ * @param now. Input. The current time. An earlier time than the current one is ignored.
+ */
+static inline void
+ndn_scheduler_set_time(ndn_scheduler_t* self, timetick_t now)
+{
+  if (now > self->now) {
+    self->now = now;
+  }
+}
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,391 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include "strategy.h"
+#include "forwarder.h"
+
+/************************************************************/
+/*  Definition of built-in strategies                       */
+/************************************************************/
+
+// The face of a next hop, which is in the face table as long as the FIB refers to it
+static ndn_face_intf_t*
+strategy_nexthop_face(ndn_forwarder_t* forwarder, const ndn_fib_nexthop_t* nexthop)
+{
+  return forwarder_get_face(forwarder, nexthop->face_id);
+}
+
+int
+strategy_send_interest(ndn_pit_entry_t* pit_entry, ndn_face_intf_t* face,
+                       const uint8_t* raw_interest, uint32_t size, timetick_t now)
+{
+  int ret = pit_entry_insert_out_record(pit_entry, face, pit_entry->nonce, now);
+  if (ret != 0) {
+    return ret;
+  }
+  return ndn_face_send(face, NULL, raw_interest, size);
+}
+
+// Whether a next hop can take an Interest from face
+static bool
+strategy_nexthop_usable(ndn_forwarder_t* forwarder, const ndn_fib_nexthop_t* nexthop,
+                        const ndn_face_intf_t* face)
+{
+  return nexthop->face_id != face->face_id
+         && strategy_nexthop_face(forwarder, nexthop)->state == NDN_FACE_STATE_UP;
+}
+
+// xorshift: spreading the load does not need a strong RNG
+static uint32_t
+strategy_random(ndn_strategy_measurements_t* measurements)
+{
+  uint32_t state = measurements->random_state;
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  measurements->random_state = state;
+  return state;
+}
+
+static int
+strategy_best_route_after_receive_interest(ndn_forwarder_t* forwarder,
+                                           const ndn_fib_entry_t* fib_entry,
+                                           ndn_pit_entry_t* pit_entry,
+                                           ndn_face_intf_t* face,
+                                           const ndn_name_view_t* name,
+                                           const uint8_t* raw_interest, uint32_t size,
+                                           timetick_t now)
+{
+  (void)name;
+  // nexthops are sorted by cost
+  for (uint8_t i = 0; i < fib_entry->nexthop_size; i++) {
+    if (strategy_nexthop_usable(forwarder, &fib_entry->nexthops[i], face)) {
+      return strategy_send_interest(pit_entry, strategy_nexthop_face(forwarder, &fib_entry->nexthops[i]),
+                                    raw_interest, size, now);
+    }
+  }
+  return NDN_FWD_INTEREST_REJECTED;
+}
+
+static int
+strategy_multicast_after_receive_interest(ndn_forwarder_t* forwarder,
+                                          const ndn_fib_entry_t* fib_entry,
+                                          ndn_pit_entry_t* pit_entry,
+                                          ndn_face_intf_t* face,
+                                          const ndn_name_view_t* name,
+                                          const uint8_t* raw_interest, uint32_t size,
+                                          timetick_t now)
+{
+  (void)name;
+  // the Interest is forwarded if any next hop takes it
+  int ret = NDN_FWD_INTEREST_REJECTED;
+  for (uint8_t i = 0; i < fib_entry->nexthop_size; i++) {
+    if (strategy_nexthop_usable(forwarder, &fib_entry->nexthops[i], face)) {
+      int send_ret = strategy_send_interest(pit_entry, strategy_nexthop_face(forwarder, &fib_entry->nexthops[i]),
+                                            raw_interest, size, now);
+      if (ret != 0) {
+        ret = send_ret;
+      }
+    }
+  }
+  return ret;
+}
+
+static int
+strategy_load_balance_after_receive_interest(ndn_forwarder_t* forwarder,
+                                             const ndn_fib_entry_t* fib_entry,
+                                             ndn_pit_entry_t* pit_entry,
+                                             ndn_face_intf_t* face,
+                                             const ndn_name_view_t* name,
+                                             const uint8_t* raw_interest, uint32_t size,
+                                             timetick_t now)
+{
+  (void)name;
+  uint8_t usable[NDN_FIB_MAX_NEXTHOPS];
+  uint8_t usable_size = 0;
+  for (uint8_t i = 0; i < fib_entry->nexthop_size; i++) {
+    if (strategy_nexthop_usable(forwarder, &fib_entry->nexthops[i], face)) {
+      usable[usable_size++] = i;
+    }
+  }
+  if (usable_size == 0) {
+    return NDN_FWD_INTEREST_REJECTED;
+  }
+  const ndn_fib_nexthop_t* nexthop = &fib_entry->nexthops[usable[strategy_random(&forwarder->measurements) % usable_size]];
+  return strategy_send_interest(pit_entry, strategy_nexthop_face(forwarder, nexthop), raw_interest, size, now);
+}
+
+const ndn_strategy_t ndn_strategy_best_route = {
+  .after_receive_interest = strategy_best_route_after_receive_interest,
+  .before_satisfy_interest = NULL,
+  .on_interest_timeout = NULL,
+};
+
+const ndn_strategy_t ndn_strategy_multicast = {
+  .after_receive_interest = strategy_multicast_after_receive_interest,
+  .before_satisfy_interest = NULL,
+  .on_interest_timeout = NULL,
+};
+
+const ndn_strategy_t ndn_strategy_load_balance = {
+  .after_receive_interest = strategy_load_balance_after_receive_interest,
+  .before_satisfy_interest = NULL,
+  .on_interest_timeout = NULL,
+};
+
+/************************************************************/
+/*  Definition of adaptive SRTT-based strategy              */
+/************************************************************/
+
+static ndn_asf_measurement_t*
+asf_measurement_find(ndn_asf_measurement_t* records, uint32_t prefix_hash, uint8_t face_id)
+{
+  for (uint8_t i = 0; i < NDN_ASF_MEASUREMENTS_SIZE; i++) {
+    if (records[i].face_id == face_id && records[i].prefix_hash == prefix_hash) {
+      return &records[i];
+    }
+  }
+  return NULL;
+}
+
+static ndn_asf_measurement_t*
+asf_measurement_find_or_insert(ndn_asf_measurement_t* records, uint32_t prefix_hash,
+                               uint8_t face_id, timetick_t now)
+{
+  ndn_asf_measurement_t* record = asf_measurement_find(records, prefix_hash, face_id);
+  if (record == NULL) {
+    record = &records[0];
+    for (uint8_t i = 0; i < NDN_ASF_MEASUREMENTS_SIZE && record->face_id != NDN_INVALID_FACE_ID; i++) {
+      if (records[i].face_id == NDN_INVALID_FACE_ID
+          || records[i].last_used < record->last_used) {
+        record = &records[i];
+      }
+    }
+    record->face_id = face_id;
+    record->prefix_hash = prefix_hash;
+    record->srtt = 0;
+    record->timeouts = 0;
+  }
+  record->last_used = now;
+  return record;
+}
+
+// Rank of a next hop, the lower the better: working and measured, then unmeasured, then failing
+static uint32_t
+asf_rank(ndn_asf_measurement_t* records, uint32_t prefix_hash, const ndn_fib_nexthop_t* nexthop)
+{
+  const ndn_asf_measurement_t* record = asf_measurement_find(records, prefix_hash, nexthop->face_id);
+  if (record != NULL && record->timeouts >= NDN_ASF_MAX_TIMEOUTS) {
+    return 0xFFFFFF00u + nexthop->cost;
+  }
+  if (record == NULL || record->srtt == 0) {
+    return 0xFFFF0000u + nexthop->cost;
+  }
+  return record->srtt < 0xFFFF0000u ? (uint32_t)record->srtt : 0xFFFEFFFFu;
+}
+
+static int
+strategy_asf_after_receive_interest(ndn_forwarder_t* forwarder,
+                                    const ndn_fib_entry_t* fib_entry,
+                                    ndn_pit_entry_t* pit_entry,
+                                    ndn_face_intf_t* face,
+                                    const ndn_name_view_t* name,
+                                    const uint8_t* raw_interest, uint32_t size,
+                                    timetick_t now)
+{
+  (void)name;
+  ndn_strategy_measurements_t* measurements = &forwarder->measurements;
+  int8_t best = -1;
+  uint32_t best_rank = 0;
+  uint8_t usable[NDN_FIB_MAX_NEXTHOPS];
+  uint8_t usable_size = 0;
+  for (uint8_t i = 0; i < fib_entry->nexthop_size; i++) {
+    if (!strategy_nexthop_usable(forwarder, &fib_entry->nexthops[i], face)) {
+      continue;
+    }
+    usable[usable_size++] = i;
+    uint32_t rank = asf_rank(measurements->asf, fib_entry->name_hash, &fib_entry->nexthops[i]);
+    if (best < 0 || rank < best_rank) {
+      best = i;
+      best_rank = rank;
+    }
+  }
+  if (best < 0) {
+    return NDN_FWD_INTEREST_REJECTED;
+  }
+
+  // Measurements are looked up again when Data comes back or the entry expires
+  pit_entry->strategy_info = fib_entry->name_hash;
+  int ret = strategy_send_interest(pit_entry, strategy_nexthop_face(forwarder, &fib_entry->nexthops[best]),
+                                   raw_interest, size, now);
+  if (ret != 0) {
+    return ret;
+  }
+  asf_measurement_find_or_insert(measurements->asf, fib_entry->name_hash, fib_entry->nexthops[best].face_id, now);
+
+  // Probe another next hop from time to time
+  measurements->asf_interest_cnt++;
+  if (measurements->asf_interest_cnt >= NDN_ASF_PROBE_INTERVAL && usable_size > 1) {
+    measurements->asf_interest_cnt = 0;
+    uint8_t probe = usable[strategy_random(measurements) % (usable_size - 1)];
+    if (probe == best) {
+      probe = usable[usable_size - 1];
+    }
+    // the Interest is already forwarded, so a probe that cannot be sent is skipped
+    if (strategy_send_interest(pit_entry, strategy_nexthop_face(forwarder, &fib_entry->nexthops[probe]),
+                               raw_interest, size, now) == 0) {
+      asf_measurement_find_or_insert(measurements->asf, fib_entry->name_hash, fib_entry->nexthops[probe].face_id, now);
+    }
+  }
+  return 0;
+}
+
+static void
+strategy_asf_before_satisfy_interest(ndn_forwarder_t* forwarder, const ndn_pit_entry_t* pit_entry,
+                                     const ndn_face_intf_t* face, timetick_t now)
+{
+  for (uint8_t i = 0; i < pit_entry->out_record_size; i++) {
+    if (pit_entry->out_records[i].face_id != face->face_id) {
+      continue;
+    }
+    ndn_asf_measurement_t* record = asf_measurement_find(forwarder->measurements.asf,
+                                                         pit_entry->strategy_info, face->face_id);
+    if (record == NULL) {
+      return;
+    }
+    timetick_t rtt = now - pit_entry->out_records[i].last_sent;
+    if (rtt == 0) {
+      rtt = 1;
+    }
+    // exponential smoothing with a gain of 1/8, as TCP does
+    record->srtt = (record->srtt == 0) ? rtt : (record->srtt * 7 + rtt) / 8;
+    record->timeouts = 0;
+    record->last_used = now;
+    return;
+  }
+}
+
+static void
+strategy_asf_on_interest_timeout(ndn_forwarder_t* forwarder, const ndn_pit_entry_t* pit_entry,
+                                 timetick_t now)
+{
+  (void)now;
+  for (uint8_t i = 0; i < pit_entry->out_record_size; i++) {
+    ndn_asf_measurement_t* record = asf_measurement_find(forwarder->measurements.asf,
+                                                         pit_entry->strategy_info,
+                                                         pit_entry->out_records[i].face_id);
+    if (record != NULL && record->timeouts < NDN_ASF_MAX_TIMEOUTS) {
+      record->timeouts++;
+    }
+  }
+}
+
+const ndn_strategy_t ndn_strategy_asf = {
+  .after_receive_interest = strategy_asf_after_receive_interest,
+  .before_satisfy_interest = strategy_asf_before_satisfy_interest,
+  .on_interest_timeout = strategy_asf_on_interest_timeout,
+};
+
+void
+strategy_init(ndn_strategy_measurements_t* measurements, uint32_t seed)
+{
+  for (uint8_t i = 0; i < NDN_ASF_MEASUREMENTS_SIZE; i++) {
+    measurements->asf[i].face_id = NDN_INVALID_FACE_ID;
+  }
+  measurements->asf_interest_cnt = 0;
+  // xorshift never leaves 0
+  measurements->random_state = (seed != 0) ? seed : NDN_STRATEGY_DEFAULT_SEED;
+}
+
+void
+strategy_remove_face(ndn_strategy_measurements_t* measurements, const ndn_face_intf_t* face)
+{
+  for (uint8_t i = 0; i < NDN_ASF_MEASUREMENTS_SIZE; i++) {
+    if (measurements->asf[i].face_id == face->face_id) {
+      measurements->asf[i].face_id = NDN_INVALID_FACE_ID;
+    }
+  }
+}
+
+/************************************************************/
+/*  Definition of strategy-choice table                     */
+/************************************************************/
+
+void
+strategy_choice_init(ndn_strategy_choice_t* table)
+{
+  for (uint8_t i = 0; i < NDN_STRATEGY_CHOICE_MAX_SIZE; i++) {
+    table->slots[i].name_prefix = NDN_NAME_REF_NULL;
+    table->slots[i].strategy = NULL;
+  }
+  name_arena_init(&table->names, table->name_buffer, sizeof(table->name_buffer));
+}
+
+int
+strategy_choice_set(ndn_strategy_choice_t* table, const ndn_name_t* name_prefix,
+                    const ndn_strategy_t* strategy)
+{
+  ndn_strategy_choice_entry_t* empty = NULL;
+  for (uint8_t i = 0; i < NDN_STRATEGY_CHOICE_MAX_SIZE; i++) {
+    ndn_strategy_choice_entry_t* entry = &table->slots[i];
+    if (entry->name_prefix == NDN_NAME_REF_NULL) {
+      if (empty == NULL)
+        empty = entry;
+    }
+    else if (name_arena_compare_name(&table->names, entry->name_prefix, name_prefix) == 0) {
+      entry->strategy = strategy;
+      return 0;
+    }
+  }
+  if (empty == NULL) {
+    return NDN_FWD_STRATEGY_CHOICE_FULL;
+  }
+  empty->name_prefix = name_arena_store_name(&table->names, name_prefix);
+  if (empty->name_prefix == NDN_NAME_REF_NULL) {
+    return NDN_FWD_STRATEGY_CHOICE_FULL;
+  }
+  empty->strategy = strategy;
+  return 0;
+}
+
+void
+strategy_choice_unset(ndn_strategy_choice_t* table, const ndn_name_t* name_prefix)
+{
+  for (uint8_t i = 0; i < NDN_STRATEGY_CHOICE_MAX_SIZE; i++) {
+    ndn_strategy_choice_entry_t* entry = &table->slots[i];
+    if (entry->name_prefix != NDN_NAME_REF_NULL
+        && name_arena_compare_name(&table->names, entry->name_prefix, name_prefix) == 0) {
+      name_arena_release(&table->names, entry->name_prefix);
+      entry->name_prefix = NDN_NAME_REF_NULL;
+      entry->strategy = NULL;
+      return;
+    }
+  }
+}
+
+const ndn_strategy_t*
+strategy_choice_find(const ndn_strategy_choice_t* table, const ndn_name_view_t* name)
+{
+  const ndn_strategy_choice_entry_t* match = NULL;
+  uint8_t match_size = 0;
+  for (uint8_t i = 0; i < NDN_STRATEGY_CHOICE_MAX_SIZE; i++) {
+    const ndn_strategy_choice_entry_t* entry = &table->slots[i];
+    if (entry->name_prefix == NDN_NAME_REF_NULL) {
+      continue;
+    }
+    if (name_arena_is_prefix_of_view(&table->names, entry->name_prefix, name) != 0) {
+      continue;
+    }
+    uint8_t size = name_arena_components_size(&table->names, entry->name_prefix);
+    if (match == NULL || size > match_size) {
+      match = entry;
+      match_size = size;
+    }
+  }
+  return match != NULL ? match->strategy : &ndn_strategy_best_route;
+}
@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef FORWARDER_STRATEGY_H_
+#define FORWARDER_STRATEGY_H_
+
+#include "fib.h"
+#include "pit.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct ndn_forwarder;
+
+/**
+ * ndn_strategy_after_receive_interest is a function pointer to the forwarding decision of a strategy.
+ * It is invoked when an Interest needs to be forwarded, and sends the Interest out through
+ * some of the next hops of the FIB entry with strategy_send_interest().
+ * @param forwarder. Input/Output. The forwarder running the strategy.
+ * @param fib_entry. Input. The FIB entry matched by the Interest name.
+ * @param pit_entry. Input/Output. The PIT entry of the Interest.
+ * @param face. Input. The face where the Interest came from.
+ * @param name. Input. The view of the Interest name.
+ * @param raw_interest. Input. The wire format Interest.
+ * @param size. Input. The size of the wire format Interest.
+ * @param now. Input. The current time.
+ * @return 0 if the Interest is sent out. NDN_FWD_INTEREST_REJECTED if there is no usable next hop,
+ *         or the error of strategy_send_interest() if the Interest could not be sent, so that
+ *         the forwarder Nacks it.
+ */
+typedef int (*ndn_strategy_after_receive_interest)(struct ndn_forwarder* forwarder,
+                                                   const ndn_fib_entry_t* fib_entry,
+                                                   ndn_pit_entry_t* pit_entry,
+                                                   ndn_face_intf_t* face,
+                                                   const ndn_name_view_t* name,
+                                                   const uint8_t* raw_interest, uint32_t size,
+                                                   timetick_t now);
+
+/**
+ * ndn_strategy_before_satisfy_interest is a function pointer invoked when Data satisfies
+ * a PIT entry, before the entry is deleted.
+ * @param forwarder. Input/Output. The forwarder running the strategy.
+ * @param pit_entry. Input. The PIT entry.
+ * @param face. Input. The face where the Data came from.
+ * @param now. Input. The current time.
+ */
+typedef void (*ndn_strategy_before_satisfy_interest)(struct ndn_forwarder* forwarder,
+                                                     const ndn_pit_entry_t* pit_entry,
+                                                     const ndn_face_intf_t* face,
+                                                     timetick_t now);
+
+/**
+ * ndn_strategy_on_interest_timeout is a function pointer invoked when a PIT entry expires
+ * without Data, before the entry is deleted.
+ * @param forwarder. Input/Output. The forwarder running the strategy.
+ * @param pit_entry. Input. The PIT entry.
+ * @param now. Input. The current time.
+ */
+typedef void (*ndn_strategy_on_interest_timeout)(struct ndn_forwarder* forwarder,
+                                                 const ndn_pit_entry_t* pit_entry,
+                                                 timetick_t now);
+
+/**
+ * The class of forwarding strategies.
+ * A strategy is a table of function pointers, which is resolved once for each PIT entry.
+ */
+typedef struct ndn_strategy {
+  /**
+   * The forwarding decision on an Interest.
+   */
+  ndn_strategy_after_receive_interest after_receive_interest;
+
+  /**
+   * [optional] The notification of Data arrival.
+   */
+  ndn_strategy_before_satisfy_interest before_satisfy_interest;
+
+  /**
+   * [optional] The notification of Interest timeout.
+   */
+  ndn_strategy_on_interest_timeout on_interest_timeout;
+} ndn_strategy_t;
+
+/**
+ * Best-route strategy: send an Interest to the usable next hop with the lowest cost.
+ */
+extern const ndn_strategy_t ndn_strategy_best_route;
+
+/**
+ * Multicast strategy: send an Interest to every usable next hop.
+ */
+extern const ndn_strategy_t ndn_strategy_multicast;
+
+/**
+ * Load-balance strategy: send an Interest to a usable next hop picked at random.
+ */
+extern const ndn_strategy_t ndn_strategy_load_balance;
+
+/**
+ * Adaptive SRTT-based strategy, in the spirit of NFD's ASF.
+ * It measures the smoothed RTT and timeouts of each (FIB prefix, face) pair from the
+ * Interest-Data round trips, and sends an Interest to the fastest working next hop.
+ * Every NDN_ASF_PROBE_INTERVAL Interests, one more next hop is probed, so that alternatives
+ * are measured and a recovered face can win again.
+ * Next hops without measurements are ranked by cost after the measured working ones, and
+ * next hops with NDN_ASF_MAX_TIMEOUTS consecutive timeouts are ranked last.
+ * The measurements are kept in a table of NDN_ASF_MEASUREMENTS_SIZE records that replaces
+ * the least recently used one.
+ */
+extern const ndn_strategy_t ndn_strategy_asf;
+
+/**
+ * The measurements of ndn_strategy_asf on a (FIB prefix, face) pair.
+ */
+typedef struct ndn_asf_measurement {
+  uint8_t face_id;          // NDN_INVALID_FACE_ID for an unused record
+  uint32_t prefix_hash;     // name_hash of the FIB entry
+  timetick_t srtt;          // smoothed RTT, 0 before the first sample
+  timetick_t last_used;     // for LRU replacement
+  uint8_t timeouts;         // consecutive timeouts, saturated at NDN_ASF_MAX_TIMEOUTS
+} ndn_asf_measurement_t;
+
+/**
+ * The state kept by the built-in strategies for a forwarder.
+ */
+typedef struct ndn_strategy_measurements {
+  /**
+   * The measurements of ndn_strategy_asf.
+   */
+  ndn_asf_measurement_t asf[NDN_ASF_MEASUREMENTS_SIZE];
+  /**
+   * The Interests sent by ndn_strategy_asf since its last probe.
+   */
+  uint16_t asf_interest_cnt;
+  /**
+   * The state of the random numbers of the strategies, e.g., to pick a next hop of
+   * ndn_strategy_load_balance. Never 0.
+   */
+  uint32_t random_state;
+} ndn_strategy_measurements_t;
+
+/**
+ * Send an Interest through a next hop and record it in the out-record of the face.
+ * Strategies should send Interests with this function.
+ * @param pit_entry. Input/Output. The PIT entry of the Interest.
+ * @param face. Input. The outgoing face.
+ * @param raw_interest. Input. The wire format Interest.
+ * @param size. Input. The size of the wire format Interest.
+ * @param now. Input. The current time.
+ * @return the result of ndn_face_send(). NDN_FWD_PIT_ENTRY_FACE_LIST_FULL if the entry already
+ *         has NDN_PIT_MAX_OUT_RECORDS other upstream faces, in which case nothing is sent.
+ */
+int
+strategy_send_interest(ndn_pit_entry_t* pit_entry, ndn_face_intf_t* face,
+                       const uint8_t* raw_interest, uint32_t size, timetick_t now);
+
+/**
+ * The seed of the random numbers of the strategies, if none is given.
+ */
+#define NDN_STRATEGY_DEFAULT_SEED 2463534242u
+
+/**
+ * Clear the state kept by the built-in strategies, e.g., the measurements of ndn_strategy_asf.
+ * This function is invoked by forwarder_init().
+ * @param measurements. Output. The state to be cleared.
+ * @param seed. Input. The seed of the random numbers of the strategies.
+ *              0 for NDN_STRATEGY_DEFAULT_SEED.
+ */
+void
+strategy_init(ndn_strategy_measurements_t* measurements, uint32_t seed);
+
+/**
+ * Forget the state kept by the built-in strategies about a face.
+ * This function is invoked when the face is removed from the forwarder, before its face ID
+ * can be reused.
+ * @param measurements. Input/Output. The state of the forwarder.
+ * @param face. Input. The face being removed.
+ */
+void
+strategy_remove_face(ndn_strategy_measurements_t* measurements, const ndn_face_intf_t* face);
+
+/**
+ * ndn_strategy_choice_entry is a class of strategy-choice table entries.
+ */
+typedef struct ndn_strategy_choice_entry {
+  /**
+   * The name prefix, kept in the name arena of the table.
+   * NDN_NAME_REF_NULL indicates an empty entry.
+   */
+  ndn_name_ref_t name_prefix;
+
+  /**
+   * The strategy used by the Interests under @p name_prefix.
+   */
+  const ndn_strategy_t* strategy;
+} ndn_strategy_choice_entry_t;
+
+/**
+ * The class of strategy-choice table.
+ * The strategy of an Interest is decided by longest prefix match over the table,
+ * with ndn_strategy_best_route used when no prefix matches.
+ * The table is only consulted when a PIT entry is created.
+ */
+typedef struct ndn_strategy_choice {
+  /**
+   * The strategy-choice entries.
+   */
+  ndn_strategy_choice_entry_t slots[NDN_STRATEGY_CHOICE_MAX_SIZE];
+
+  /**
+   * The name arena keeping the name prefixes.
+   */
+  ndn_name_arena_t names;
+
+  /**
+   * The buffer of @p names.
+   */
+  uint16_t name_buffer[NDN_STRATEGY_CHOICE_NAME_ARENA_SIZE / 2];
+} ndn_strategy_choice_t;
+
+/**
+ * Init an empty strategy-choice table.
+ * @param table. Output. The table to be inited.
+ */
+void
+strategy_choice_init(ndn_strategy_choice_t* table);
+
+/**
+ * Set the strategy of a name prefix.
+ * @param table. Input/Output. The strategy-choice table.
+ * @param name_prefix. Input. The name prefix.
+ * @param strategy. Input. The strategy.
+ * @return 0 if there is no error. NDN_FWD_STRATEGY_CHOICE_FULL if the table or its name arena is full.
+ */
+int
+strategy_choice_set(ndn_strategy_choice_t* table, const ndn_name_t* name_prefix,
+                    const ndn_strategy_t* strategy);
+
+/**
+ * Unset the strategy of a name prefix.
+ * @param table. Input/Output. The strategy-choice table.
+ * @param name_prefix. Input. The name prefix.
+ */
+void
+strategy_choice_unset(ndn_strategy_choice_t* table, const ndn_name_t* name_prefix);
+
+/**
+ * Find the strategy of a name.
+ * @param table. Input. The strategy-choice table.
+ * @param name. Input. The view of the name, e.g. an Interest name.
+ * @return the strategy of the longest matching prefix, or ndn_strategy_best_route.
+ */
+const ndn_strategy_t*
+strategy_choice_find(const ndn_strategy_choice_t* table, const ndn_name_view_t* name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FORWARDER_STRATEGY_H_
@@ -13,6 +13,8 @@
 #define NDN_NAME_COMPONENT_BUFFER_SIZE 36
 #define NDN_NAME_COMPONENT_BLOCK_SIZE 38
 #define NDN_NAME_COMPONENTS_SIZE 10
+// name views and the names kept in name arenas are not limited by NDN_NAME_COMPONENTS_SIZE
+#define NDN_NAME_VIEW_COMPONENTS_SIZE 32
 #define NDN_NAME_MAX_BLOCK_SIZE 384
 #define NDN_FWD_INVALID_NAME_SIZE ((uint32_t)(-1))
 #define NDN_FWD_INVALID_NAME_COMPONENT_SIZE ((uint32_t)(-1))
@@ -25,6 +27,8 @@
 #define NDN_INTEREST_PARAMS_BUFFER_SIZE 248
 #define NDN_SIGNED_INTEREST_BE_SIGNED_MAX_SIZE 680
 #define NDN_DEFAULT_INTEREST_LIFETIME 4000
+// the longest InterestLifetime kept by the forwarder, in milliseconds: one hour
+#define NDN_MAX_INTEREST_LIFETIME 3600000
 
 // data
 #define NDN_CONTENT_BUFFER_SIZE 256
@@ -33,13 +37,49 @@
 #define NDN_SIGNATURE_BUFFER_SIZE 128
 
 // forwarder
+// the default sizes of the FIB, the RIB, the PIT and the CS, see ndn_forwarder_config_t
 #define NDN_FIB_MAX_SIZE 20
+#define NDN_FIB_MAX_NEXTHOPS 3
+#define NDN_RIB_MAX_SIZE 20
+// the longest lifetime of an expiring route, in milliseconds: 30 days
+#define NDN_RIB_MAX_EXPIRATION_PERIOD 2592000000u
+// FIB hash index slots: a power of two and at least twice NDN_FIB_MAX_SIZE
+#define NDN_FIB_INDEX_SIZE 64
 #define NDN_PIT_MAX_SIZE 32
+// PIT hash index slots: a power of two and at least twice NDN_PIT_MAX_SIZE
+#define NDN_PIT_INDEX_SIZE 64
 #define NDN_CS_MAX_SIZE 10
+#define NDN_CS_DATA_BUFFER_SIZE 512
 #define NDN_FACE_TABLE_MAX_SIZE 10
+// face IDs index the face table, and are kept in one byte by the PIT and FIB
+#define NDN_INVALID_FACE_ID 0xFF
 #define NDN_FACE_DEFAULT_COST 1
 #define NDN_AES_BLOCK_SIZE 16
-#define NDN_MAX_FACE_PER_PIT_ENTRY 3
+// PIT: in-records (downstream faces) and out-records (upstream faces) of an entry
+#define NDN_PIT_MAX_IN_RECORDS 3
+#define NDN_PIT_MAX_OUT_RECORDS 3
+#define NDN_STRATEGY_CHOICE_MAX_SIZE 5
+// name arenas of the tables in bytes: a typical compact name takes 40 to 80 bytes
+#define NDN_PIT_NAME_ARENA_SIZE (NDN_PIT_MAX_SIZE * 64)
+#define NDN_FIB_NAME_ARENA_SIZE (NDN_FIB_MAX_SIZE * 48)
+#define NDN_RIB_NAME_ARENA_SIZE (NDN_RIB_MAX_SIZE * 48)
+#define NDN_STRATEGY_CHOICE_NAME_ARENA_SIZE (NDN_STRATEGY_CHOICE_MAX_SIZE * 48)
+// adaptive strategy: measurement records, probing period in Interests, timeouts to mark a face failing
+#define NDN_ASF_MEASUREMENTS_SIZE 16
+#define NDN_ASF_PROBE_INTERVAL 8
+#define NDN_ASF_MAX_TIMEOUTS 3
+// forwarder: received packets processed in one ndn_forwarder_process() call
+#define NDN_FORWARDER_RX_BATCH_SIZE 8
+// dead nonce list: records kept in a generation before the older one is dropped
+#define NDN_DNL_GENERATION_SIZE 32
+// dead nonce list: false positives of a lookup, about 2^-NDN_DNL_FALSE_POSITIVE_BITS,
+// from which the size of the Bloom filters is derived
+#define NDN_DNL_FALSE_POSITIVE_BITS 14
+
+// logger: words of the binary log ring, a power of two
+#define NDN_LOG_RING_SIZE 256
+// logger: arguments of a log record
+#define NDN_LOG_MAX_ARGS 4
 
 // fragmentation support
 #define NDN_FRAG_HDR_LEN 3 // Size of the NDN L2 fragmentation header
@@ -20,6 +20,7 @@
 #define NDN_WRONG_TLV_LENGTH -13
 #define NDN_OVERSIZE_VAR -14
 #define NDN_TLV_OP_FAILED -15
+#define NDN_NO_MEM -16
 
 // Security Error
 #define NDN_SEC_WRONG_KEY_SIZE -22
@@ -46,9 +47,18 @@
 #define NDN_FWD_FIB_FULL -53
 #define NDN_FWD_INTEREST_REJECTED -54
 #define NDN_FWD_NO_MATCHED_CALLBACK -55
+#define NDN_FWD_DUPLICATE_NONCE -56
+#define NDN_FWD_FIB_NEXTHOP_LIST_FULL -57
+#define NDN_FWD_STRATEGY_CHOICE_FULL -58
+#define NDN_FWD_FACE_TABLE_FULL -59
+#define NDN_FWD_HOP_LIMIT_EXCEEDED -64
+#define NDN_FWD_RIB_FULL -65
+#define NDN_FWD_SCHEDULER_FULL -67
 
 // Face Error
 #define NDN_FWD_APP_FACE_CB_TABLE_FULL -60
+#define NDN_FWD_UNKNOWN_FACE -63
+#define NDN_FWD_FACE_IN_OTHER_FORWARDER -66
 
 // Service Discovery
 #define NDN_SD_NO_MATCH_SERVCE -61
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+// clock_gettime() is not declared by a strict C compiler without it
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "clock.h"
+#include <stddef.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <time.h>
+
+static timetick_t
+ndn_clock_posix_now(void)
+{
+  struct timespec ts;
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+    return 0;
+  }
+  return (timetick_t)ts.tv_sec * 1000 + (timetick_t)ts.tv_nsec / 1000000;
+}
+
+static ndn_clock_backend_t ndn_clock_backend = {ndn_clock_posix_now};
+#else
+static ndn_clock_backend_t ndn_clock_backend = {NULL};
+#endif
+
+ndn_clock_backend_t*
+ndn_clock_get_backend(void)
+{
+  return &ndn_clock_backend;
+}
+
+timetick_t
+ndn_clock_now(void)
+{
+  if (ndn_clock_backend.now == NULL) {
+    return 0;
+  }
+  return ndn_clock_backend.now();
+}
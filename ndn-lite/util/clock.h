@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef UTIL_CLOCK_H_
+#define UTIL_CLOCK_H_
+
+#include <inttypes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A time point or a duration in milliseconds.
+ * The time points of the library are read from a monotonic clock, so they never go back,
+ * but only differences between them have a meaning.
+ */
+typedef uint64_t timetick_t;
+
+/**
+ * The type of the function reading a monotonic clock.
+ * It should return the milliseconds since an arbitrary time point, e.g., the boot,
+ * which never decrease while the program runs.
+ */
+typedef timetick_t (*ndn_clock_now_impl)(void);
+
+/**
+ * The structure to represent the backend implementation.
+ * On Linux and other POSIX systems it defaults to clock_gettime(CLOCK_MONOTONIC).
+ * On other platforms it is empty until the application loads one, e.g.,
+ * ndn_nrf_clock_load_backend() of adaptation/ndn-nrf-clock.h.
+ */
+typedef struct ndn_clock_backend {
+  ndn_clock_now_impl now;
+} ndn_clock_backend_t;
+
+ndn_clock_backend_t*
+ndn_clock_get_backend(void);
+
+/**
+ * Read the monotonic clock of the platform, e.g., to pass the current time to
+ * ndn_forwarder_process().
+ * @return the milliseconds since an arbitrary time point. 0 if no backend is loaded.
+ */
+timetick_t
+ndn_clock_now(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UTIL_CLOCK_H_
@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * A benchmark of the longest prefix match of the FIB over the number of routes. It is a
+ * standalone program, not a part of the library. Build it on Linux, e.g.,
+ *   cc -std=gnu11 -O2 -I<path to ndn-lite> -o fib-bench util/host/fib-bench.c \
+ *      forwarder/fib.c forwarder/name-arena.c encode/name.c encode/name-component.c
+ *
+ * The routes are /<key>, /<key>/a and /<key>/a/b, one third each, and the Interests are
+ * /<key>/a/b/<sequence>, so that a lookup tries up to three prefix lengths.
+ * For each number of routes, it reports the nanoseconds per operation of:
+ *   insert: inserting a route, until all of them are in the FIB
+ *   hit:    the longest prefix match of an Interest under a route
+ *   miss:   the longest prefix match of an Interest under no route
+ *   scan:   the longest prefix match by comparing the Interest with every route, as the
+ *           FIB did before it was indexed by prefix hash, for reference
+ * The number of routes is limited by the name arena of 65534 bytes.
+ */
+
+// clock_gettime() is not declared by a strict C compiler without it
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "forwarder/fib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_INTEREST_SIZE 20
+#define BENCH_MAX_ROUTES 2048
+
+typedef struct bench_interest {
+  uint8_t wire[BENCH_INTEREST_SIZE];
+  ndn_name_view_t view;
+} bench_interest_t;
+
+static uint64_t
+bench_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t
+bench_random(void)
+{
+  static uint32_t state = 2463534242u;
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+// Make the name /<key>/a/b/<sequence>, or its prefix of @p components_size components.
+// The key and the sequence are 4-byte GenericNameComponents.
+static void
+bench_make_name(uint8_t* wire, ndn_name_view_t* view, uint32_t key, uint32_t sequence,
+                uint8_t components_size)
+{
+  const uint8_t components[BENCH_INTEREST_SIZE - 2] = {
+    TLV_GenericNameComponent, 4, (uint8_t)(key >> 24), (uint8_t)(key >> 16),
+    (uint8_t)(key >> 8), (uint8_t)key,
+    TLV_GenericNameComponent, 1, 'a',
+    TLV_GenericNameComponent, 1, 'b',
+    TLV_GenericNameComponent, 4, (uint8_t)(sequence >> 24), (uint8_t)(sequence >> 16),
+    (uint8_t)(sequence >> 8), (uint8_t)sequence};
+  const uint8_t sizes[] = {0, 6, 9, 12, 18};
+  ndn_decoder_t decoder;
+  wire[0] = TLV_Name;
+  wire[1] = sizes[components_size];
+  memcpy(wire + 2, components, sizes[components_size]);
+  decoder_init(&decoder, wire, 2 + sizes[components_size]);
+  ndn_name_view_tlv_decode(&decoder, view);
+}
+
+// The longest prefix match by comparing the name with every route
+static ndn_fib_entry_t*
+bench_scan(ndn_fib_t* fib, const ndn_name_view_t* name)
+{
+  ndn_fib_entry_t* longest = NULL;
+  uint8_t longest_size = 0;
+  for (uint16_t i = 0; i < fib->capacity; i++) {
+    ndn_fib_entry_t* entry = &fib->slots[i];
+    if (entry->name_prefix == NDN_NAME_REF_NULL) {
+      continue;
+    }
+    uint8_t size = name_arena_components_size(&fib->names, entry->name_prefix);
+    if ((longest == NULL || size > longest_size)
+        && name_arena_is_prefix_of_view(&fib->names, entry->name_prefix, name) == 0) {
+      longest = entry;
+      longest_size = size;
+    }
+  }
+  return longest;
+}
+
+static void
+bench_run(uint16_t route_cnt)
+{
+  uint16_t index_size = 2;
+  while (index_size < 2 * route_cnt) {
+    index_size *= 2;
+  }
+  uint32_t arena_size = (uint32_t)route_cnt * 24;
+  if (arena_size > 65534) {
+    arena_size = 65534;
+  }
+  uint8_t* region = aligned_alloc(NDN_POOL_ALIGN,
+                                  NDN_POOL_ALIGN_UP(NDN_FIB_REGION_SIZE(route_cnt, index_size, arena_size)));
+  // the Interests [0, route_cnt) are under the routes, and the others are not
+  bench_interest_t* interests = malloc(sizeof(bench_interest_t) * 2 * route_cnt);
+  if (region == NULL || interests == NULL) {
+    fprintf(stderr, "out of memory\n");
+    exit(1);
+  }
+  ndn_fib_t fib;
+  fib_table_init(&fib, region, route_cnt, index_size, (uint16_t)arena_size);
+
+  ndn_name_t* routes = malloc(sizeof(ndn_name_t) * route_cnt);
+  if (routes == NULL) {
+    fprintf(stderr, "out of memory\n");
+    exit(1);
+  }
+  for (uint32_t i = 0; i < 2 * (uint32_t)route_cnt; i++) {
+    // distinct keys spread over the 4 bytes
+    uint32_t key = (i + 1) * 2654435761u;
+    bench_make_name(interests[i].wire, &interests[i].view, key, bench_random(), 4);
+    if (i < route_cnt) {
+      ndn_name_view_t prefix;
+      ndn_name_view_get_prefix(&interests[i].view, 1 + i % 3, &prefix);
+      ndn_name_from_view(&routes[i], &prefix);
+    }
+  }
+
+  uint64_t start = bench_ns();
+  for (uint32_t i = 0; i < route_cnt; i++) {
+    if (fib_table_insert(&fib, &routes[i]) == NULL) {
+      fprintf(stderr, "the FIB is full after %u routes\n", i);
+      exit(1);
+    }
+  }
+  double insert = (double)(bench_ns() - start) / route_cnt;
+
+  uint32_t lookup_cnt = 1000000;
+  uint32_t found = 0;
+  start = bench_ns();
+  for (uint32_t j = 0; j < lookup_cnt; j++) {
+    found += fib_table_lpm(&fib, &interests[bench_random() % route_cnt].view) != NULL;
+  }
+  double hit = (double)(bench_ns() - start) / lookup_cnt;
+
+  start = bench_ns();
+  for (uint32_t j = 0; j < lookup_cnt; j++) {
+    found += fib_table_lpm(&fib, &interests[route_cnt + bench_random() % route_cnt].view) != NULL;
+  }
+  double miss = (double)(bench_ns() - start) / lookup_cnt;
+
+  uint32_t scan_cnt = lookup_cnt / route_cnt;
+  start = bench_ns();
+  for (uint32_t j = 0; j < scan_cnt; j++) {
+    found += bench_scan(&fib, &interests[bench_random() % route_cnt].view) != NULL;
+  }
+  double scan = (double)(bench_ns() - start) / scan_cnt;
+  if (found != lookup_cnt + scan_cnt) {
+    fprintf(stderr, "%u routes found, %u expected\n", found, lookup_cnt + scan_cnt);
+    exit(1);
+  }
+
+  printf("%u,%.1f,%.1f,%.1f,%.1f\n", route_cnt, insert, hit, miss, scan);
+  free(routes);
+  free(interests);
+  free(region);
+}
+
+int
+main(int argc, char* argv[])
+{
+  printf("routes,insert_ns,hit_ns,miss_ns,scan_ns\n");
+  if (argc > 1) {
+    for (int i = 1; i < argc; i++) {
+      unsigned long route_cnt = strtoul(argv[i], NULL, 10);
+      if (route_cnt == 0 || route_cnt > BENCH_MAX_ROUTES) {
+        fprintf(stderr, "the number of routes must be 1 to %u\n", BENCH_MAX_ROUTES);
+        return 1;
+      }
+      bench_run((uint16_t)route_cnt);
+    }
+    return 0;
+  }
+  const uint16_t defaults[] = {16, 128, 1024, 2048};
+  for (size_t i = 0; i < sizeof(defaults) / sizeof(defaults[0]); i++) {
+    bench_run(defaults[i]);
+  }
+  return 0;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * The host-side decoder of the binary log records drained by ndn_log_drain().
+ * It is a standalone program, not a part of the library:
+ *   cc -I<path to ndn-lite> -o log-decoder log-decoder.c
+ *   log-decoder < captured-log.bin
+ * The decoder must be built from the same log-messages.h as the firmware.
+ * A byte that does not start a valid record is skipped, so the decoder resynchronizes
+ * when the capture starts in the middle of a record.
+ */
+
+#include "util/logger.h"
+#include <stdio.h>
+
+#define NDN_LOG_MESSAGE(name, nargs, format) format,
+static const char* log_formats[] = {
+#include "util/log-messages.h"
+};
+#undef NDN_LOG_MESSAGE
+
+#define NDN_LOG_MESSAGE(name, nargs, format) nargs,
+static const uint8_t log_nargs[] = {
+#include "util/log-messages.h"
+};
+#undef NDN_LOG_MESSAGE
+
+static const char* log_levels[] = {"NONE", "ERROR", "WARN", "INFO", "DEBUG"};
+
+static uint32_t
+log_get_word(const uint8_t* buffer)
+{
+  return (uint32_t)buffer[0] | (uint32_t)buffer[1] << 8
+         | (uint32_t)buffer[2] << 16 | (uint32_t)buffer[3] << 24;
+}
+
+// Check the header of a record against the message table
+static int
+log_header_is_valid(uint32_t header)
+{
+  uint32_t id = NDN_LOG_RECORD_ID(header);
+  uint32_t level = NDN_LOG_RECORD_LEVEL(header);
+  return (header & NDN_LOG_RECORD_VALID)
+         && level > NDN_LOG_LEVEL_NONE && level <= NDN_LOG_LEVEL_DEBUG
+         && id < NDN_LOG_MESSAGE_COUNT
+         && NDN_LOG_RECORD_NARGS(header) == log_nargs[id];
+}
+
+int
+main(void)
+{
+  uint8_t buffer[4 * (1 + NDN_LOG_MAX_ARGS)];
+  uint32_t size = 0;
+  int c;
+  while ((c = getchar()) != EOF) {
+    buffer[size++] = (uint8_t)c;
+    if (size < 4) {
+      continue;
+    }
+    uint32_t header = log_get_word(buffer);
+    if (!log_header_is_valid(header)) {
+      // Skip one byte to find the next record
+      for (uint32_t i = 1; i < size; i++) {
+        buffer[i - 1] = buffer[i];
+      }
+      size--;
+      continue;
+    }
+    uint32_t nargs = NDN_LOG_RECORD_NARGS(header);
+    if (size < 4 * (1 + nargs)) {
+      continue;
+    }
+    uint32_t args[NDN_LOG_MAX_ARGS] = {0};
+    for (uint32_t i = 0; i < nargs; i++) {
+      args[i] = log_get_word(buffer + 4 * (i + 1));
+    }
+    printf("[%s] ", log_levels[NDN_LOG_RECORD_LEVEL(header)]);
+    printf(log_formats[NDN_LOG_RECORD_ID(header)], args[0], args[1], args[2], args[3]);
+    printf("\n");
+    size = 0;
+  }
+  return 0;
+}
@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * A benchmark of the PIT at different sizes. It is a standalone program, not a part of
+ * the library. Build it on Linux, e.g.,
+ *   cc -std=gnu11 -O2 -I<path to ndn-lite> -o pit-bench util/host/pit-bench.c \
+ *      forwarder/pit.c forwarder/name-arena.c encode/name.c encode/name-component.c
+ *
+ * For each number of entries, it reports the nanoseconds per operation of:
+ *   insert: inserting an entry and setting its expiry, until the PIT is full
+ *   hit:    finding a pending Interest name
+ *   miss:   finding a name which is not pending
+ *   scan:   finding a pending Interest name by comparing it with every entry, as the PIT
+ *           did before it was indexed by name hash, for reference
+ *   churn:  deleting an entry and inserting another one, as a full PIT does when Data
+ *           comes back and a new Interest arrives
+ *   evict:  deleting the entry which expires first, until the PIT is empty
+ * The names have one 4-byte component, so that 4096 of them fit in a name arena of
+ * 65534 bytes.
+ */
+
+// clock_gettime() is not declared by a strict C compiler without it
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "forwarder/pit.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_MAX_LIFETIME 4000
+#define BENCH_NAME_SIZE 8
+
+typedef struct bench_name {
+  uint8_t wire[BENCH_NAME_SIZE];
+  ndn_name_view_t view;
+  uint32_t hash;
+} bench_name_t;
+
+static uint64_t
+bench_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t
+bench_random(void)
+{
+  static uint32_t state = 2463534242u;
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+// Make the name /<key>, with the key as a 4-byte GenericNameComponent
+static void
+bench_make_name(bench_name_t* name, uint32_t key)
+{
+  ndn_decoder_t decoder;
+  uint8_t wire[BENCH_NAME_SIZE] = {TLV_Name, 6, TLV_GenericNameComponent, 4,
+                                   (uint8_t)(key >> 24), (uint8_t)(key >> 16),
+                                   (uint8_t)(key >> 8), (uint8_t)key};
+  memcpy(name->wire, wire, BENCH_NAME_SIZE);
+  decoder_init(&decoder, name->wire, BENCH_NAME_SIZE);
+  ndn_name_view_tlv_decode(&decoder, &name->view);
+  name->hash = ndn_name_view_hash(&name->view);
+}
+
+// Find an entry by comparing the name with every entry
+static ndn_pit_entry_t*
+bench_scan(ndn_pit_t* pit, const ndn_name_view_t* name)
+{
+  for (uint16_t i = 0; i < pit->capacity; i++) {
+    ndn_pit_entry_t* entry = &pit->slots[i];
+    if (entry->interest_name != NDN_NAME_REF_NULL
+        && name_arena_compare_view(&pit->names, entry->interest_name, name) == 0) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+static void
+bench_run(uint16_t entry_cnt)
+{
+  uint16_t index_size = 2;
+  while (index_size < 2 * entry_cnt) {
+    index_size *= 2;
+  }
+  uint32_t arena_size = (uint32_t)entry_cnt * 16;
+  if (arena_size > 65534) {
+    arena_size = 65534;
+  }
+  uint8_t* region = aligned_alloc(NDN_POOL_ALIGN,
+                                  NDN_POOL_ALIGN_UP(NDN_PIT_REGION_SIZE(entry_cnt, index_size, arena_size)));
+  // names [0, entry_cnt) are pending at first, and the others are not
+  uint32_t name_cnt = 2 * (uint32_t)entry_cnt;
+  bench_name_t* names = malloc(sizeof(bench_name_t) * name_cnt);
+  ndn_pit_entry_t** entries = malloc(sizeof(ndn_pit_entry_t*) * name_cnt);
+  uint32_t* pending = malloc(sizeof(uint32_t) * name_cnt);
+  if (region == NULL || names == NULL || entries == NULL || pending == NULL) {
+    fprintf(stderr, "out of memory\n");
+    exit(1);
+  }
+  for (uint32_t i = 0; i < name_cnt; i++) {
+    // distinct keys spread over the 4 bytes
+    bench_make_name(&names[i], (i + 1) * 2654435761u);
+    pending[i] = i;
+  }
+  ndn_pit_t pit;
+  pit_table_init(&pit, region, entry_cnt, index_size, (uint16_t)arena_size);
+  timetick_t now = 1000;
+
+  uint64_t start = bench_ns();
+  for (uint32_t i = 0; i < entry_cnt; i++) {
+    entries[i] = pit_table_find_or_insert(&pit, &names[i].view, names[i].hash);
+    if (entries[i] == NULL) {
+      fprintf(stderr, "the PIT is full after %u entries\n", i);
+      exit(1);
+    }
+    pit_entry_set_expire_time(&pit, entries[i], now + bench_random() % BENCH_MAX_LIFETIME);
+  }
+  double insert = (double)(bench_ns() - start) / entry_cnt;
+
+  uint32_t lookup_cnt = 1000000;
+  uint32_t found = 0;
+  start = bench_ns();
+  for (uint32_t j = 0; j < lookup_cnt; j++) {
+    const bench_name_t* name = &names[bench_random() % entry_cnt];
+    found += pit_table_find(&pit, &name->view, name->hash) != NULL;
+  }
+  double hit = (double)(bench_ns() - start) / lookup_cnt;
+
+  start = bench_ns();
+  for (uint32_t j = 0; j < lookup_cnt; j++) {
+    const bench_name_t* name = &names[entry_cnt + bench_random() % entry_cnt];
+    found += pit_table_find(&pit, &name->view, name->hash) != NULL;
+  }
+  double miss = (double)(bench_ns() - start) / lookup_cnt;
+
+  uint32_t scan_cnt = lookup_cnt / entry_cnt;
+  start = bench_ns();
+  for (uint32_t j = 0; j < scan_cnt; j++) {
+    found += bench_scan(&pit, &names[bench_random() % entry_cnt].view) != NULL;
+  }
+  double scan = (double)(bench_ns() - start) / scan_cnt;
+  if (found != lookup_cnt + scan_cnt) {
+    fprintf(stderr, "%u names found, %u expected\n", found, lookup_cnt + scan_cnt);
+    exit(1);
+  }
+
+  // pending[0, entry_cnt) are the names in the PIT, kept in entries[]
+  uint32_t churn_cnt = 100000;
+  start = bench_ns();
+  for (uint32_t j = 0; j < churn_cnt; j++) {
+    uint32_t out = bench_random() % entry_cnt;
+    uint32_t in = entry_cnt + bench_random() % entry_cnt;
+    pit_entry_delete(&pit, entries[out]);
+    const bench_name_t* name = &names[pending[in]];
+    entries[out] = pit_table_find_or_insert(&pit, &name->view, name->hash);
+    if (entries[out] == NULL) {
+      fprintf(stderr, "the PIT is full after %u replacements\n", j);
+      exit(1);
+    }
+    pit_entry_set_expire_time(&pit, entries[out], now + bench_random() % BENCH_MAX_LIFETIME);
+    uint32_t swap = pending[out];
+    pending[out] = pending[in];
+    pending[in] = swap;
+    now++;
+  }
+  double churn = (double)(bench_ns() - start) / churn_cnt;
+
+  start = bench_ns();
+  ndn_pit_entry_t* entry;
+  while ((entry = pit_table_first_to_expire(&pit)) != NULL) {
+    pit_entry_delete(&pit, entry);
+  }
+  double evict = (double)(bench_ns() - start) / entry_cnt;
+
+  printf("%u,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n", entry_cnt, insert, hit, miss, scan, churn, evict);
+  free(pending);
+  free(entries);
+  free(names);
+  free(region);
+}
+
+int
+main(int argc, char* argv[])
+{
+  printf("entries,insert_ns,hit_ns,miss_ns,scan_ns,churn_ns,evict_ns\n");
+  if (argc > 1) {
+    for (int i = 1; i < argc; i++) {
+      unsigned long entry_cnt = strtoul(argv[i], NULL, 10);
+      if (entry_cnt == 0 || entry_cnt > 4096) {
+        fprintf(stderr, "the number of entries must be 1 to 4096\n");
+        return 1;
+      }
+      bench_run((uint16_t)entry_cnt);
+    }
+    return 0;
+  }
+  const uint16_t defaults[] = {32, 256, 4096};
+  for (size_t i = 0; i < sizeof(defaults) / sizeof(defaults[0]); i++) {
+    bench_run(defaults[i]);
+  }
+  return 0;
+}
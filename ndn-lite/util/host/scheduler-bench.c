@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * A benchmark of the scheduler with many pending timers, e.g., the PIT expiry timers of
+ * a gateway. It is a standalone program, not a part of the library. Build it on Linux
+ * twice, with the binary heap and with the timing wheel, and compare their output, e.g.,
+ *   cc -std=gnu11 -O2 -I<path to ndn-lite> -DNDN_SCHEDULER_WIDE_SLOTS -o bench-heap \
+ *      util/host/scheduler-bench.c forwarder/scheduler.c forwarder/scheduler-wheel.c util/clock.c
+ *   cc ... -DNDN_SCHEDULER_TIMING_WHEEL -o bench-wheel ...
+ *
+ * For each number of timers, it reports the nanoseconds per operation of:
+ *   arm:    posting the timers with delays of up to 4 seconds
+ *   rearm:  cancelling a timer and posting it again, as the PIT does when an entry is
+ *           extended, while all the timers are pending
+ *   cancel: cancelling half of the timers
+ *   expire: running the rest of them, processing every millisecond
+ * The scheduler of each run holds as many events as there are timers, up to
+ * NDN_SCHEDULER_MAX_SIZE. The run of 100000 timers needs wide slots, which the timing
+ * wheel always has, and is skipped by a heap built without NDN_SCHEDULER_WIDE_SLOTS.
+ */
+
+// clock_gettime() is not declared by a strict C compiler without it
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "forwarder/scheduler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_MAX_DELAY 4000
+
+static uint32_t expired;
+
+static uint64_t
+bench_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t
+bench_random(void)
+{
+  static uint32_t state = 2463534242u;
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+static void
+bench_on_timer(void* self, uint32_t iparam, void* pparam)
+{
+  (void)self;
+  (void)iparam;
+  (void)pparam;
+  expired++;
+}
+
+static void
+bench_run(uint32_t timer_cnt)
+{
+  timetick_t now = 1000;
+  uint8_t* region = aligned_alloc(NDN_POOL_ALIGN,
+                                  NDN_POOL_ALIGN_UP(NDN_SCHEDULER_REGION_SIZE(timer_cnt)));
+  ndn_event_handle_t* handles = malloc(sizeof(ndn_event_handle_t) * timer_cnt);
+  if (region == NULL || handles == NULL) {
+    fprintf(stderr, "out of memory\n");
+    exit(1);
+  }
+  ndn_scheduler_t scheduler;
+  ndn_scheduler_init(&scheduler, region, (ndn_event_slot_t)timer_cnt);
+  ndn_scheduler_process(&scheduler, now);
+  expired = 0;
+
+  uint64_t start = bench_ns();
+  for (uint32_t i = 0; i < timer_cnt; i++) {
+    handles[i] = ndn_scheduler_post_after(&scheduler, 1 + bench_random() % BENCH_MAX_DELAY,
+                                          NULL, bench_on_timer, i, NULL);
+  }
+  double arm = (double)(bench_ns() - start) / timer_cnt;
+
+  uint32_t rearm_cnt = timer_cnt < 100000 ? 100000 : timer_cnt;
+  start = bench_ns();
+  for (uint32_t j = 0; j < rearm_cnt; j++) {
+    uint32_t i = bench_random() % timer_cnt;
+    ndn_scheduler_cancel(&scheduler, handles[i]);
+    handles[i] = ndn_scheduler_post_after(&scheduler, 1 + bench_random() % BENCH_MAX_DELAY,
+                                          NULL, bench_on_timer, i, NULL);
+  }
+  double rearm = (double)(bench_ns() - start) / rearm_cnt;
+
+  start = bench_ns();
+  for (uint32_t i = 0; i < timer_cnt; i += 2) {
+    ndn_scheduler_cancel(&scheduler, handles[i]);
+  }
+  double cancel = (double)(bench_ns() - start) / ((timer_cnt + 1) / 2);
+
+  uint32_t remaining = scheduler.event_cnt;
+  start = bench_ns();
+  while (scheduler.event_cnt > 0) {
+    ndn_scheduler_process(&scheduler, ++now);
+  }
+  double expire = (double)(bench_ns() - start) / (remaining > 0 ? remaining : 1);
+
+  printf("%s,%u,%.1f,%.1f,%.1f,%.1f\n",
+#ifdef NDN_SCHEDULER_TIMING_WHEEL
+         "wheel",
+#else
+         "heap",
+#endif
+         timer_cnt, arm, rearm, cancel, expire);
+  if (expired != remaining) {
+    fprintf(stderr, "%u timers expired, %u expected\n", expired, remaining);
+    exit(1);
+  }
+  free(handles);
+  free(region);
+}
+
+int
+main(int argc, char* argv[])
+{
+  printf("scheduler,timers,arm_ns,rearm_ns,cancel_ns,expire_ns\n");
+  if (argc > 1) {
+    for (int i = 1; i < argc; i++) {
+      uint32_t timer_cnt = (uint32_t)strtoul(argv[i], NULL, 10);
+      if (timer_cnt == 0 || timer_cnt > NDN_SCHEDULER_MAX_SIZE) {
+        fprintf(stderr, "the number of timers must be 1 to %u\n", (unsigned)NDN_SCHEDULER_MAX_SIZE);
+        return 1;
+      }
+      bench_run(timer_cnt);
+    }
+    return 0;
+  }
+  const uint32_t defaults[] = {100, 10000, 100000};
+  for (size_t i = 0; i < sizeof(defaults) / sizeof(defaults[0]); i++) {
+    if (defaults[i] > NDN_SCHEDULER_MAX_SIZE) {
+      fprintf(stderr, "%u timers skipped, build with NDN_SCHEDULER_WIDE_SLOTS\n", defaults[i]);
+      continue;
+    }
+    bench_run(defaults[i]);
+  }
+  return 0;
+}
@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * A consumer-producer scenario on the host-side network simulator.
+ * It is a standalone program, not a part of the library. Build it on Linux with
+ * util/host/simulator.c and the sources of the library: encode, forwarder, util,
+ * face/direct-face.c and the default security backend, e.g.,
+ *   cc -std=gnu11 -O2 -I<path to ndn-lite> -DNDN_LITE_SEC_BACKEND_DEFAULT -o simulator <sources>
+ *   simulator -n 1000 -s 7 > stats.csv
+ *
+ * Node 0 produces the Data under /sim, and every other node expresses Interests for
+ * /sim/<node>/<sequence> at a fixed interval with a random jitter.
+ * In the grid topology (the default), the nodes are connected to their neighbors by
+ * point-to-point links, and route /sim toward node 0 along the row, then the column.
+ * With -c, all the nodes share one broadcast channel with collisions instead, e.g., to
+ * study storms of synchronized requests with -j 0.
+ * With -a, the Interests of the consumers are aggregated and Nacked instead: nodes 2 and
+ * up are connected to node 1, which routes /sim to node 0, which has no route. All the
+ * consumers express /sim/<sequence> at the same time, so that node 1 aggregates them into
+ * one PIT entry, and each of them must receive the NoRoute Nack of node 0. The program
+ * fails if one of them does not.
+ * The statistics of each node are printed to stdout as CSV, and a summary to stderr.
+ */
+
+#include "simulator.h"
+#include "security/ndn-lite-sec-config.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct sim_scenario {
+  uint64_t interval;       // between the Interests of a consumer, in microseconds
+  double jitter;           // fraction of the interval drawn at random
+  uint64_t lifetime;       // InterestLifetime in milliseconds
+  uint32_t sequence;
+  bool aggregate;          // all the consumers express the same names
+} sim_scenario_t;
+
+static sim_scenario_t scenario;
+
+static uint64_t
+sim_next_interval(ndn_sim_t* sim)
+{
+  uint64_t jitter = (uint64_t)(scenario.interval * scenario.jitter);
+  if (jitter == 0) {
+    return scenario.interval;
+  }
+  return scenario.interval - jitter / 2 + ndn_sim_random(sim) % (jitter + 1);
+}
+
+static void
+sim_on_consumer_timer(ndn_sim_node_t* node, void* arg)
+{
+  (void)arg;
+  char uri[64];
+  ndn_name_t name;
+  int len = scenario.aggregate
+            ? snprintf(uri, sizeof(uri), "/sim/%u", node->stats.n_expressed)
+            : snprintf(uri, sizeof(uri), "/sim/%u/%u", node->id, scenario.sequence++);
+  if (ndn_name_from_string(&name, uri, len) == 0) {
+    ndn_sim_consumer_express(node, &name, scenario.lifetime);
+  }
+  ndn_sim_post(node->sim, sim_next_interval(node->sim), node, sim_on_consumer_timer, NULL);
+}
+
+static int
+sim_build_grid(ndn_sim_t* sim, uint32_t node_size, const ndn_sim_link_params_t* params,
+               const ndn_name_t* prefix)
+{
+  uint32_t width = 1;
+  while (width * width < node_size) {
+    width++;
+  }
+  for (uint32_t i = 0; i < node_size; i++) {
+    if (i == 0) {
+      continue;
+    }
+    // the neighbor one hop closer to node 0
+    uint32_t upstream = (i % width) > 0 ? i - 1 : i - width;
+    ndn_sim_link_t* link = ndn_sim_add_link(sim, params);
+    if (link == NULL) {
+      return NDN_FWD_NO_MEM;
+    }
+    ndn_sim_link_face_t* up = ndn_sim_attach(link, sim->nodes[i]);
+    ndn_sim_link_face_t* down = ndn_sim_attach(link, sim->nodes[upstream]);
+    if (up == NULL || down == NULL) {
+      return NDN_FWD_FACE_TABLE_FULL;
+    }
+    int ret = forwarder_fib_insert(&sim->nodes[i]->forwarder, prefix, &up->intf, 1);
+    if (ret != 0) {
+      return ret;
+    }
+  }
+  return 0;
+}
+
+static int
+sim_build_channel(ndn_sim_t* sim, uint32_t node_size, const ndn_sim_link_params_t* params,
+                  const ndn_name_t* prefix)
+{
+  ndn_sim_link_t* link = ndn_sim_add_link(sim, params);
+  if (link == NULL) {
+    return NDN_FWD_NO_MEM;
+  }
+  for (uint32_t i = 0; i < node_size; i++) {
+    ndn_sim_link_face_t* face = ndn_sim_attach(link, sim->nodes[i]);
+    if (face == NULL) {
+      return NDN_FWD_FACE_TABLE_FULL;
+    }
+    if (i != 0) {
+      int ret = forwarder_fib_insert(&sim->nodes[i]->forwarder, prefix, &face->intf, 1);
+      if (ret != 0) {
+        return ret;
+      }
+    }
+  }
+  return 0;
+}
+
+static int
+sim_build_aggregation(ndn_sim_t* sim, uint32_t node_size, const ndn_sim_link_params_t* params,
+                      const ndn_name_t* prefix)
+{
+  for (uint32_t i = 0; i < node_size; i++) {
+    if (i == 1) {
+      continue;
+    }
+    // node 0 is the upstream of node 1, and the others are its downstreams
+    ndn_sim_link_t* link = ndn_sim_add_link(sim, params);
+    if (link == NULL) {
+      return NDN_FWD_NO_MEM;
+    }
+    ndn_sim_link_face_t* up = ndn_sim_attach(link, sim->nodes[i == 0 ? 1 : i]);
+    ndn_sim_link_face_t* down = ndn_sim_attach(link, sim->nodes[i == 0 ? 0 : 1]);
+    if (up == NULL || down == NULL) {
+      return NDN_FWD_FACE_TABLE_FULL;
+    }
+    int ret = forwarder_fib_insert(&sim->nodes[i == 0 ? 1 : i]->forwarder, prefix, &up->intf, 1);
+    if (ret != 0) {
+      return ret;
+    }
+  }
+  return 0;
+}
+
+// Check that every consumer got a Nack for each Interest, but the last one may be in flight
+static int
+sim_check_aggregation(const ndn_sim_t* sim)
+{
+  int ret = 0;
+  for (uint32_t i = 2; i < sim->node_size; i++) {
+    const ndn_sim_stats_t* stats = &sim->nodes[i]->stats;
+    if (stats->n_nacks == 0 || stats->n_timeouts > 0 || stats->n_expressed - stats->n_nacks > 1) {
+      fprintf(stderr, "node %u: %u expressed, %u nacks, %u timeouts\n",
+              i, stats->n_expressed, stats->n_nacks, stats->n_timeouts);
+      ret = 1;
+    }
+  }
+  return ret;
+}
+
+static void
+sim_usage(const char* program)
+{
+  fprintf(stderr,
+          "usage: %s [-n nodes] [-s seed] [-t duration_ms] [-i interval_ms] [-j jitter]\n"
+          "          [-d latency_us] [-l loss] [-m mtu] [-b bitrate] [-z content_size] [-c | -a]\n",
+          program);
+}
+
+int
+main(int argc, char* argv[])
+{
+  uint32_t node_size = 100;
+  uint64_t seed = 1;
+  uint64_t duration = 10000;
+  bool channel = false;
+  uint32_t content_size = 64;
+  ndn_sim_link_params_t params = {
+    .latency = 1000,
+    .loss = 0,
+    .mtu = 1500,
+    .bitrate = 0,
+    .collisions = false,
+  };
+  scenario.interval = 100000;
+  scenario.jitter = 0.5;
+  scenario.lifetime = NDN_DEFAULT_INTEREST_LIFETIME;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "n:s:t:i:j:d:l:m:b:z:ca")) != -1) {
+    switch (opt) {
+      case 'n': node_size = (uint32_t)strtoul(optarg, NULL, 10); break;
+      case 's': seed = strtoull(optarg, NULL, 10); break;
+      case 't': duration = strtoull(optarg, NULL, 10); break;
+      case 'i': scenario.interval = strtoull(optarg, NULL, 10) * 1000; break;
+      case 'j': scenario.jitter = strtod(optarg, NULL); break;
+      case 'd': params.latency = strtoull(optarg, NULL, 10); break;
+      case 'l': params.loss = strtod(optarg, NULL); break;
+      case 'm': params.mtu = (uint32_t)strtoul(optarg, NULL, 10); break;
+      case 'b': params.bitrate = (uint32_t)strtoul(optarg, NULL, 10); break;
+      case 'z': content_size = (uint32_t)strtoul(optarg, NULL, 10); break;
+      case 'c': channel = true; params.collisions = true; break;
+      case 'a': scenario.aggregate = true; break;
+      default: sim_usage(argv[0]); return 1;
+    }
+  }
+  if (node_size < 2 || scenario.jitter < 0 || scenario.jitter > 1
+      || (scenario.aggregate && (channel || node_size < 3))) {
+    sim_usage(argv[0]);
+    return 1;
+  }
+  if (scenario.aggregate) {
+    scenario.jitter = 0;
+  }
+
+  ndn_security_init();
+  ndn_sim_t sim;
+  ndn_sim_init(&sim, seed);
+  for (uint32_t i = 0; i < node_size; i++) {
+    ndn_sim_node_t* node = ndn_sim_add_node(&sim, NULL);
+    if (node == NULL) {
+      fprintf(stderr, "out of memory at node %u\n", i);
+      return 1;
+    }
+    node->content_size = content_size;
+  }
+
+  ndn_name_t prefix;
+  ndn_name_from_string(&prefix, "/sim", strlen("/sim"));
+  int ret;
+  if (scenario.aggregate) {
+    ret = sim_build_aggregation(&sim, node_size, &params, &prefix);
+  }
+  else if (channel) {
+    ret = sim_build_channel(&sim, node_size, &params, &prefix);
+  }
+  else {
+    ret = sim_build_grid(&sim, node_size, &params, &prefix);
+  }
+  if (ret != 0) {
+    fprintf(stderr, "cannot build the topology: %d\n", ret);
+    return 1;
+  }
+  if (!scenario.aggregate) {
+    ndn_sim_producer_register(sim.nodes[0], &prefix);
+  }
+  for (uint32_t i = scenario.aggregate ? 2 : 1; i < node_size; i++) {
+    ndn_sim_post(&sim, sim_next_interval(&sim), sim.nodes[i], sim_on_consumer_timer, NULL);
+  }
+
+  uint64_t events = ndn_sim_run(&sim, duration * 1000);
+  ndn_sim_report(&sim, stdout);
+
+  uint64_t expressed = 0, satisfied = 0, latency_sum = 0;
+  for (uint32_t i = 0; i < node_size; i++) {
+    expressed += sim.nodes[i]->stats.n_expressed;
+    satisfied += sim.nodes[i]->stats.n_satisfied;
+    latency_sum += sim.nodes[i]->stats.latency_sum;
+  }
+  fprintf(stderr, "nodes=%u seed=%llu events=%llu expressed=%llu satisfied=%llu avg_latency_us=%llu\n",
+          node_size, (unsigned long long)seed, (unsigned long long)events,
+          (unsigned long long)expressed, (unsigned long long)satisfied,
+          (unsigned long long)(satisfied ? latency_sum / satisfied : 0));
+  ret = scenario.aggregate ? sim_check_aggregation(&sim) : 0;
+  ndn_sim_destroy(&sim);
+  return ret;
+}
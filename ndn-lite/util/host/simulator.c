@@ -0,0 +1,673 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include "simulator.h"
+#include "encode/interest.h"
+#include "encode/data.h"
+#include <stdlib.h>
+#include <string.h>
+
+// A packet on the air, shared by its receivers and the collision detection
+typedef struct ndn_sim_tx {
+  uint32_t refcnt;
+  bool collided;
+  uint64_t start;
+  uint64_t end;
+} ndn_sim_tx_t;
+
+// A packet on the way to one receiver, which owns a copy since the forwarder may modify it
+typedef struct sim_delivery {
+  ndn_sim_link_face_t* face;
+  ndn_sim_tx_t* tx;
+  uint32_t size;
+  uint8_t packet[];
+} sim_delivery_t;
+
+// A Data on the way from a producer to its forwarder
+typedef struct sim_reply {
+  uint32_t size;
+  uint8_t packet[];
+} sim_reply_t;
+
+// The direct face callbacks take no context, so they find their node here.
+// Only one node runs at a time, and it is set whenever the simulation enters a node.
+static ndn_sim_node_t* sim_current;
+
+/************************************************************/
+/*  Definition of event queue                               */
+/************************************************************/
+
+static bool
+sim_event_before(const ndn_sim_event_t* a, const ndn_sim_event_t* b)
+{
+  return a->time < b->time || (a->time == b->time && a->seq < b->seq);
+}
+
+static int
+sim_post_at(ndn_sim_t* self, uint64_t time, ndn_sim_node_t* node,
+            ndn_sim_callback_t func, void* arg)
+{
+  if (self->event_size == self->event_capacity) {
+    uint32_t capacity = self->event_capacity ? self->event_capacity * 2 : 1024;
+    ndn_sim_event_t* events = realloc(self->events, capacity * sizeof(ndn_sim_event_t));
+    if (events == NULL) {
+      return NDN_FWD_NO_MEM;
+    }
+    self->events = events;
+    self->event_capacity = capacity;
+  }
+  ndn_sim_event_t event = {time, self->event_seq++, func, node, arg};
+  uint32_t i = self->event_size++;
+  while (i > 0 && sim_event_before(&event, &self->events[(i - 1) / 2])) {
+    self->events[i] = self->events[(i - 1) / 2];
+    i = (i - 1) / 2;
+  }
+  self->events[i] = event;
+  return 0;
+}
+
+static ndn_sim_event_t
+sim_pop(ndn_sim_t* self)
+{
+  ndn_sim_event_t top = self->events[0];
+  ndn_sim_event_t last = self->events[--self->event_size];
+  uint32_t i = 0;
+  while (true) {
+    uint32_t child = 2 * i + 1;
+    if (child >= self->event_size) {
+      break;
+    }
+    if (child + 1 < self->event_size && sim_event_before(&self->events[child + 1], &self->events[child])) {
+      child++;
+    }
+    if (!sim_event_before(&self->events[child], &last)) {
+      break;
+    }
+    self->events[i] = self->events[child];
+    i = child;
+  }
+  if (self->event_size > 0) {
+    self->events[i] = last;
+  }
+  return top;
+}
+
+int
+ndn_sim_post(ndn_sim_t* self, uint64_t delay, ndn_sim_node_t* node,
+             ndn_sim_callback_t func, void* arg)
+{
+  return sim_post_at(self, self->now + delay, node, func, arg);
+}
+
+uint64_t
+ndn_sim_random(ndn_sim_t* self)
+{
+  // splitmix64
+  uint64_t z = (self->rng_state += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+// A random number in [0, 1)
+static double
+sim_random_unit(ndn_sim_t* self)
+{
+  return (double)(ndn_sim_random(self) >> 11) / (double)(1ull << 53);
+}
+
+/************************************************************/
+/*  Definition of nodes                                     */
+/************************************************************/
+
+// Scheduler wake-up of a node. The forwarder is processed when the node is entered.
+static void
+sim_on_wake(ndn_sim_node_t* node, void* arg)
+{
+  (void)arg;
+  if (node->wake_time == node->sim->now) {
+    node->wake_time = 0;
+  }
+}
+
+static void
+sim_node_enter(ndn_sim_node_t* node)
+{
+  sim_current = node;
+  forwarder_process(&node->forwarder, node->sim->now / 1000);
+}
+
+// Leave a node, and make sure it is woken up for its next scheduler event
+static void
+sim_node_leave(ndn_sim_node_t* node)
+{
+  sim_current = NULL;
+  timetick_t next_deadline;
+  if (!ndn_scheduler_next_deadline(&node->forwarder.scheduler, &next_deadline)) {
+    return;
+  }
+  uint64_t deadline = next_deadline * 1000;
+  if (node->wake_time != 0 && node->wake_time <= deadline) {
+    return;
+  }
+  if (sim_post_at(node->sim, deadline, node, sim_on_wake, NULL) == 0) {
+    node->wake_time = deadline;
+  }
+}
+
+void
+ndn_sim_init(ndn_sim_t* self, uint64_t seed)
+{
+  memset(self, 0, sizeof(*self));
+  self->rng_state = seed;
+}
+
+ndn_sim_node_t*
+ndn_sim_add_node(ndn_sim_t* self, const ndn_forwarder_config_t* config)
+{
+  ndn_sim_node_t** nodes = realloc(self->nodes, (self->node_size + 1) * sizeof(ndn_sim_node_t*));
+  if (nodes == NULL) {
+    return NULL;
+  }
+  self->nodes = nodes;
+  ndn_forwarder_config_t node_config;
+  ndn_forwarder_layout_t layout;
+  if (config != NULL) {
+    node_config = *config;
+  }
+  else {
+    forwarder_config_init(&node_config);
+  }
+  // the strategies of the nodes draw different random numbers, reproduced by the seed
+  node_config.random_seed = (uint32_t)ndn_sim_random(self);
+  if (forwarder_get_layout(&node_config, &layout) != 0) {
+    return NULL;
+  }
+  size_t pending_offset = (layout.total + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t);
+  size_t pool_offset = pending_offset + node_config.direct_face_cb_size * sizeof(ndn_sim_pending_t);
+  size_t pool_region_size = NDN_SIM_POOL_REGION_SIZE(node_config.cs_size);
+  ndn_sim_node_t* node = calloc(1, sizeof(ndn_sim_node_t) + pool_offset + pool_region_size);
+  if (node == NULL) {
+    return NULL;
+  }
+  if (forwarder_init(&node->forwarder, &node_config, node->forwarder_region, layout.total) != 0) {
+    free(node);
+    return NULL;
+  }
+  node->pending = (ndn_sim_pending_t*)(node->forwarder_region + pending_offset);
+  node->pending_size = node_config.direct_face_cb_size;
+  const ndn_memory_class_config_t pktbuf_class = {
+    NDN_POOL_PKTBUF_SIZE, (uint16_t)(node_config.cs_size + NDN_SIM_POOL_SPARE_CNT)
+  };
+  if (memory_pool_init(&node->pool, node->forwarder_region + pool_offset, pool_region_size,
+                       &pktbuf_class, 1) != 0) {
+    free(node);
+    return NULL;
+  }
+  node->forwarder.pool = &node->pool;
+  if (direct_face_init(&node->app_face, &node->forwarder) != 0) {
+    free(node);
+    return NULL;
+  }
+  node->id = self->node_size;
+  node->sim = self;
+  node->content_size = 64;
+  self->nodes[self->node_size++] = node;
+  return node;
+}
+
+/************************************************************/
+/*  Definition of links                                     */
+/************************************************************/
+
+static void
+sim_tx_release(ndn_sim_tx_t* tx)
+{
+  if (--tx->refcnt == 0) {
+    free(tx);
+  }
+}
+
+static void
+sim_on_delivery(ndn_sim_node_t* node, void* arg)
+{
+  sim_delivery_t* delivery = (sim_delivery_t*)arg;
+  if (delivery->tx->collided) {
+    node->stats.n_collision_drops++;
+  }
+  else if (delivery->face->intf.state != NDN_FACE_STATE_DESTROYED) {
+    ndn_face_receive(&delivery->face->intf, delivery->packet, delivery->size);
+  }
+  sim_tx_release(delivery->tx);
+  free(delivery);
+}
+
+// Detect the collisions of a new transmission, and keep it until its airtime is over
+static void
+sim_link_on_air(ndn_sim_link_t* link, ndn_sim_tx_t* tx, uint64_t now)
+{
+  uint32_t size = 0;
+  for (uint32_t i = 0; i < link->on_air_size; i++) {
+    ndn_sim_tx_t* other = link->on_air[i];
+    if (other->end <= now) {
+      sim_tx_release(other);
+      continue;
+    }
+    if (other->start < tx->end && tx->start < other->end) {
+      other->collided = true;
+      tx->collided = true;
+    }
+    link->on_air[size++] = other;
+  }
+  link->on_air_size = size;
+  if (link->on_air_size == link->on_air_capacity) {
+    uint32_t capacity = link->on_air_capacity ? link->on_air_capacity * 2 : 8;
+    ndn_sim_tx_t** on_air = realloc(link->on_air, capacity * sizeof(ndn_sim_tx_t*));
+    if (on_air == NULL) {
+      return;
+    }
+    link->on_air = on_air;
+    link->on_air_capacity = capacity;
+  }
+  tx->refcnt++;
+  link->on_air[link->on_air_size++] = tx;
+}
+
+static int
+sim_link_face_up(ndn_face_intf_t* self)
+{
+  self->state = NDN_FACE_STATE_UP;
+  return 0;
+}
+
+static int
+sim_link_face_down(ndn_face_intf_t* self)
+{
+  self->state = NDN_FACE_STATE_DOWN;
+  return 0;
+}
+
+static void
+sim_link_face_destroy(ndn_face_intf_t* self)
+{
+  self->state = NDN_FACE_STATE_DESTROYED;
+}
+
+static int
+sim_link_face_send(ndn_face_intf_t* intf, const ndn_name_t* name,
+                   const uint8_t* packet, uint32_t size)
+{
+  (void)name;
+  ndn_sim_link_face_t* self = (ndn_sim_link_face_t*)intf;
+  ndn_sim_link_t* link = self->link;
+  ndn_sim_t* sim = self->node->sim;
+  if (size > link->params.mtu) {
+    self->node->stats.n_mtu_drops++;
+    return NDN_OVERSIZE;
+  }
+  // Nacks are not sent on multi-access links, where every other node would Nack an
+  // Interest it cannot forward back to the link, as NFD does on multi-access faces
+  if (size > 0 && packet[0] == TLV_LpPacket && link->faces != NULL &&
+      link->faces->next != NULL && link->faces->next->next != NULL) {
+    return 0;
+  }
+
+  ndn_sim_tx_t* tx = calloc(1, sizeof(ndn_sim_tx_t));
+  if (tx == NULL) {
+    return NDN_FWD_NO_MEM;
+  }
+  uint64_t airtime = 0;
+  if (link->params.bitrate != 0) {
+    airtime = (uint64_t)size * 8 * 1000000 / link->params.bitrate;
+  }
+  tx->refcnt = 1;
+  tx->start = sim->now > self->busy_until ? sim->now : self->busy_until;
+  tx->end = tx->start + airtime;
+  self->busy_until = tx->end;
+  if (link->params.collisions) {
+    sim_link_on_air(link, tx, sim->now);
+  }
+
+  for (ndn_sim_link_face_t* face = link->faces; face != NULL; face = face->next) {
+    if (face == self || face->intf.state == NDN_FACE_STATE_DESTROYED) {
+      continue;
+    }
+    if (link->params.loss > 0 && sim_random_unit(sim) < link->params.loss) {
+      face->node->stats.n_loss_drops++;
+      continue;
+    }
+    sim_delivery_t* delivery = malloc(sizeof(sim_delivery_t) + size);
+    if (delivery == NULL) {
+      continue;
+    }
+    delivery->face = face;
+    delivery->tx = tx;
+    delivery->size = size;
+    memcpy(delivery->packet, packet, size);
+    if (sim_post_at(sim, tx->end + link->params.latency, face->node, sim_on_delivery, delivery) != 0) {
+      free(delivery);
+      continue;
+    }
+    tx->refcnt++;
+  }
+  sim_tx_release(tx);
+  return 0;
+}
+
+ndn_sim_link_t*
+ndn_sim_add_link(ndn_sim_t* self, const ndn_sim_link_params_t* params)
+{
+  ndn_sim_link_t* link = calloc(1, sizeof(ndn_sim_link_t));
+  if (link == NULL) {
+    return NULL;
+  }
+  link->params = *params;
+  link->next = self->links;
+  self->links = link;
+  return link;
+}
+
+ndn_sim_link_face_t*
+ndn_sim_attach(ndn_sim_link_t* link, ndn_sim_node_t* node)
+{
+  ndn_sim_link_face_t* face = calloc(1, sizeof(ndn_sim_link_face_t));
+  if (face == NULL) {
+    return NULL;
+  }
+  face->intf.up = sim_link_face_up;
+  face->intf.send = sim_link_face_send;
+  face->intf.send_pktbuf = NULL;
+  face->intf.down = sim_link_face_down;
+  face->intf.destroy = sim_link_face_destroy;
+  face->intf.forwarder = NULL;
+  face->intf.face_id = NDN_INVALID_FACE_ID;
+  face->intf.state = NDN_FACE_STATE_UP;
+  face->intf.type = NDN_FACE_TYPE_NET;
+  face->node = node;
+  face->link = link;
+  if (forwarder_add_face(&node->forwarder, &face->intf) != 0) {
+    free(face);
+    return NULL;
+  }
+  // appended, so that the receivers of a packet are visited in the order they attached
+  ndn_sim_link_face_t** tail = &link->faces;
+  while (*tail != NULL) {
+    tail = &(*tail)->next;
+  }
+  *tail = face;
+  return face;
+}
+
+/************************************************************/
+/*  Definition of applications                              */
+/************************************************************/
+
+// Hash the name of a wire format Interest or Data
+static int
+sim_packet_name_hash(const uint8_t* packet, uint32_t size, uint32_t* hash)
+{
+  ndn_decoder_t decoder;
+  ndn_name_view_t name;
+  uint32_t probe = 0;
+  decoder_init(&decoder, packet, size);
+  int ret = decoder_get_type(&decoder, &probe);
+  if (ret != 0) return ret;
+  ret = decoder_get_length(&decoder, &probe);
+  if (ret != 0) return ret;
+  ret = ndn_name_view_tlv_decode(&decoder, &name);
+  if (ret != 0) return ret;
+  *hash = ndn_name_view_hash(&name);
+  return 0;
+}
+
+// Release the pending Interest of a packet
+static ndn_sim_pending_t*
+sim_consumer_find(ndn_sim_node_t* node, const uint8_t* packet, uint32_t size)
+{
+  uint32_t hash = 0;
+  if (sim_packet_name_hash(packet, size, &hash) != 0) {
+    return NULL;
+  }
+  for (uint16_t i = 0; i < node->pending_size; i++) {
+    if (node->pending[i].in_use && node->pending[i].name_hash == hash) {
+      node->pending[i].in_use = false;
+      return &node->pending[i];
+    }
+  }
+  return NULL;
+}
+
+static int
+sim_consumer_on_data(const uint8_t* data, uint32_t data_size)
+{
+  ndn_sim_node_t* node = sim_current;
+  ndn_sim_pending_t* pending = sim_consumer_find(node, data, data_size);
+  if (pending == NULL) {
+    return 0;
+  }
+  uint64_t latency = node->sim->now - pending->sent_time;
+  ndn_sim_stats_t* stats = &node->stats;
+  if (stats->n_satisfied == 0 || latency < stats->latency_min) {
+    stats->latency_min = latency;
+  }
+  if (latency > stats->latency_max) {
+    stats->latency_max = latency;
+  }
+  stats->latency_sum += latency;
+  stats->n_satisfied++;
+  return 0;
+}
+
+static int
+sim_consumer_on_timeout(const uint8_t* interest, uint32_t interest_size)
+{
+  ndn_sim_node_t* node = sim_current;
+  if (sim_consumer_find(node, interest, interest_size) != NULL) {
+    node->stats.n_timeouts++;
+  }
+  return 0;
+}
+
+static int
+sim_consumer_on_nack(const uint8_t* interest, uint32_t interest_size, uint8_t reason)
+{
+  (void)reason;
+  ndn_sim_node_t* node = sim_current;
+  if (sim_consumer_find(node, interest, interest_size) != NULL) {
+    node->stats.n_nacks++;
+  }
+  return 0;
+}
+
+int
+ndn_sim_consumer_express(ndn_sim_node_t* node, const ndn_name_t* name, uint64_t lifetime)
+{
+  ndn_sim_pending_t* pending = NULL;
+  for (uint16_t i = 0; i < node->pending_size && pending == NULL; i++) {
+    if (!node->pending[i].in_use) {
+      pending = &node->pending[i];
+    }
+  }
+  if (pending == NULL) {
+    return NDN_FWD_APP_FACE_CB_TABLE_FULL;
+  }
+
+  ndn_interest_t interest;
+  ndn_interest_from_name(&interest, name);
+  interest.lifetime = lifetime;
+  // a nonce of 0 would be drawn from the platform RNG, which is not reproducible
+  interest.nonce = (uint32_t)ndn_sim_random(node->sim) | 1;
+  uint8_t buffer[NDN_FRAG_BUFFER_MAX];
+  ndn_encoder_t encoder;
+  encoder_init(&encoder, buffer, sizeof(buffer));
+  int ret = ndn_interest_tlv_encode(&encoder, &interest);
+  if (ret != 0) {
+    return ret;
+  }
+
+  pending->in_use = true;
+  pending->name_hash = ndn_name_hash(name);
+  pending->sent_time = node->sim->now;
+  ndn_sim_node_t* current = sim_current;
+  sim_current = node;
+  ret = direct_face_express_interest(&node->app_face, name, buffer, encoder.offset,
+                                     sim_consumer_on_data, sim_consumer_on_timeout,
+                                     sim_consumer_on_nack);
+  sim_current = current;
+  if (ret != 0) {
+    pending->in_use = false;
+    return ret;
+  }
+  node->stats.n_expressed++;
+  return 0;
+}
+
+static void
+sim_producer_on_reply(ndn_sim_node_t* node, void* arg)
+{
+  sim_reply_t* reply = (sim_reply_t*)arg;
+  node->stats.n_produced++;
+  ndn_face_receive(&node->app_face.intf, reply->packet, reply->size);
+  free(reply);
+}
+
+static int
+sim_producer_on_interest(const uint8_t* interest, uint32_t interest_size)
+{
+  ndn_sim_node_t* node = sim_current;
+  ndn_decoder_t decoder;
+  ndn_name_view_t view;
+  uint32_t probe = 0;
+  decoder_init(&decoder, interest, interest_size);
+  decoder_get_type(&decoder, &probe);
+  decoder_get_length(&decoder, &probe);
+  if (ndn_name_view_tlv_decode(&decoder, &view) != 0) {
+    return 0;
+  }
+
+  static ndn_data_t data;
+  uint8_t content[NDN_CONTENT_BUFFER_SIZE];
+  uint32_t content_size = node->content_size;
+  if (content_size > sizeof(content)) {
+    content_size = sizeof(content);
+  }
+  memset(content, (uint8_t)node->id, content_size);
+  memset(&data, 0, sizeof(data));
+  if (ndn_name_from_view(&data.name, &view) != 0) {
+    return 0;
+  }
+  ndn_metainfo_init(&data.metainfo);
+  ndn_data_set_content(&data, content, content_size);
+
+  uint8_t buffer[NDN_FRAG_BUFFER_MAX];
+  ndn_encoder_t encoder;
+  encoder_init(&encoder, buffer, sizeof(buffer));
+  if (ndn_data_tlv_encode_digest_sign(&encoder, &data) != 0) {
+    return 0;
+  }
+  sim_reply_t* reply = malloc(sizeof(sim_reply_t) + encoder.offset);
+  if (reply == NULL) {
+    return 0;
+  }
+  reply->size = encoder.offset;
+  memcpy(reply->packet, buffer, encoder.offset);
+  if (ndn_sim_post(node->sim, 0, node, sim_producer_on_reply, reply) != 0) {
+    free(reply);
+  }
+  return 0;
+}
+
+int
+ndn_sim_producer_register(ndn_sim_node_t* node, const ndn_name_t* prefix)
+{
+  return direct_face_register_prefix(&node->app_face, prefix, sim_producer_on_interest);
+}
+
+/************************************************************/
+/*  Definition of simulation run                            */
+/************************************************************/
+
+uint64_t
+ndn_sim_run(ndn_sim_t* self, uint64_t until)
+{
+  uint64_t count = 0;
+  while (self->event_size > 0 && self->events[0].time <= until) {
+    ndn_sim_event_t event = sim_pop(self);
+    self->now = event.time;
+    sim_node_enter(event.node);
+    event.func(event.node, event.arg);
+    sim_node_leave(event.node);
+    count++;
+  }
+  if (until != UINT64_MAX && until > self->now) {
+    self->now = until;
+  }
+  return count;
+}
+
+void
+ndn_sim_destroy(ndn_sim_t* self)
+{
+  for (uint32_t i = 0; i < self->event_size; i++) {
+    ndn_sim_event_t* event = &self->events[i];
+    if (event->func == sim_on_delivery) {
+      sim_delivery_t* delivery = (sim_delivery_t*)event->arg;
+      sim_tx_release(delivery->tx);
+      free(delivery);
+    }
+    else if (event->func == sim_producer_on_reply) {
+      free(event->arg);
+    }
+  }
+  free(self->events);
+  while (self->links != NULL) {
+    ndn_sim_link_t* link = self->links;
+    self->links = link->next;
+    for (uint32_t i = 0; i < link->on_air_size; i++) {
+      sim_tx_release(link->on_air[i]);
+    }
+    free(link->on_air);
+    while (link->faces != NULL) {
+      ndn_sim_link_face_t* face = link->faces;
+      link->faces = face->next;
+      free(face);
+    }
+    free(link);
+  }
+  for (uint32_t i = 0; i < self->node_size; i++) {
+    free(self->nodes[i]);
+  }
+  free(self->nodes);
+  memset(self, 0, sizeof(*self));
+}
+
+void
+ndn_sim_report(const ndn_sim_t* self, FILE* out)
+{
+  fprintf(out, "node,in_interests,in_data,in_nacks,out_interests,out_data,out_nacks,"
+               "pit_hits,pit_full_drops,pit_evictions,fib_misses,cs_hits,cs_misses,"
+               "expressed,satisfied,timeouts,nacks,produced,"
+               "latency_avg_us,latency_min_us,latency_max_us,"
+               "loss_drops,collision_drops,mtu_drops\n");
+  for (uint32_t i = 0; i < self->node_size; i++) {
+    const ndn_sim_node_t* node = self->nodes[i];
+    const ndn_forwarder_counters_t* counters = &node->forwarder.counters;
+    const ndn_face_counters_t* packets = &counters->packets;
+    const ndn_sim_stats_t* stats = &node->stats;
+    uint64_t latency_avg = stats->n_satisfied ? stats->latency_sum / stats->n_satisfied : 0;
+    fprintf(out, "%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%llu,%llu,%llu,%u,%u,%u\n",
+            node->id, packets->n_in_interests, packets->n_in_data, packets->n_in_nacks,
+            packets->n_out_interests, packets->n_out_data, packets->n_out_nacks,
+            counters->n_pit_hits, counters->n_pit_full_drops, counters->n_pit_evictions,
+            counters->n_fib_misses, node->forwarder.cs.hit_cnt, node->forwarder.cs.miss_cnt,
+            stats->n_expressed, stats->n_satisfied, stats->n_timeouts, stats->n_nacks,
+            stats->n_produced, (unsigned long long)latency_avg,
+            (unsigned long long)stats->latency_min, (unsigned long long)stats->latency_max,
+            stats->n_loss_drops, stats->n_collision_drops, stats->n_mtu_drops);
+  }
+}
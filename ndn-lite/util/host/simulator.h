@@ -0,0 +1,355 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef UTIL_HOST_SIMULATOR_H_
+#define UTIL_HOST_SIMULATOR_H_
+
+#include "forwarder/forwarder.h"
+#include "face/direct-face.h"
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The host-side network simulator of NDN-Lite.
+ * It runs many forwarders in one Linux process, each with a direct face for its
+ * applications, connected by virtual links. It is not a part of the firmware.
+ *
+ * The simulation is a discrete event one driven by a virtual clock in microseconds.
+ * Each forwarder sees the virtual time in milliseconds through forwarder_process(), which
+ * runs its scheduler, and is woken up at the deadline of its next scheduler event.
+ * Events at the same time run in the order they are posted, and all randomness comes
+ * from the seed, so a run is reproduced exactly by the same seed.
+ *
+ * A link is a channel shared by the faces attached to it. A packet sent through a face
+ * occupies the channel for its airtime, and reaches every other face of the channel after
+ * the latency, unless it is lost. With collisions enabled, two packets whose airtimes
+ * overlap are both lost, as on a radio without carrier sense. A packet larger than the
+ * MTU is dropped by the sender. A link of more than two faces is multi-access, and
+ * does not carry Nacks.
+ */
+
+/**
+ * The packet and latency statistics of a node, besides the counters of its forwarder.
+ */
+typedef struct ndn_sim_stats {
+  /**
+   * The Interests expressed by ndn_sim_consumer_express().
+   */
+  uint32_t n_expressed;
+  /**
+   * The expressed Interests answered by Data.
+   */
+  uint32_t n_satisfied;
+  /**
+   * The expressed Interests that timed out.
+   */
+  uint32_t n_timeouts;
+  /**
+   * The expressed Interests answered by a Nack.
+   */
+  uint32_t n_nacks;
+  /**
+   * The Interests answered by ndn_sim_producer_register().
+   */
+  uint32_t n_produced;
+  /**
+   * The sum, minimum and maximum of the latencies of the satisfied Interests, in microseconds.
+   */
+  uint64_t latency_sum;
+  uint64_t latency_min;
+  uint64_t latency_max;
+  /**
+   * The packets lost on the way to the node.
+   */
+  uint32_t n_loss_drops;
+  /**
+   * The packets lost to collisions on the way to the node.
+   */
+  uint32_t n_collision_drops;
+  /**
+   * The packets dropped by the node because they exceeded the MTU of a link.
+   */
+  uint32_t n_mtu_drops;
+} ndn_sim_stats_t;
+
+/**
+ * An Interest expressed by ndn_sim_consumer_express() and not answered yet.
+ */
+typedef struct ndn_sim_pending {
+  uint32_t name_hash;
+  uint64_t sent_time;
+  bool in_use;
+} ndn_sim_pending_t;
+
+struct ndn_sim;
+
+/**
+ * The packet buffers of a node besides one for each CS entry, for the packets being forwarded.
+ */
+#define NDN_SIM_POOL_SPARE_CNT (NDN_POOL_PKTBUF_CNT - NDN_CS_MAX_SIZE)
+
+/**
+ * The region of the memory pool of a node whose CS keeps @p cs_size Data packets, for the
+ * packet buffers of its forwarder.
+ */
+#define NDN_SIM_POOL_REGION_SIZE(cs_size) \
+  (NDN_POOL_ALIGN \
+   + NDN_POOL_CLASS_REGION_SIZE(NDN_POOL_PKTBUF_SIZE, (cs_size) + NDN_SIM_POOL_SPARE_CNT))
+
+/**
+ * A simulated node: a forwarder and the direct face of its applications.
+ */
+typedef struct ndn_sim_node {
+  ndn_forwarder_t forwarder;
+  ndn_direct_face_t app_face;
+  /**
+   * The packet buffers of the forwarder, which are not shared with the other nodes.
+   * The region of the pool is kept after the pending Interests.
+   */
+  ndn_memory_pool_t pool;
+  /**
+   * The index of the node in the simulation.
+   */
+  uint32_t id;
+  struct ndn_sim* sim;
+  ndn_sim_stats_t stats;
+  /**
+   * The Interests in flight, one for each callback entry of the direct face, kept after
+   * the region of the forwarder.
+   */
+  ndn_sim_pending_t* pending;
+  uint16_t pending_size;
+  /**
+   * The size of the Content of the Data produced by the node, up to NDN_CONTENT_BUFFER_SIZE.
+   */
+  uint32_t content_size;
+  /**
+   * The time of the pending wake-up event of the node. 0 if there is none.
+   */
+  uint64_t wake_time;
+  /**
+   * [optional] The state of the scenario.
+   */
+  void* user_data;
+  /**
+   * The memory region of the tables of the forwarder, with the sizes given to
+   * ndn_sim_add_node(), followed by @p pending and the region of @p pool.
+   */
+  uint8_t forwarder_region[];
+} ndn_sim_node_t;
+
+/**
+ * The parameters of a link.
+ */
+typedef struct ndn_sim_link_params {
+  /**
+   * The propagation and processing delay in microseconds.
+   */
+  uint64_t latency;
+  /**
+   * The probability that a receiver loses a packet, in [0, 1].
+   */
+  double loss;
+  /**
+   * The largest packet that can be sent, in bytes.
+   */
+  uint32_t mtu;
+  /**
+   * The bit rate in bits per second, which gives the airtime of a packet. 0 for no airtime.
+   */
+  uint32_t bitrate;
+  /**
+   * Whether packets with overlapping airtimes are lost.
+   */
+  bool collisions;
+} ndn_sim_link_params_t;
+
+struct ndn_sim_link;
+struct ndn_sim_tx;
+
+/**
+ * The face of a node on a link.
+ */
+typedef struct ndn_sim_link_face {
+  /**
+   * The inherited interface abstraction.
+   */
+  ndn_face_intf_t intf;
+  ndn_sim_node_t* node;
+  struct ndn_sim_link* link;
+  struct ndn_sim_link_face* next;
+  /**
+   * The end of the airtime of the last packet sent, since a face sends one packet at a time.
+   */
+  uint64_t busy_until;
+} ndn_sim_link_face_t;
+
+/**
+ * A link, shared by the faces attached to it.
+ */
+typedef struct ndn_sim_link {
+  ndn_sim_link_params_t params;
+  ndn_sim_link_face_t* faces;
+  /**
+   * The transmissions whose airtime may not be over, for collision detection.
+   */
+  struct ndn_sim_tx** on_air;
+  uint32_t on_air_size;
+  uint32_t on_air_capacity;
+  struct ndn_sim_link* next;
+} ndn_sim_link_t;
+
+/**
+ * An event callback.
+ * @param node. Input/Output. The node the event is posted to.
+ * @param arg. Input. The argument given when the event is posted.
+ */
+typedef void (*ndn_sim_callback_t)(ndn_sim_node_t* node, void* arg);
+
+typedef struct ndn_sim_event {
+  uint64_t time;
+  uint64_t seq;
+  ndn_sim_callback_t func;
+  ndn_sim_node_t* node;
+  void* arg;
+} ndn_sim_event_t;
+
+/**
+ * The class of simulation.
+ */
+typedef struct ndn_sim {
+  ndn_sim_node_t** nodes;
+  uint32_t node_size;
+  ndn_sim_link_t* links;
+  /**
+   * The events, kept as a binary heap on (time, seq).
+   */
+  ndn_sim_event_t* events;
+  uint32_t event_size;
+  uint32_t event_capacity;
+  uint64_t event_seq;
+  /**
+   * The virtual time in microseconds.
+   */
+  uint64_t now;
+  uint64_t rng_state;
+} ndn_sim_t;
+
+/**
+ * Init an empty simulation.
+ * @param self. Output. The simulation to be inited.
+ * @param seed. Input. The seed of all the randomness in the simulation.
+ */
+void
+ndn_sim_init(ndn_sim_t* self, uint64_t seed);
+
+/**
+ * Free the nodes, links and events of a simulation.
+ * @param self. Input/Output. The simulation.
+ */
+void
+ndn_sim_destroy(ndn_sim_t* self);
+
+/**
+ * Add a node, with an inited forwarder and a direct face.
+ * @param self. Input/Output. The simulation.
+ * @param config. Input. The sizes of the tables of the forwarder. NULL for the defaults
+ *                of forwarder_config_init(). Its random_seed is replaced by one drawn from
+ *                the simulation.
+ * @return the node. NULL if there is no memory or @p config is invalid.
+ */
+ndn_sim_node_t*
+ndn_sim_add_node(ndn_sim_t* self, const ndn_forwarder_config_t* config);
+
+/**
+ * Add a link without faces.
+ * @param self. Input/Output. The simulation.
+ * @param params. Input. The parameters of the link.
+ * @return the link. NULL if there is no memory.
+ */
+ndn_sim_link_t*
+ndn_sim_add_link(ndn_sim_t* self, const ndn_sim_link_params_t* params);
+
+/**
+ * Attach a node to a link, by a new face added to the forwarder of the node.
+ * @param link. Input/Output. The link.
+ * @param node. Input/Output. The node.
+ * @return the face. NULL if there is no memory or the face table of the node is full.
+ */
+ndn_sim_link_face_t*
+ndn_sim_attach(ndn_sim_link_t* link, ndn_sim_node_t* node);
+
+/**
+ * Post an event.
+ * @param self. Input/Output. The simulation.
+ * @param delay. Input. The delay from now, in microseconds.
+ * @param node. Input/Output. The node the event runs on.
+ * @param func. Input. The callback.
+ * @param arg. Input. The argument of the callback.
+ * @return 0 if there is no error. NDN_FWD_NO_MEM if there is no memory.
+ */
+int
+ndn_sim_post(ndn_sim_t* self, uint64_t delay, ndn_sim_node_t* node,
+             ndn_sim_callback_t func, void* arg);
+
+/**
+ * Run the events up to a time.
+ * The clock is left at @p until, unless it is UINT64_MAX, which runs all the events.
+ * @param self. Input/Output. The simulation.
+ * @param until. Input. The virtual time to stop at, in microseconds.
+ * @return the number of events run.
+ */
+uint64_t
+ndn_sim_run(ndn_sim_t* self, uint64_t until);
+
+/**
+ * Get a random number from the generator of the simulation.
+ * @param self. Input/Output. The simulation.
+ * @return a random number.
+ */
+uint64_t
+ndn_sim_random(ndn_sim_t* self);
+
+/**
+ * Express an Interest from the applications of a node, and measure its latency.
+ * A node has up to direct_face_cb_size Interests in flight, as configured by ndn_sim_add_node().
+ * @param node. Input/Output. The node.
+ * @param name. Input. The name of the Interest.
+ * @param lifetime. Input. The InterestLifetime in milliseconds.
+ * @return 0 if there is no error. NDN_FWD_APP_FACE_CB_TABLE_FULL if too many Interests are in flight.
+ */
+int
+ndn_sim_consumer_express(ndn_sim_node_t* node, const ndn_name_t* name, uint64_t lifetime);
+
+/**
+ * Let the applications of a node answer the Interests under a prefix with Data of
+ * node->content_size bytes. The Data is sent in an event of its own, not from inside
+ * the forwarding of the Interest.
+ * @param node. Input/Output. The node.
+ * @param prefix. Input. The prefix.
+ * @return 0 if there is no error.
+ */
+int
+ndn_sim_producer_register(ndn_sim_node_t* node, const ndn_name_t* prefix);
+
+/**
+ * Print the statistics of each node as CSV, with a header line.
+ * @param self. Input. The simulation.
+ * @param out. Input. The output stream.
+ */
+void
+ndn_sim_report(const ndn_sim_t* self, FILE* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UTIL_HOST_SIMULATOR_H_
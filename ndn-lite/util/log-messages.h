@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * The table of log messages, shared by the logger and the host-side decoder.
+ * Each message is NDN_LOG_MESSAGE(name, number of arguments, format), and is logged
+ * by NDN_LOG_<LEVEL>(name, arguments...). Only the message ID and the arguments,
+ * as 32-bit integers, are recorded on the device; the format is applied by the decoder.
+ * The IDs follow the order of the table, so the decoder must be built from the same
+ * table as the firmware.
+ * This file is included without a guard on purpose.
+ */
+
+// logger
+NDN_LOG_MESSAGE(LOG_DROPPED, 1, "%u log records dropped")
+
+// forwarder
+NDN_LOG_MESSAGE(FACE_RECEIVE, 3, "face %u receive packet type %u size %u")
+NDN_LOG_MESSAGE(FORWARDER_ON_INTEREST, 2, "Forwarder: on Interest from face %u size %u")
+NDN_LOG_MESSAGE(FORWARDER_FIB_INSERT, 2, "Forwarder: successfully insert FIB, face %u cost %u")
+
+// nRF BLE face
+NDN_LOG_MESSAGE(BLE_SEND, 1, "ndn_nrf_ble_face_send got called, size %u")
+NDN_LOG_MESSAGE(BLE_SEND_BUSY, 0, "in ndn_nrf_ble_face_send, currently sending something else")
+NDN_LOG_MESSAGE(BLE_SEND_OVERSIZE, 1, "ndn_nrf_ble_face_send failed; packet size %u larger than max payload size")
+NDN_LOG_MESSAGE(BLE_SEND_CONNECTED, 0, "in ndn_nrf_ble_face_send, we were connected")
+NDN_LOG_MESSAGE(BLE_SEND_NOT_CONNECTED, 0, "in ndn_nrf_ble_face_send, we were not connected")
+NDN_LOG_MESSAGE(BLE_UNICAST_FAILED, 0, "ndn_lite_ble_unicast_transport_send failed")
+NDN_LOG_MESSAGE(BLE_EXT_ADV_FAILED, 0, "nrf_sdk_ble_adv_start failed")
+NDN_LOG_MESSAGE(BLE_SEND_FAILED, 0, "in ndn_nrf_ble_face_send, both unicast and extended advertising failed")
+NDN_LOG_MESSAGE(BLE_LEGACY_ADV_STOPPED, 0, "ndn_nrf_ble_legacy_adv_stopped got called")
+NDN_LOG_MESSAGE(BLE_MTU_REQUEST, 1, "ndn_nrf_ble_unicast_on_mtu_rqst got called, conn %u")
+NDN_LOG_MESSAGE(BLE_CONNECTED, 1, "ndn_nrf_ble_unicast_connected got called, conn %u")
+NDN_LOG_MESSAGE(BLE_HVN_TX_COMPLETE, 1, "ndn_nrf_ble_unicast_hvn_tx_complete got called, sending %u")
+NDN_LOG_MESSAGE(BLE_DISCONNECT_PENDING, 0, "in ndn_nrf_ble_unicast_hvn_tx_complete, waiting for the disconnection")
+NDN_LOG_MESSAGE(BLE_DISCONNECTED, 1, "ndn_nrf_ble_unicast_disconnected got called, sending %u")
+NDN_LOG_MESSAGE(BLE_ADV_STOPPED, 0, "ndn_nrf_ble_adv_stopped got called")
+NDN_LOG_MESSAGE(BLE_RX_EXT_ADV, 1, "RX frame (ext adv), payload len %u")
+NDN_LOG_MESSAGE(BLE_RX_UNICAST, 1, "RX frame (unicast), payload len %u")
+
+// nRF 802.15.4 face
+NDN_LOG_MESSAGE(IEEE802154_INIT, 1, "init 802.15.4 driver, TX power %ddBm")
+NDN_LOG_MESSAGE(IEEE802154_TX_FINISHED, 0, "TX finished")
+NDN_LOG_MESSAGE(IEEE802154_TX_FAILED, 1, "TX failed due to busy: %u")
+NDN_LOG_MESSAGE(IEEE802154_TX_TIMEOUT, 0, "TX TIMEOUT!")
+NDN_LOG_MESSAGE(IEEE802154_FRAGMENTS, 1, "%u pieces needed")
+NDN_LOG_MESSAGE(IEEE802154_FRAGMENT, 1, "fragmentation output ONE piece, No. %u")
+NDN_LOG_MESSAGE(IEEE802154_RX, 3, "RX frame, power %d, lqi %u, payload len %u")
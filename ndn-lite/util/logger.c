@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include "logger.h"
+
+#if NDN_LOG_LEVEL > NDN_LOG_LEVEL_NONE
+
+#include <stdatomic.h>
+#include <stdbool.h>
+
+#define LOG_RING_MASK (NDN_LOG_RING_SIZE - 1)
+
+/**
+ * The ring buffer of log records.
+ * Writers reserve space by moving @p head with a compare-and-swap, fill in the arguments,
+ * and store the header last. The reader takes a record once its header is non-zero,
+ * and zeroes the words before moving @p tail past them. So several writers, e.g., the
+ * main loop and interrupt handlers, can log at the same time without a lock.
+ */
+static struct {
+  _Atomic uint32_t words[NDN_LOG_RING_SIZE];
+  _Atomic uint32_t head;
+  _Atomic uint32_t tail;
+  _Atomic uint32_t dropped;
+} log_ring;
+
+void
+ndn_log_write(uint8_t level, uint16_t id, uint8_t nargs,
+              uint32_t arg0, uint32_t arg1, uint32_t arg2, uint32_t arg3)
+{
+  uint32_t args[NDN_LOG_MAX_ARGS] = {arg0, arg1, arg2, arg3};
+  uint32_t size = 1 + nargs;
+  uint32_t head = atomic_load_explicit(&log_ring.head, memory_order_relaxed);
+  do {
+    uint32_t tail = atomic_load_explicit(&log_ring.tail, memory_order_acquire);
+    if (head + size - tail > NDN_LOG_RING_SIZE) {
+      atomic_fetch_add_explicit(&log_ring.dropped, 1, memory_order_relaxed);
+      return;
+    }
+  } while (!atomic_compare_exchange_weak_explicit(&log_ring.head, &head, head + size,
+                                                  memory_order_relaxed, memory_order_relaxed));
+
+  for (uint32_t i = 0; i < nargs; i++) {
+    atomic_store_explicit(&log_ring.words[(head + 1 + i) & LOG_RING_MASK], args[i],
+                          memory_order_relaxed);
+  }
+  uint32_t header = NDN_LOG_RECORD_VALID | (uint32_t)level << 24 | (uint32_t)nargs << 16 | id;
+  atomic_store_explicit(&log_ring.words[head & LOG_RING_MASK], header, memory_order_release);
+}
+
+static void
+log_put_word(uint8_t* buffer, uint32_t word)
+{
+  buffer[0] = word & 0xFF;
+  buffer[1] = (word >> 8) & 0xFF;
+  buffer[2] = (word >> 16) & 0xFF;
+  buffer[3] = (word >> 24) & 0xFF;
+}
+
+uint32_t
+ndn_log_drain(ndn_log_sink_t sink)
+{
+  uint8_t record[4 * (1 + NDN_LOG_MAX_ARGS)];
+  uint32_t count = 0;
+  uint32_t tail = atomic_load_explicit(&log_ring.tail, memory_order_relaxed);
+  while (true) {
+    uint32_t header = atomic_load_explicit(&log_ring.words[tail & LOG_RING_MASK],
+                                           memory_order_acquire);
+    // An empty ring, or a record whose writer has not finished yet
+    if (header == 0) {
+      break;
+    }
+    uint32_t size = 1 + NDN_LOG_RECORD_NARGS(header);
+    log_put_word(record, header);
+    atomic_store_explicit(&log_ring.words[tail & LOG_RING_MASK], 0, memory_order_relaxed);
+    for (uint32_t i = 1; i < size; i++) {
+      uint32_t arg = atomic_load_explicit(&log_ring.words[(tail + i) & LOG_RING_MASK],
+                                          memory_order_relaxed);
+      log_put_word(record + 4 * i, arg);
+      atomic_store_explicit(&log_ring.words[(tail + i) & LOG_RING_MASK], 0, memory_order_relaxed);
+    }
+    tail += size;
+    atomic_store_explicit(&log_ring.tail, tail, memory_order_release);
+    sink(record, 4 * size);
+    count++;
+  }
+
+  uint32_t dropped = atomic_exchange_explicit(&log_ring.dropped, 0, memory_order_relaxed);
+  if (dropped > 0) {
+    log_put_word(record, NDN_LOG_RECORD_VALID | (uint32_t)NDN_LOG_LEVEL_WARN << 24
+                         | (uint32_t)NDN_LOG_NARGS_LOG_DROPPED << 16 | NDN_LOG_ID_LOG_DROPPED);
+    log_put_word(record + 4, dropped);
+    sink(record, 8);
+    count++;
+  }
+  return count;
+}
+
+#else
+
+void
+ndn_log_write(uint8_t level, uint16_t id, uint8_t nargs,
+              uint32_t arg0, uint32_t arg1, uint32_t arg2, uint32_t arg3)
+{
+  (void)level;
+  (void)id;
+  (void)nargs;
+  (void)arg0;
+  (void)arg1;
+  (void)arg2;
+  (void)arg3;
+}
+
+uint32_t
+ndn_log_drain(ndn_log_sink_t sink)
+{
+  (void)sink;
+  return 0;
+}
+
+#endif // NDN_LOG_LEVEL > NDN_LOG_LEVEL_NONE
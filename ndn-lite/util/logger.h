@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2018-2019 Zhiyi Zhang, Xinyu Ma
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#ifndef UTIL_LOGGER_H_
+#define UTIL_LOGGER_H_
+
+#include "../ndn-constants.h"
+#include <inttypes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The logger of NDN-Lite.
+ * Logging on the packet path must not block, so a log call only appends a binary record,
+ * the message ID and its arguments, to a lock-free ring buffer. The application drains
+ * the ring by ndn_log_drain() in its idle time, e.g., to the UART or RTT, and the records
+ * are turned into text on the host by util/host/log-decoder.c.
+ * The messages are listed in log-messages.h.
+ *
+ * The levels above NDN_LOG_LEVEL are removed at compile time, with their arguments.
+ * NDN_LOG_LEVEL defaults to NDN_LOG_LEVEL_NONE, which also removes the ring buffer.
+ */
+
+#define NDN_LOG_LEVEL_NONE 0
+#define NDN_LOG_LEVEL_ERROR 1
+#define NDN_LOG_LEVEL_WARN 2
+#define NDN_LOG_LEVEL_INFO 3
+#define NDN_LOG_LEVEL_DEBUG 4
+
+#ifndef NDN_LOG_LEVEL
+#define NDN_LOG_LEVEL NDN_LOG_LEVEL_NONE
+#endif
+
+/**
+ * The IDs and argument counts of the log messages.
+ */
+#define NDN_LOG_MESSAGE(name, nargs, format) NDN_LOG_ID_##name,
+enum {
+#include "log-messages.h"
+  NDN_LOG_MESSAGE_COUNT
+};
+#undef NDN_LOG_MESSAGE
+
+#define NDN_LOG_MESSAGE(name, nargs, format) NDN_LOG_NARGS_##name = nargs,
+enum {
+#include "log-messages.h"
+};
+#undef NDN_LOG_MESSAGE
+
+/**
+ * A log record starts with a header word, followed by one word for each argument.
+ * The header is NDN_LOG_RECORD_VALID | level << 24 | nargs << 16 | message ID.
+ * A drained record is written out in little-endian.
+ */
+#define NDN_LOG_RECORD_VALID 0x80000000u
+#define NDN_LOG_RECORD_LEVEL(header) (((header) >> 24) & 0x7F)
+#define NDN_LOG_RECORD_NARGS(header) (((header) >> 16) & 0xFF)
+#define NDN_LOG_RECORD_ID(header) ((header) & 0xFFFF)
+
+/**
+ * The callback receiving the drained log records.
+ * @param record. Input. The wire format record.
+ * @param size. Input. The size of the record in bytes.
+ */
+typedef void (*ndn_log_sink_t)(const uint8_t* record, uint32_t size);
+
+/**
+ * Append a log record to the ring buffer.
+ * This function can be invoked from interrupt handlers. If the ring is full, the record
+ * is dropped and counted, and a LOG_DROPPED record is emitted by the next drain.
+ * Use the NDN_LOG_<LEVEL> macros instead of invoking this function directly.
+ * @param level. Input. The level of the record.
+ * @param id. Input. The message ID.
+ * @param nargs. Input. The number of arguments, up to NDN_LOG_MAX_ARGS.
+ * @param args. Input. The arguments, of which the first @p nargs are recorded.
+ */
+void
+ndn_log_write(uint8_t level, uint16_t id, uint8_t nargs,
+              uint32_t arg0, uint32_t arg1, uint32_t arg2, uint32_t arg3);
+
+/**
+ * Pass the records in the ring buffer to a sink, and remove them.
+ * This function should be invoked by the application in its idle time only, since
+ * the sink may block. It must not be invoked from several contexts at the same time.
+ * @param sink. Input. The callback receiving the records.
+ * @return the number of records drained.
+ */
+uint32_t
+ndn_log_drain(ndn_log_sink_t sink);
+
+// The arguments are padded with zeros, so that a message can have fewer than NDN_LOG_MAX_ARGS
+#define NDN_LOG_WRITE(level, name, a0, a1, a2, a3, ...) \
+  ndn_log_write(level, NDN_LOG_ID_##name, NDN_LOG_NARGS_##name, \
+                (uint32_t)(a0), (uint32_t)(a1), (uint32_t)(a2), (uint32_t)(a3))
+
+#if NDN_LOG_LEVEL >= NDN_LOG_LEVEL_ERROR
+#define NDN_LOG_ERROR(...) NDN_LOG_WRITE(NDN_LOG_LEVEL_ERROR, __VA_ARGS__, 0, 0, 0, 0, 0)
+#else
+#define NDN_LOG_ERROR(...) ((void)0)
+#endif
+
+#if NDN_LOG_LEVEL >= NDN_LOG_LEVEL_WARN
+#define NDN_LOG_WARN(...) NDN_LOG_WRITE(NDN_LOG_LEVEL_WARN, __VA_ARGS__, 0, 0, 0, 0, 0)
+#else
+#define NDN_LOG_WARN(...) ((void)0)
+#endif
+
+#if NDN_LOG_LEVEL >= NDN_LOG_LEVEL_INFO
+#define NDN_LOG_INFO(...) NDN_LOG_WRITE(NDN_LOG_LEVEL_INFO, __VA_ARGS__, 0, 0, 0, 0, 0)
+#else
+#define NDN_LOG_INFO(...) ((void)0)
+#endif
+
+#if NDN_LOG_LEVEL >= NDN_LOG_LEVEL_DEBUG
+#define NDN_LOG_DEBUG(...) NDN_LOG_WRITE(NDN_LOG_LEVEL_DEBUG, __VA_ARGS__, 0, 0, 0, 0, 0)
+#else
+#define NDN_LOG_DEBUG(...) ((void)0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UTIL_LOGGER_H_